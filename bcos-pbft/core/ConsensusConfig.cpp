@@ -24,27 +24,18 @@ using namespace bcos;
 using namespace bcos::crypto;
 using namespace bcos::consensus;
 // the consensus node list
-// Note: copy here to ensure thread safety
-// And the cost of copying the pointer is more efficient
-ConsensusNodeList ConsensusConfig::consensusNodeList() const
+// Note: the returned pointer shares the ownership of the immutable snapshot, so the list stays
+// valid even if the snapshot is replaced, and is never copied
+ConsensusNodeListConstPtr ConsensusConfig::consensusNodeList() const
 {
-    ReadGuard l(x_consensusNodeList);
-    return *m_consensusNodeList;
+    auto snapshot = nodeSnapshot();
+    return ConsensusNodeListConstPtr(snapshot, &snapshot->consensusNodeList());
 }
 
-NodeIDs ConsensusConfig::consensusNodeIDList(bool _excludeSelf) const
+NodeIDListConstPtr ConsensusConfig::consensusNodeIDList(bool _excludeSelf) const
 {
-    ReadGuard l(x_consensusNodeList);
-    std::vector<PublicPtr> nodeIDList;
-    for (auto node : *m_consensusNodeList)
-    {
-        if (_excludeSelf && node->nodeID()->data() == nodeID()->data())
-        {
-            continue;
-        }
-        nodeIDList.push_back(node->nodeID());
-    }
-    return nodeIDList;
+    auto snapshot = nodeSnapshot();
+    return NodeIDListConstPtr(snapshot, &snapshot->nodeIDList(_excludeSelf));
 }
 
 bool ConsensusConfig::compareConsensusNode(
@@ -77,26 +68,26 @@ void ConsensusConfig::setConsensusNodeList(ConsensusNodeList& _consensusNodeList
 
     std::sort(_consensusNodeList.begin(), _consensusNodeList.end(), ConsensusNodeComparator());
     // update the consensus list
+    ConsensusNodeSnapshot::Ptr snapshot;
     {
-        UpgradableGuard l(x_consensusNodeList);
+        std::lock_guard<std::mutex> l(x_nodeSnapshot);
+        auto currentSnapshot = nodeSnapshot();
         // consensus node list have not been changed
-        if (compareConsensusNode(_consensusNodeList, *m_consensusNodeList))
+        if (compareConsensusNode(_consensusNodeList, currentSnapshot->consensusNodeList()))
         {
             m_nodeUpdated = false;
             return;
         }
-        UpgradeGuard ul(l);
         // consensus node list have been changed
-        *m_consensusNodeList = _consensusNodeList;
+        snapshot = std::make_shared<ConsensusNodeSnapshot>(
+            currentSnapshot->epoch() + 1, _consensusNodeList, m_keyPair->publicKey()->data());
+        std::atomic_store(&m_nodeSnapshot, snapshot);
         m_nodeUpdated = true;
     }
-    {
-        // update the consensusNodeNum
-        ReadGuard l(x_consensusNodeList);
-        m_consensusNodeNum.store(m_consensusNodeList->size());
-    }
+    // update the consensusNodeNum
+    m_consensusNodeNum.store(snapshot->size());
     // update the nodeIndex
-    auto nodeIndex = getNodeIndexByNodeID(m_keyPair->publicKey());
+    auto nodeIndex = snapshot->nodeIndex();
     if (nodeIndex != m_nodeIndex)
     {
         m_nodeIndex.store(nodeIndex);
@@ -105,6 +96,7 @@ void ConsensusConfig::setConsensusNodeList(ConsensusNodeList& _consensusNodeList
     updateQuorum();
     CONSENSUS_LOG(INFO) << LOG_DESC("updateConsensusNodeList")
                         << LOG_KV("nodeNum", m_consensusNodeNum) << LOG_KV("nodeIndex", nodeIndex)
+                        << LOG_KV("epoch", snapshot->epoch())
                         << LOG_KV("committedIndex",
                                (committedProposal() ? committedProposal()->index() : 0))
                         << decsConsensusNodeList(_consensusNodeList);
@@ -112,27 +104,10 @@ void ConsensusConfig::setConsensusNodeList(ConsensusNodeList& _consensusNodeList
 
 IndexType ConsensusConfig::getNodeIndexByNodeID(bcos::crypto::PublicPtr _nodeID)
 {
-    ReadGuard l(x_consensusNodeList);
-    IndexType nodeIndex = NON_CONSENSUS_NODE;
-    IndexType i = 0;
-    for (auto _consensusNode : *m_consensusNodeList)
-    {
-        if (_consensusNode->nodeID()->data() == _nodeID->data())
-        {
-            nodeIndex = i;
-            break;
-        }
-        i++;
-    }
-    return nodeIndex;
+    return nodeSnapshot()->nodeIndex(_nodeID->data());
 }
 
 ConsensusNodeInterface::Ptr ConsensusConfig::getConsensusNodeByIndex(IndexType _nodeIndex)
 {
-    ReadGuard l(x_consensusNodeList);
-    if (_nodeIndex < m_consensusNodeList->size())
-    {
-        return (*m_consensusNodeList)[_nodeIndex];
-    }
-    return nullptr;
-}
\ No newline at end of file
+    return nodeSnapshot()->consensusNode(_nodeIndex);
+}
@@ -21,8 +21,10 @@
 #pragma once
 #include "../framework/ConsensusConfigInterface.h"
 #include "Common.h"
+#include "ConsensusNodeSnapshot.h"
 #include <bcos-framework/interfaces/crypto/KeyPairInterface.h>
 #include <bcos-framework/libutilities/Common.h>
+#include <mutex>
 
 namespace bcos
 {
@@ -33,7 +35,7 @@ class ConsensusConfig : public ConsensusConfigInterface
 public:
     using Ptr = std::shared_ptr<ConsensusConfig>;
     explicit ConsensusConfig(bcos::crypto::KeyPairInterface::Ptr _keyPair)
-      : m_keyPair(_keyPair), m_consensusNodeList(std::make_shared<ConsensusNodeList>())
+      : m_keyPair(_keyPair), m_nodeSnapshot(std::make_shared<ConsensusNodeSnapshot>())
     {}
     virtual ~ConsensusConfig() {}
 
@@ -45,8 +47,8 @@ public:
 
     bool isConsensusNode() const override { return (m_nodeIndex != NON_CONSENSUS_NODE); }
     // the consensus node list
-    ConsensusNodeList consensusNodeList() const override;
-    bcos::crypto::NodeIDs consensusNodeIDList(bool _excludeSelf = true) const override;
+    ConsensusNodeListConstPtr consensusNodeList() const override;
+    NodeIDListConstPtr consensusNodeIDList(bool _excludeSelf = true) const override;
 
     uint64_t consensusTimeout() const override { return m_consensusTimeout; }
 
@@ -88,6 +90,10 @@ public:
                              << LOG_KV("progressedIndex", m_progressedIndex);
     }
 
+    // the current snapshot of the consensus node list, can be held without lock
+    ConsensusNodeSnapshot::Ptr nodeSnapshot() const { return std::atomic_load(&m_nodeSnapshot); }
+    uint64_t nodeEpoch() const { return nodeSnapshot()->epoch(); }
+
     virtual void updateQuorum() = 0;
     IndexType getNodeIndexByNodeID(bcos::crypto::PublicPtr _nodeID);
     ConsensusNodeInterface::Ptr getConsensusNodeByIndex(IndexType _nodeIndex);
@@ -107,16 +113,17 @@ public:
     IndexType consensusNodesNum() const { return m_consensusNodeNum.load(); }
 
 
-private:
+protected:
     bool compareConsensusNode(ConsensusNodeList const& _left, ConsensusNodeList const& _right);
 
-protected:
     bcos::crypto::KeyPairInterface::Ptr m_keyPair;
     std::atomic<IndexType> m_nodeIndex = {0};
     std::atomic<IndexType> m_consensusNodeNum = {0};
 
-    ConsensusNodeListPtr m_consensusNodeList;
-    mutable bcos::SharedMutex x_consensusNodeList;
+    // replaced atomically when the consensus node list changed
+    ConsensusNodeSnapshot::Ptr m_nodeSnapshot;
+    // serialize the writers of the snapshot
+    mutable std::mutex x_nodeSnapshot;
 
     // default timeout is 3000ms
     std::atomic<uint64_t> m_consensusTimeout = {3000};
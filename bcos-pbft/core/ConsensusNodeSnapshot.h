@@ -0,0 +1,131 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief immutable snapshot of the consensus node list
+ * @file ConsensusNodeSnapshot.h
+ * @author: yujiechen
+ * @date 2021-06-15
+ */
+#pragma once
+#include "Common.h"
+#include <bcos-framework/interfaces/consensus/ConsensusNodeInterface.h>
+#include <boost/functional/hash.hpp>
+#include <unordered_map>
+
+namespace bcos
+{
+namespace consensus
+{
+struct NodeIDHasher
+{
+    size_t operator()(bytes const& _nodeID) const
+    {
+        return boost::hash_range(_nodeID.begin(), _nodeID.end());
+    }
+};
+
+// Note: the snapshot is never modified after created, the readers hold the snapshot without lock,
+// and the writer replaces the whole snapshot when the consensus node list changed
+class ConsensusNodeSnapshot
+{
+public:
+    using Ptr = std::shared_ptr<ConsensusNodeSnapshot const>;
+    ConsensusNodeSnapshot() = default;
+    ConsensusNodeSnapshot(
+        uint64_t _epoch, ConsensusNodeList const& _consensusNodeList, bytes const& _selfNodeID)
+      : m_epoch(_epoch), m_consensusNodeList(_consensusNodeList)
+    {
+        IndexType i = 0;
+        for (auto const& node : m_consensusNodeList)
+        {
+            auto const& nodeID = node->nodeID()->data();
+            m_nodeIndexes[nodeID] = i;
+            m_nodeIDList.push_back(node->nodeID());
+            if (nodeID == _selfNodeID)
+            {
+                m_nodeIndex = i;
+            }
+            else
+            {
+                m_nodeIDListExcludeSelf.push_back(node->nodeID());
+            }
+            m_weights.push_back(node->weight());
+            m_totalWeight += node->weight();
+            i++;
+        }
+        if (m_totalWeight > 0)
+        {
+            m_maxFaultyQuorum = (m_totalWeight - 1) / 3;
+            m_minRequiredQuorum = m_totalWeight - m_maxFaultyQuorum;
+        }
+    }
+
+    // increased every time the consensus node list changed
+    uint64_t epoch() const { return m_epoch; }
+    ConsensusNodeList const& consensusNodeList() const { return m_consensusNodeList; }
+    bcos::crypto::NodeIDs const& nodeIDList(bool _excludeSelf) const
+    {
+        return _excludeSelf ? m_nodeIDListExcludeSelf : m_nodeIDList;
+    }
+    size_t size() const { return m_consensusNodeList.size(); }
+    // the nodeIndex of this node
+    IndexType nodeIndex() const { return m_nodeIndex; }
+
+    ConsensusNodeInterface::Ptr consensusNode(IndexType _nodeIndex) const
+    {
+        if (_nodeIndex < m_consensusNodeList.size())
+        {
+            return m_consensusNodeList[_nodeIndex];
+        }
+        return nullptr;
+    }
+    IndexType nodeIndex(bytes const& _nodeID) const
+    {
+        auto it = m_nodeIndexes.find(_nodeID);
+        if (it == m_nodeIndexes.end())
+        {
+            return NON_CONSENSUS_NODE;
+        }
+        return it->second;
+    }
+    uint64_t weight(IndexType _nodeIndex) const
+    {
+        if (_nodeIndex < m_weights.size())
+        {
+            return m_weights[_nodeIndex];
+        }
+        return 0;
+    }
+
+    uint64_t totalWeight() const { return m_totalWeight; }
+    uint64_t maxFaultyQuorum() const { return m_maxFaultyQuorum; }
+    uint64_t minRequiredQuorum() const { return m_minRequiredQuorum; }
+
+private:
+    uint64_t m_epoch = 0;
+    ConsensusNodeList m_consensusNodeList;
+    // the decoded public keys of the consensus nodes
+    bcos::crypto::NodeIDs m_nodeIDList;
+    bcos::crypto::NodeIDs m_nodeIDListExcludeSelf;
+    std::unordered_map<bytes, IndexType, NodeIDHasher> m_nodeIndexes;
+    std::vector<uint64_t> m_weights;
+    IndexType m_nodeIndex = NON_CONSENSUS_NODE;
+
+    uint64_t m_totalWeight = 0;
+    uint64_t m_maxFaultyQuorum = 0;
+    uint64_t m_minRequiredQuorum = 0;
+};
+}  // namespace consensus
+}  // namespace bcos
@@ -0,0 +1,71 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief cache for the blocks decoded from the proposals
+ * @file DecodedBlockCache.cpp
+ * @author: yujiechen
+ * @date 2021-06-22
+ */
+#include "DecodedBlockCache.h"
+
+using namespace bcos;
+using namespace bcos::consensus;
+using namespace bcos::crypto;
+using namespace bcos::protocol;
+
+Block::Ptr DecodedBlockCache::block(HashType const& _hash) const
+{
+    ReadGuard l(x_blocks);
+    auto it = m_blocks.find(_hash);
+    if (it == m_blocks.end())
+    {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void DecodedBlockCache::insert(HashType const& _hash, BlockNumber _index, Block::Ptr _block)
+{
+    WriteGuard l(x_blocks);
+    if (!m_blocks.emplace(_hash, _block).second)
+    {
+        return;
+    }
+    m_blockHashes[_index].push_back(_hash);
+    // the evicted blocks are decoded from the proposals by the readers
+    while (m_blockHashes.size() > m_capacity)
+    {
+        auto it = m_blockHashes.begin();
+        for (auto const& hash : it->second)
+        {
+            m_blocks.erase(hash);
+        }
+        m_blockHashes.erase(it);
+    }
+}
+
+void DecodedBlockCache::evict(BlockNumber _stableIndex)
+{
+    WriteGuard l(x_blocks);
+    auto end = m_blockHashes.upper_bound(_stableIndex);
+    for (auto it = m_blockHashes.begin(); it != end; it++)
+    {
+        for (auto const& hash : it->second)
+        {
+            m_blocks.erase(hash);
+        }
+    }
+    m_blockHashes.erase(m_blockHashes.begin(), end);
+}
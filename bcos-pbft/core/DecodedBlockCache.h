@@ -0,0 +1,69 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief cache for the blocks decoded from the proposals
+ * @file DecodedBlockCache.h
+ * @author: yujiechen
+ * @date 2021-06-22
+ */
+#pragma once
+#include "Common.h"
+#include <bcos-framework/interfaces/protocol/Block.h>
+#include <bcos-framework/libutilities/Common.h>
+#include <bcos-framework/libutilities/FixedBytes.h>
+#include <map>
+
+namespace bcos
+{
+namespace consensus
+{
+// Note: the block executed by the StateMachine is cached under the executed header hash and shared
+// by the storage until the checkpoint of the proposal becomes stable. The executed block is never
+// modified, so the concurrent readers are safe; the block under execution must not be shared since
+// the scheduler modifies it
+class DecodedBlockCache
+{
+public:
+    using Ptr = std::shared_ptr<DecodedBlockCache>;
+    explicit DecodedBlockCache(size_t _capacity = c_defaultCapacity) : m_capacity(_capacity) {}
+    virtual ~DecodedBlockCache() {}
+
+    // nullptr when missed
+    virtual bcos::protocol::Block::Ptr block(bcos::crypto::HashType const& _hash) const;
+    // insert the executed block, the blocks of the smallest indexes are evicted when exceeding the
+    // capacity
+    virtual void insert(bcos::crypto::HashType const& _hash, bcos::protocol::BlockNumber _index,
+        bcos::protocol::Block::Ptr _block);
+    // evict the blocks no larger than the stable checkpoint
+    virtual void evict(bcos::protocol::BlockNumber _stableIndex);
+
+    size_t size() const
+    {
+        ReadGuard l(x_blocks);
+        return m_blocks.size();
+    }
+    size_t capacity() const { return m_capacity; }
+
+private:
+    // the max number of the cached indexes, no less than the executing proposals
+    static const size_t c_defaultCapacity = 64;
+    size_t m_capacity;
+    std::map<bcos::crypto::HashType, bcos::protocol::Block::Ptr> m_blocks;
+    // the hashes of the cached blocks with the same index(e.g. the proposals before view change)
+    std::map<bcos::protocol::BlockNumber, std::vector<bcos::crypto::HashType>> m_blockHashes;
+    mutable SharedMutex x_blocks;
+};
+}  // namespace consensus
+}  // namespace bcos
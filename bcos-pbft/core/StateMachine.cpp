@@ -53,6 +53,8 @@ void StateMachine::apply(ssize_t, ProposalInterface::ConstPtr _lastAppliedPropos
         }
         return;
     }
+    // Note: the block is decoded here rather than shared since the scheduler modifies it, and it is
+    // shared by the blockCache after executed
     auto block = m_blockFactory->createBlock(_proposal->data());
     // invalid block
     auto blockHeader = block->blockHeader();
@@ -84,8 +86,9 @@ void StateMachine::apply(ssize_t, ProposalInterface::ConstPtr _lastAppliedPropos
     }
     // calls dispatcher to execute the block
     auto startT = utcTime();
+    auto blockCache = m_blockCache;
     m_scheduler->executeBlock(block, false,
-        [startT, block, _onExecuteFinished, _proposal, _executedProposal](
+        [startT, block, blockCache, _onExecuteFinished, _proposal, _executedProposal](
             Error::Ptr&& _error, BlockHeader::Ptr&& _blockHeader) {
             if (!_onExecuteFinished)
             {
@@ -128,6 +131,8 @@ void StateMachine::apply(ssize_t, ProposalInterface::ConstPtr _lastAppliedPropos
             _executedProposal->setData(std::move(blockHeaderBuffer));
             // the transactions hash list
             _executedProposal->setExtraData(_proposal->data());
+            // the storage commits the executed proposal with the block decoded here
+            blockCache->insert(_blockHeader->hash(), _blockHeader->number(), block);
             _onExecuteFinished(true);
         });
     return;
@@ -20,6 +20,7 @@
  */
 #pragma once
 #include "../framework/StateMachineInterface.h"
+#include "DecodedBlockCache.h"
 #include <bcos-framework/interfaces/dispatcher/SchedulerInterface.h>
 #include <bcos-framework/interfaces/protocol/BlockFactory.h>
 #include <bcos-framework/libutilities/ThreadPool.h>
@@ -32,10 +33,15 @@ class StateMachine : public StateMachineInterface
 {
 public:
     StateMachine(bcos::scheduler::SchedulerInterface::Ptr _scheduler,
-        bcos::protocol::BlockFactory::Ptr _blockFactory)
-      : m_scheduler(_scheduler), m_blockFactory(_blockFactory)
+        bcos::protocol::BlockFactory::Ptr _blockFactory,
+        DecodedBlockCache::Ptr _blockCache = nullptr)
+      : m_scheduler(_scheduler), m_blockFactory(_blockFactory), m_blockCache(_blockCache)
     {
         m_worker = std::make_shared<ThreadPool>("stateMachine", 1);
+        if (!m_blockCache)
+        {
+            m_blockCache = std::make_shared<DecodedBlockCache>();
+        }
     }
     ~StateMachine() override {}
 
@@ -51,6 +57,7 @@ private:
 protected:
     bcos::scheduler::SchedulerInterface::Ptr m_scheduler;
     bcos::protocol::BlockFactory::Ptr m_blockFactory;
+    DecodedBlockCache::Ptr m_blockCache;
     bcos::ThreadPool::Ptr m_worker;
 };
 }  // namespace consensus
@@ -26,6 +26,10 @@ namespace bcos
 {
 namespace consensus
 {
+// Note: the lists are shared with the snapshot that holds them, instead of copied for every reader
+using ConsensusNodeListConstPtr = std::shared_ptr<ConsensusNodeList const>;
+using NodeIDListConstPtr = std::shared_ptr<bcos::crypto::NodeIDs const>;
+
 class ConsensusConfigInterface
 {
 public:
@@ -39,8 +43,8 @@ public:
     virtual IndexType nodeIndex() const = 0;
 
     // the sealer list
-    virtual ConsensusNodeList consensusNodeList() const = 0;
-    virtual bcos::crypto::NodeIDs consensusNodeIDList(bool _excludeSelf = true) const = 0;
+    virtual ConsensusNodeListConstPtr consensusNodeList() const = 0;
+    virtual NodeIDListConstPtr consensusNodeIDList(bool _excludeSelf = true) const = 0;
     virtual bool isConsensusNode() const = 0;
 
     // the consensus timeout
@@ -59,12 +59,15 @@ PBFTImpl::Ptr PBFTFactory::createPBFT()
     PBFT_LOG(INFO) << LOG_DESC("create PBFT validator");
     auto validator = std::make_shared<TxsValidator>(m_txpool, m_blockFactory, m_txResultFactory);
 
+    // the blocks executed by the StateMachine, shared with the storage
+    auto blockCache = std::make_shared<DecodedBlockCache>();
+
     PBFT_LOG(DEBUG) << LOG_DESC("create StateMachine");
-    auto stateMachine = std::make_shared<StateMachine>(m_scheduler, m_blockFactory);
+    auto stateMachine = std::make_shared<StateMachine>(m_scheduler, m_blockFactory, blockCache);
 
     PBFT_LOG(INFO) << LOG_DESC("create pbftStorage");
-    auto pbftStorage =
-        std::make_shared<LedgerStorage>(m_scheduler, m_storage, m_blockFactory, pbftMessageFactory);
+    auto pbftStorage = std::make_shared<LedgerStorage>(
+        m_scheduler, m_storage, m_blockFactory, pbftMessageFactory, blockCache);
 
     PBFT_LOG(INFO) << LOG_DESC("create pbftConfig");
     auto pbftConfig = std::make_shared<PBFTConfig>(m_cryptoSuite, m_keyPair, pbftMessageFactory,
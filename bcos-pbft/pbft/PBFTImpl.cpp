@@ -44,6 +44,8 @@ void PBFTImpl::stop()
     }
     m_blockValidator->stop();
     m_pbftEngine->stop();
+    // stop the timers after the engine stopped
+    m_timerWheel->stop();
     m_running = false;
     PBFT_LOG(INFO) << LOG_DESC("Stop the PBFT module.");
 }
@@ -129,20 +131,20 @@ void PBFTImpl::init()
     config->resetConfig(ledgerConfig);
 
     PBFT_LOG(INFO) << LOG_DESC("fetch PBFT state");
-    auto stateProposals = config->storage()->loadState(ledgerConfig->blockNumber());
-    if (stateProposals && stateProposals->size() > 0)
-    {
-        m_pbftEngine->initState(*stateProposals, config->keyPair()->publicKey());
-        auto lowWaterMarkIndex = stateProposals->size() - 1;
-        auto lowWaterMark = ((*stateProposals)[lowWaterMarkIndex])->index();
-        config->setLowWaterMark(lowWaterMark + 1);
-        PBFT_LOG(INFO) << LOG_DESC("init PBFT state")
-                       << LOG_KV("stateProposals", stateProposals->size())
-                       << LOG_KV("lowWaterMark", lowWaterMark)
-                       << LOG_KV("highWaterMark", config->highWaterMark());
-    }
-    config->timer()->start();
-    PBFT_LOG(INFO) << LOG_DESC("init PBFT success");
+    // the timer is started after the state recovered, and the engine is stopped when failed
+    // Note: the failure is reported by the stateRecovery of the consensus status, the timer wheel
+    // is stopped by stop() since the failure may be reported from the thread of the wheel
+    m_pbftEngine->asyncRecoverState(ledgerConfig->blockNumber(), [](Error::Ptr _error) {
+        if (_error)
+        {
+            PBFT_LOG(ERROR) << LOG_DESC("init PBFT failed for recover state failed")
+                            << LOG_KV("code", _error->errorCode())
+                            << LOG_KV("msg", _error->errorMessage());
+            return;
+        }
+        PBFT_LOG(INFO) << LOG_DESC("init PBFT success");
+    });
+    PBFT_LOG(INFO) << LOG_DESC("init PBFT: recovering state");
 }
 
 void PBFTImpl::asyncGetConsensusStatus(
@@ -163,12 +165,18 @@ void PBFTImpl::asyncGetConsensusStatus(
     consensusStatus["changeCycle"] = config->timer()->changeCycle();
     consensusStatus["view"] = config->view();
     consensusStatus["connectedNodeList"] = (int64_t)((config->connectedNodeList()).size());
+    consensusStatus["sealStallReason"] = sealStallReasonDesc(config->sealStallReason());
+    consensusStatus["executionBacklog"] = (int64_t)(config->executionBacklog());
+    consensusStatus["commitBacklog"] = (int64_t)(config->commitBacklog());
+    consensusStatus["stateRecovery"] = config->stateRecoverFailed() ?
+                                           "failed" :
+                                           (config->stateRecovering() ? "recovering" : "recovered");
 
     // print the nodeIndex of all other nodes
     auto nodeList = config->consensusNodeList();
     Json::Value consensusNodeInfo(Json::arrayValue);
     size_t i = 0;
-    for (auto const& node : nodeList)
+    for (auto const& node : *nodeList)
     {
         Json::Value info;
         info["nodeID"] = *toHexString(node->nodeID()->data());
@@ -33,7 +33,9 @@ public:
     using Ptr = std::shared_ptr<PBFTImpl>;
     explicit PBFTImpl(PBFTEngine::Ptr _pbftEngine) : m_pbftEngine(_pbftEngine)
     {
-        m_blockValidator = std::make_shared<BlockValidator>(m_pbftEngine->pbftConfig());
+        m_blockValidator = std::make_shared<BlockValidator>(
+            m_pbftEngine->pbftConfig(), m_pbftEngine->verifyPool());
+        m_timerWheel = m_pbftEngine->pbftConfig()->timerWheel();
     }
     virtual ~PBFTImpl() { stop(); }
 
@@ -107,7 +109,7 @@ public:
 
     ConsensusNodeList consensusNodeList() const override
     {
-        return m_pbftEngine->pbftConfig()->consensusNodeList();
+        return *(m_pbftEngine->pbftConfig()->consensusNodeList());
     }
     uint64_t nodeIndex() const override { return m_pbftEngine->pbftConfig()->nodeIndex(); }
     void asyncGetConsensusStatus(
@@ -126,6 +128,8 @@ public:
 protected:
     PBFTEngine::Ptr m_pbftEngine;
     BlockValidator::Ptr m_blockValidator;
+    // the timer wheel shared by the engine timer, the cache timers and the log sync
+    TimerWheel::Ptr m_timerWheel;
     bcos::tool::LedgerConfigFetcher::Ptr m_ledgerFetcher;
 
     std::atomic_bool m_running = {false};
@@ -29,7 +29,8 @@ PBFTCache::PBFTCache(PBFTConfig::Ptr _config, BlockNumber _index)
   : m_config(_config), m_index(_index)
 {
     // Timer is used to manage checkpoint timeout
-    m_timer = std::make_shared<PBFTTimer>(m_config->checkPointTimeoutInterval());
+    m_timer =
+        std::make_shared<PBFTTimer>(m_config->timerWheel(), m_config->checkPointTimeoutInterval());
 }
 void PBFTCache::init()
 {
@@ -74,7 +75,7 @@ void PBFTCache::onCheckPointTimeout()
         m_checkpointProposal, m_config->cryptoSuite(), m_config->keyPair(), true);
     auto encodedData = m_config->codec()->encode(checkPointMsg);
     m_config->frontService()->asyncSendMessageByNodeIDs(
-        ModuleID::PBFT, m_config->consensusNodeIDList(), ref(*encodedData));
+        ModuleID::PBFT, *(m_config->consensusNodeIDList()), ref(*encodedData));
     m_timer->restart();
 }
 
@@ -114,6 +115,30 @@ void PBFTCache::addCache(CollectionCacheType& _cachedReq, QuorumRecoderType& _we
     _cachedReq[proposalHash][generatedFrom] = _pbftCache;
 }
 
+void PBFTCache::addLocalCache(CollectionCacheType& _cachedReq, QuorumRecoderType& _weightInfo,
+    PBFTMessageInterface::Ptr _localMsg)
+{
+    // the self-generated message is produced for this index by the node-self, no need to check
+    // the index and look up the consensus node list
+    auto weight = m_config->nodeSnapshot()->weight(_localMsg->generatedFrom());
+    if (weight == 0)
+    {
+        return;
+    }
+    auto const& proposalHash = _localMsg->hash();
+    auto ret =
+        _cachedReq[proposalHash].insert(std::make_pair(_localMsg->generatedFrom(), _localMsg));
+    // the message regenerated after view change replaces the old one without counting the weight
+    if (!ret.second)
+    {
+        ret.first->second = _localMsg;
+        m_localReplacements++;
+        return;
+    }
+    _weightInfo[proposalHash] += weight;
+    m_localInjections++;
+}
+
 bool PBFTCache::conflictWithProcessedReq(PBFTMessageInterface::Ptr _msg)
 {
     if (_msg->view() < m_config->view())
@@ -245,19 +270,43 @@ bool PBFTCache::checkAndPreCommit()
     intoPrecommit();
     // generate the commitReq
     auto commitReq = m_config->pbftMessageFactory()->populateFrom(PacketType::CommitPacket,
-        m_config->pbftMsgDefaultVersion(), m_config->view(), utcTime(), m_config->nodeIndex(),
-        m_precommitWithoutData->consensusProposal(), m_config->cryptoSuite(), m_config->keyPair());
+        m_config->voteMsgVersion(), m_config->view(), utcTime(), m_config->nodeIndex(),
+        m_precommitWithoutData->consensusProposal(), m_config->cryptoSuite(), m_config->keyPair(),
+        false);
+    auto signatureData = m_config->cryptoSuite()->signatureImpl()->sign(
+        m_config->keyPair(), m_config->voteSignatureHash(commitReq));
+    commitReq->consensusProposal()->setSignature(*signatureData);
     // add the commitReq to local cache
-    addCommitCache(commitReq);
+    addLocalCommitCache(commitReq);
+    m_precommitted = true;
+    // the commitReq will be broadcasted in batch
+    if (m_consensusMsgBatcher && m_consensusMsgBatcher(commitReq))
+    {
+        return checkAndCommit();
+    }
+    if (m_checkPointPiggybacker)
+    {
+        m_checkPointPiggybacker(commitReq);
+    }
     // broadcast the commitReq
     PBFT_LOG(INFO) << LOG_DESC("checkAndPreCommit: broadcast commitMsg")
                    << LOG_KV("Idx", m_config->nodeIndex())
                    << LOG_KV("hash", commitReq->hash().abridged())
-                   << LOG_KV("index", commitReq->index());
-    auto encodedData = m_config->codec()->encode(commitReq, m_config->pbftMsgDefaultVersion());
-    m_config->frontService()->asyncSendMessageByNodeIDs(
-        bcos::protocol::ModuleID::PBFT, m_config->consensusNodeIDList(), ref(*encodedData));
-    m_precommitted = true;
+                   << LOG_KV("index", commitReq->index())
+                   << LOG_KV("checkPoints", commitReq->proposals().size());
+    auto receivers = m_voteReceiversGetter ? m_voteReceiversGetter(commitReq->index()) :
+                                             *(m_config->consensusNodeIDList());
+    if (!receivers.empty())
+    {
+        auto encodedData = m_config->codec()->encode(commitReq, m_config->pbftMsgDefaultVersion());
+        m_config->frontService()->asyncSendMessageByNodeIDs(
+            bcos::protocol::ModuleID::PBFT, receivers, ref(*encodedData));
+    }
+    // release the piggybacked checkpoints
+    if (commitReq->proposals().size() > 0)
+    {
+        commitReq->setProposals(PBFTProposalList());
+    }
     // collect the commitReq and try to commit
     return checkAndCommit();
 }
@@ -280,8 +329,19 @@ bool PBFTCache::checkAndCommit()
     }
     PBFT_LOG(INFO) << LOG_DESC("checkAndCommit")
                    << printPBFTProposal(m_precommit->consensusProposal())
+                   << LOG_KV("localInjections", m_localInjections)
+                   << LOG_KV("localReplacements", m_localReplacements)
                    << m_config->printCurrentState();
     m_submitted.store(true);
+    // the latency across the view change is not the latency of the leader
+    if (m_prePrepare && m_prePrepare->view() == m_precommit->view())
+    {
+        m_config->updateConsensusLatency(m_prePrepare->generatedFrom());
+    }
+    else
+    {
+        m_config->markConsensusProgress();
+    }
     return true;
 }
 
@@ -294,10 +354,72 @@ bool PBFTCache::shouldStopTimer()
     return m_submitted;
 }
 
+PBFTMessageInterface::Ptr PBFTCache::generateCertificate(PacketType _certificateType)
+{
+    auto view = m_config->view();
+    auto version = m_config->voteMsgVersion();
+    PBFTProposalInterface::Ptr certificateProposal;
+    if (_certificateType == PacketType::PrepareCertificatePacket)
+    {
+        if (!m_precommitted || m_prepareCertificateSent)
+        {
+            return nullptr;
+        }
+        certificateProposal = m_config->pbftMessageFactory()->populateFrom(
+            m_precommit->consensusProposal(), false, false);
+        setSignatureList(certificateProposal, m_prepareCacheList);
+        m_prepareCertificateSent = true;
+    }
+    else
+    {
+        if (!m_submitted || m_commitCertificateSent)
+        {
+            return nullptr;
+        }
+        certificateProposal = m_config->pbftMessageFactory()->populateFrom(
+            m_precommit->consensusProposal(), false, false);
+        // the commit votes sign the view and the version decides the signed hash, only the votes
+        // of the certificate view and version can be verified
+        for (auto const& it : m_commitCacheList[certificateProposal->hash()])
+        {
+            if (it.second->view() == view && it.second->version() == version)
+            {
+                certificateProposal->appendSignatureProof(
+                    it.first, it.second->consensusProposal()->signature());
+            }
+        }
+        m_commitCertificateSent = true;
+    }
+    return m_config->pbftMessageFactory()->populateFrom(
+        _certificateType, certificateProposal, version, view, utcTime(), m_config->nodeIndex());
+}
+
+PBFTMessageList PBFTCache::localVotes()
+{
+    PBFTMessageList votes;
+    if (!m_prePrepare)
+    {
+        return votes;
+    }
+    auto const& hash = m_prePrepare->hash();
+    auto nodeIndex = m_config->nodeIndex();
+    if (m_prepareCacheList.count(hash) && m_prepareCacheList[hash].count(nodeIndex))
+    {
+        votes.push_back(m_prepareCacheList[hash][nodeIndex]);
+    }
+    if (m_commitCacheList.count(hash) && m_commitCacheList[hash].count(nodeIndex))
+    {
+        votes.push_back(m_commitCacheList[hash][nodeIndex]);
+    }
+    return votes;
+}
+
 void PBFTCache::resetCache(ViewType _curView)
 {
     m_submitted = false;
     m_precommitted = false;
+    m_prepareCertificateSent = false;
+    m_commitCertificateSent = false;
     if (!m_precommit && m_prePrepare && m_prePrepare->consensusProposal() &&
         m_prePrepare->view() < _curView)
     {
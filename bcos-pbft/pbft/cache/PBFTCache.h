@@ -70,8 +70,38 @@ public:
                        << m_config->printCurrentState();
     }
 
+    // the trusted paths for the messages generated by the node-self, which skip the index check,
+    // the duplicate scan and the consensus node lookup of the network path
+    // Note: the messages of the node-self are not signature-verified on either path
+    virtual void addLocalPrePrepareCache(PBFTMessageInterface::Ptr _prePrepareMsg)
+    {
+        addPrePrepareCache(_prePrepareMsg);
+        if (m_prePrepare == _prePrepareMsg)
+        {
+            m_localInjections++;
+        }
+    }
+    virtual void addLocalPrepareCache(PBFTMessageInterface::Ptr _prepareMsg)
+    {
+        addLocalCache(m_prepareCacheList, m_prepareReqWeight, _prepareMsg);
+        PBFT_LOG(INFO) << LOG_DESC("addLocalPrepareCache") << printPBFTMsgInfo(_prepareMsg)
+                       << LOG_KV("weight", m_prepareReqWeight[_prepareMsg->hash()]);
+    }
+    virtual void addLocalCommitCache(PBFTMessageInterface::Ptr _commitMsg)
+    {
+        addLocalCache(m_commitCacheList, m_commitReqWeight, _commitMsg);
+        PBFT_LOG(INFO) << LOG_DESC("addLocalCommitCache") << printPBFTMsgInfo(_commitMsg)
+                       << LOG_KV("weight", m_commitReqWeight[_commitMsg->hash()]);
+    }
+    // the self-generated messages added into the cache through the trusted paths, each skipped
+    // the checks of the network path once
+    size_t localInjections() const { return m_localInjections; }
+    // the self-generated votes that replaced the existing ones without adding any weight
+    size_t localReplacements() const { return m_localReplacements; }
+
     bcos::protocol::BlockNumber index() const { return m_index; }
 
+    virtual PBFTMessageInterface::Ptr prePrepareCache() { return m_prePrepare; }
     virtual PBFTMessageInterface::Ptr preCommitCache() { return m_precommit; }
     virtual PBFTMessageInterface::Ptr preCommitWithoutData() { return m_precommitWithoutData; }
     virtual bool checkAndPreCommit();
@@ -96,6 +126,30 @@ public:
     virtual void onCheckPointTimeout();
     bool stableCommitted() const { return m_stableCommitted; }
     bool precommitted() const { return m_precommitted; }
+    bool submitted() const { return m_submitted; }
+
+    // generate the prepare/commit certificate once for the collector, return nullptr if not ready
+    virtual PBFTMessageInterface::Ptr generateCertificate(PacketType _certificateType);
+    // the prepare/commit messages generated by the node itself
+    virtual PBFTMessageList localVotes();
+
+    void registerVoteReceiversGetter(
+        std::function<bcos::crypto::NodeIDs(bcos::protocol::BlockNumber)> _voteReceiversGetter)
+    {
+        m_voteReceiversGetter = _voteReceiversGetter;
+    }
+
+    void registerConsensusMsgBatcher(
+        std::function<bool(PBFTMessageInterface::Ptr)> _consensusMsgBatcher)
+    {
+        m_consensusMsgBatcher = _consensusMsgBatcher;
+    }
+
+    void registerCheckPointPiggybacker(
+        std::function<void(PBFTMessageInterface::Ptr)> _checkPointPiggybacker)
+    {
+        m_checkPointPiggybacker = _checkPointPiggybacker;
+    }
 
     void registerCommittedIndexNotify(
         std::function<void(bcos::protocol::BlockNumber)> _committedIndexNotifier)
@@ -120,6 +174,8 @@ protected:
     using QuorumRecoderType = std::map<bcos::crypto::HashType, uint64_t>;
     void addCache(CollectionCacheType& _cachedReq, QuorumRecoderType& _weightInfo,
         PBFTMessageInterface::Ptr _proposal);
+    void addLocalCache(CollectionCacheType& _cachedReq, QuorumRecoderType& _weightInfo,
+        PBFTMessageInterface::Ptr _localMsg);
     bool collectEnoughQuorum(bcos::crypto::HashType const& _hash, QuorumRecoderType& _weightInfo);
 
     bool collectEnoughPrepareReq();
@@ -187,6 +243,11 @@ protected:
     // avoid submitting the same stable checkpoint multiple times
     std::atomic_bool m_stableCommitted = {false};
     std::atomic_bool m_precommitted = {false};
+    // the collector broadcasts the certificates only once
+    std::atomic_bool m_prepareCertificateSent = {false};
+    std::atomic_bool m_commitCertificateSent = {false};
+    std::atomic<size_t> m_localInjections = {0};
+    std::atomic<size_t> m_localReplacements = {0};
     std::atomic<bcos::protocol::BlockNumber> m_index;
     // prepareCacheList
     CollectionCacheType m_prepareCacheList;
@@ -207,6 +268,12 @@ protected:
     PBFTTimer::Ptr m_timer;
 
     std::function<void(bcos::protocol::BlockNumber)> m_committedIndexNotifier;
+    // attach the pending checkpoints to the commit message
+    std::function<void(PBFTMessageInterface::Ptr)> m_checkPointPiggybacker;
+    // collect the commit message into the batch, return false when batch disabled
+    std::function<bool(PBFTMessageInterface::Ptr)> m_consensusMsgBatcher;
+    // the receivers of the commit message, all the consensus nodes or the collector
+    std::function<bcos::crypto::NodeIDs(bcos::protocol::BlockNumber)> m_voteReceiversGetter;
 };
 }  // namespace consensus
 }  // namespace bcos
@@ -110,6 +110,15 @@ void PBFTCacheProcessor::addPrePrepareCache(PBFTMessageInterface::Ptr _prePrepar
     notifyMaxProposalIndex(_prePrepareMsg->index());
 }
 
+void PBFTCacheProcessor::addLocalPrePrepareCache(PBFTMessageInterface::Ptr _prePrepareMsg)
+{
+    addCache(m_caches, _prePrepareMsg,
+        [](PBFTCache::Ptr _pbftCache, PBFTMessageInterface::Ptr proposal) {
+            _pbftCache->addLocalPrePrepareCache(proposal);
+        });
+    notifyMaxProposalIndex(_prePrepareMsg->index());
+}
+
 void PBFTCacheProcessor::notifyMaxProposalIndex(bcos::protocol::BlockNumber _proposalIndex)
 {
     // notify the consensusing proposal index to the sync module
@@ -183,10 +192,21 @@ void PBFTCacheProcessor::addCache(
         _pbftCache[index] = m_cacheFactory->createPBFTCache(m_config, index,
             boost::bind(
                 &PBFTCacheProcessor::notifyCommittedProposalIndex, this, boost::placeholders::_1));
+        initCache(_pbftCache[index]);
     }
     _handler(_pbftCache[index], _pbftReq);
 }
 
+void PBFTCacheProcessor::initCache(PBFTCache::Ptr _cache)
+{
+    _cache->registerCheckPointPiggybacker(
+        boost::bind(&PBFTCacheProcessor::piggybackCheckPoints, this, boost::placeholders::_1));
+    _cache->registerConsensusMsgBatcher(
+        boost::bind(&PBFTCacheProcessor::tryToBatchConsensusMsg, this, boost::placeholders::_1));
+    _cache->registerVoteReceiversGetter(
+        boost::bind(&PBFTCacheProcessor::voteReceivers, this, boost::placeholders::_1));
+}
+
 void PBFTCacheProcessor::checkAndPreCommit()
 {
     for (auto const& it : m_caches)
@@ -198,6 +218,7 @@ void PBFTCacheProcessor::checkAndPreCommit()
         }
         updateCommitQueue(it.second->preCommitCache()->consensusProposal());
     }
+    tryToBroadcastCertificates();
 }
 
 void PBFTCacheProcessor::checkAndCommit()
@@ -214,6 +235,7 @@ void PBFTCacheProcessor::checkAndCommit()
         m_config->timer()->restart();
         m_config->resetToView();
     }
+    tryToBroadcastCertificates();
     resetTimer();
 }
 
@@ -226,6 +248,7 @@ void PBFTCacheProcessor::resetTimer()
             // start the timer when there has proposals in consensus
             if (!m_config->timer()->running())
             {
+                m_config->markConsensusProgress();
                 m_config->timer()->start();
             }
             return;
@@ -246,6 +269,7 @@ void PBFTCacheProcessor::updateCommitQueue(PBFTProposalInterface::Ptr _committed
     notifyMaxProposalIndex(_committedProposal->index());
     m_committedQueue.push(_committedProposal);
     m_committedProposalList.insert(_committedProposal->index());
+    updateExecutionBacklog();
     PBFT_LOG(INFO) << LOG_DESC("######## CommitProposal") << printPBFTProposal(_committedProposal)
                    << LOG_KV("sys", _committedProposal->systemProposal())
                    << m_config->printCurrentState();
@@ -298,6 +322,7 @@ bool PBFTCacheProcessor::tryToApplyCommitQueue()
                        << m_config->printCurrentState();
         m_committedQueue.pop();
     }
+    updateExecutionBacklog();
     // try to execute the proposal
     if (!m_committedQueue.empty() &&
         m_committedQueue.top()->index() == m_config->expectedCheckPoint())
@@ -425,6 +450,7 @@ void PBFTCacheProcessor::setCheckPointProposal(PBFTProposalInterface::Ptr _propo
                                       << LOG_KV("errorInfo", boost::diagnostic_information(e));
                 }
             });
+        initCache(m_caches[index]);
     }
     (m_caches[index])->setCheckPointProposal(_proposal);
 }
@@ -441,7 +467,9 @@ void PBFTCacheProcessor::addViewChangeReq(ViewChangeMsgInterface::Ptr _viewChang
 {
     auto reqView = _viewChange->view();
     auto fromIdx = _viewChange->generatedFrom();
-    if (m_viewChangeCache.count(reqView) && m_viewChangeCache[reqView].count(fromIdx))
+    // only keep the viewChange of the highest view for every node
+    auto nodeView = m_viewChangeNodeView.find(fromIdx);
+    if (nodeView != m_viewChangeNodeView.end() && nodeView->second.view >= reqView)
     {
         return;
     }
@@ -451,26 +479,21 @@ void PBFTCacheProcessor::addViewChangeReq(ViewChangeMsgInterface::Ptr _viewChang
     {
         return;
     }
-    m_viewChangeCache[reqView][fromIdx] = _viewChange;
-    if (!m_viewChangeWeight.count(reqView))
-    {
-        m_viewChangeWeight[reqView] = 0;
-    }
-    m_viewChangeWeight[reqView] += nodeInfo->weight();
-    auto committedIndex = _viewChange->committedProposal()->index();
-    if (!m_maxCommittedIndex.count(reqView) || m_maxCommittedIndex[reqView] < committedIndex)
+    if (nodeView != m_viewChangeNodeView.end())
     {
-        m_maxCommittedIndex[reqView] = committedIndex;
-    }
-    // get the max precommitIndex
-    for (auto precommit : _viewChange->preparedProposals())
-    {
-        auto precommitIndex = precommit->index();
-        if (!m_maxPrecommitIndex.count(reqView) || m_maxPrecommitIndex[reqView] < precommitIndex)
-        {
-            m_maxPrecommitIndex[reqView] = precommitIndex;
-        }
+        removeViewChangeReq(nodeView->second.view, fromIdx);
     }
+    stripPreparedProposalData(_viewChange);
+    m_viewChangeCache[reqView][fromIdx] = _viewChange;
+    // record the weight and the size, in case of the consensus node list changed before eviction
+    CachedViewChange cachedViewChange;
+    cachedViewChange.view = reqView;
+    cachedViewChange.weight = nodeInfo->weight();
+    cachedViewChange.size = viewChangeReqSize(_viewChange);
+    m_viewChangeNodeView[fromIdx] = cachedViewChange;
+    m_viewChangeCacheSize += cachedViewChange.size;
+    m_viewChangeWeight[reqView] += cachedViewChange.weight;
+    updateViewChangeIndexes(reqView, _viewChange);
     // print the prepared proposal info
     std::stringstream preparedProposalInfo;
     preparedProposalInfo << "preparedProposalInfo: ";
@@ -482,11 +505,126 @@ void PBFTCacheProcessor::addViewChangeReq(ViewChangeMsgInterface::Ptr _viewChang
     }
     PBFT_LOG(INFO) << LOG_DESC("addViewChangeReq") << printPBFTMsgInfo(_viewChange)
                    << LOG_KV("weight", m_viewChangeWeight[reqView])
+                   << LOG_KV("cachedViewChanges", m_viewChangeNodeView.size())
+                   << LOG_KV("cacheSize", m_viewChangeCacheSize)
                    << LOG_KV("maxCommittedIndex", m_maxCommittedIndex[reqView])
                    << LOG_KV("maxPrecommitIndex", m_maxPrecommitIndex[reqView])
                    << LOG_DESC(preparedProposalInfo.str()) << m_config->printCurrentState();
 }
 
+void PBFTCacheProcessor::updateViewChangeIndexes(
+    ViewType _view, ViewChangeMsgInterface::Ptr _viewChange)
+{
+    auto committedIndex = _viewChange->committedProposal()->index();
+    if (!m_maxCommittedIndex.count(_view) || m_maxCommittedIndex[_view] < committedIndex)
+    {
+        m_maxCommittedIndex[_view] = committedIndex;
+    }
+    // get the max precommitIndex
+    for (auto precommit : _viewChange->preparedProposals())
+    {
+        auto precommitIndex = precommit->index();
+        if (!m_maxPrecommitIndex.count(_view) || m_maxPrecommitIndex[_view] < precommitIndex)
+        {
+            m_maxPrecommitIndex[_view] = precommitIndex;
+        }
+    }
+}
+
+void PBFTCacheProcessor::removeViewChangeReq(ViewType _view, IndexType _nodeIndex)
+{
+    auto it = m_viewChangeCache.find(_view);
+    if (it == m_viewChangeCache.end())
+    {
+        return;
+    }
+    if (!it->second.erase(_nodeIndex))
+    {
+        return;
+    }
+    evictViewChangeReq(_view, _nodeIndex);
+    if (it->second.empty())
+    {
+        m_viewChangeCache.erase(it);
+        m_maxCommittedIndex.erase(_view);
+        m_maxPrecommitIndex.erase(_view);
+        return;
+    }
+    // the max indexes may come from the removed viewChange
+    m_maxCommittedIndex.erase(_view);
+    m_maxPrecommitIndex.erase(_view);
+    for (auto const& cache : it->second)
+    {
+        updateViewChangeIndexes(_view, cache.second);
+    }
+}
+
+void PBFTCacheProcessor::evictViewChangeReq(ViewType _view, IndexType _nodeIndex)
+{
+    auto nodeView = m_viewChangeNodeView.find(_nodeIndex);
+    if (nodeView == m_viewChangeNodeView.end() || nodeView->second.view != _view)
+    {
+        return;
+    }
+    auto const& cachedViewChange = nodeView->second;
+    m_viewChangeCacheSize -= std::min(m_viewChangeCacheSize, cachedViewChange.size);
+    auto weight = m_viewChangeWeight.find(_view);
+    if (weight != m_viewChangeWeight.end())
+    {
+        weight->second -= std::min(weight->second, cachedViewChange.weight);
+        if (weight->second == 0)
+        {
+            m_viewChangeWeight.erase(weight);
+        }
+    }
+    m_viewChangeNodeView.erase(nodeView);
+}
+
+void PBFTCacheProcessor::stripPreparedProposalData(ViewChangeMsgInterface::Ptr _viewChange)
+{
+    for (auto const& precommit : _viewChange->preparedProposals())
+    {
+        auto proposal = precommit->consensusProposal();
+        if (!proposal || proposal->data().size() == 0)
+        {
+            continue;
+        }
+        // the payload is fetched from the local precommit cache when generating the prePrepare
+        auto it = m_caches.find(precommit->index());
+        if (it == m_caches.end() || !it->second->preCommitCache())
+        {
+            continue;
+        }
+        auto localProposal = it->second->preCommitCache()->consensusProposal();
+        if (!localProposal || localProposal->hash() != proposal->hash() ||
+            localProposal->data().size() == 0)
+        {
+            continue;
+        }
+        proposal->setData(bytes());
+    }
+}
+
+size_t PBFTCacheProcessor::viewChangeReqSize(ViewChangeMsgInterface::Ptr _viewChange)
+{
+    size_t size = c_viewChangeReqOverhead;
+    for (auto const& precommit : _viewChange->preparedProposals())
+    {
+        size += c_viewChangeReqOverhead;
+        auto proposal = precommit->consensusProposal();
+        if (!proposal)
+        {
+            continue;
+        }
+        size += proposal->data().size();
+        for (size_t i = 0; i < proposal->signatureProofSize(); i++)
+        {
+            size += proposal->signatureProof(i).second.size();
+        }
+    }
+    return size;
+}
+
 PBFTMessageList PBFTCacheProcessor::generatePrePrepareMsg(
     std::map<IndexType, ViewChangeMsgInterface::Ptr> _viewChangeCache)
 {
@@ -606,7 +744,7 @@ NewViewMsgInterface::Ptr PBFTCacheProcessor::checkAndTryIntoNewView()
     newViewMsg->setHash(m_config->committedProposal()->hash());
     newViewMsg->setIndex(m_config->committedProposal()->index());
     newViewMsg->setPacketType(PacketType::NewViewPacket);
-    newViewMsg->setVersion(m_config->pbftMsgDefaultVersion());
+    newViewMsg->setVersion(m_config->newViewMsgVersion());
     newViewMsg->setView(toView);
     newViewMsg->setTimestamp(utcTime());
     newViewMsg->setGeneratedFrom(m_config->nodeIndex());
@@ -618,7 +756,7 @@ NewViewMsgInterface::Ptr PBFTCacheProcessor::checkAndTryIntoNewView()
     // encode and broadcast the viewchangeReq
     auto encodedData = m_config->codec()->encode(newViewMsg);
     m_config->frontService()->asyncSendMessageByNodeIDs(
-        ModuleID::PBFT, m_config->consensusNodeIDList(), ref(*encodedData));
+        ModuleID::PBFT, *(m_config->consensusNodeIDList()), ref(*encodedData));
     m_newViewGenerated = true;
     PBFT_LOG(INFO) << LOG_DESC("The next leader broadcast NewView request")
                    << printPBFTMsgInfo(newViewMsg) << LOG_KV("Idx", m_config->nodeIndex());
@@ -627,34 +765,20 @@ NewViewMsgInterface::Ptr PBFTCacheProcessor::checkAndTryIntoNewView()
 
 ViewType PBFTCacheProcessor::tryToTriggerFastViewChange()
 {
+    // Note: the cache keeps one viewChange for every node, so the views are no more than the nodes
     uint64_t greaterViewWeight = 0;
     ViewType viewToReach = 0;
-    for (auto const& it : m_viewChangeCache)
+    auto it = m_viewChangeWeight.upper_bound(m_config->toView());
+    if (it != m_viewChangeWeight.end())
     {
-        auto view = it.first;
-        if (view <= m_config->toView())
-        {
-            continue;
-        }
-        if (viewToReach == 0)
-        {
-            viewToReach = view;
-        }
-        if (viewToReach > view)
-        {
-            viewToReach = view;
-        }
-        // check the quorum
-        auto viewChangeCache = it.second;
-        for (auto const& cache : viewChangeCache)
+        viewToReach = it->first;
+    }
+    for (; it != m_viewChangeWeight.end(); it++)
+    {
+        greaterViewWeight += it->second;
+        if (greaterViewWeight >= (m_config->maxFaultyQuorum() + 1))
         {
-            auto fromIdx = cache.first;
-            auto nodeInfo = m_config->getConsensusNodeByIndex(fromIdx);
-            if (!nodeInfo)
-            {
-                continue;
-            }
-            greaterViewWeight += nodeInfo->weight();
+            break;
         }
     }
     if (greaterViewWeight < (m_config->maxFaultyQuorum() + 1))
@@ -693,28 +817,29 @@ bool PBFTCacheProcessor::checkPrecommitMsg(PBFTMessageInterface::Ptr _precommitM
 bool PBFTCacheProcessor::checkPrecommitWeight(PBFTMessageInterface::Ptr _precommitMsg)
 {
     auto precommitProposal = _precommitMsg->consensusProposal();
-    // check the signature
-    uint64_t weight = 0;
-    auto proofSize = precommitProposal->signatureProofSize();
-    for (size_t i = 0; i < proofSize; i++)
-    {
-        auto proof = precommitProposal->signatureProof(i);
-        // check the proof
-        auto nodeInfo = m_config->getConsensusNodeByIndex(proof.first);
-        if (!nodeInfo)
-        {
-            return false;
-        }
-        // verify the signature
-        auto ret = m_config->cryptoSuite()->signatureImpl()->verify(
-            nodeInfo->nodeID(), precommitProposal->hash(), proof.second);
-        if (!ret)
-        {
-            return false;
-        }
-        weight += nodeInfo->weight();
+    // check the signature and the quorum
+    auto snapshot = m_config->nodeSnapshot();
+    auto weight = m_config->signatureProofVerifier()->verifyProofs(precommitProposal->hash(),
+        signatureProofs(precommitProposal), snapshot->consensusNodeList());
+    return (weight >= m_config->minRequiredQuorum());
+}
+
+bool PBFTCacheProcessor::checkCertificate(PBFTMessageInterface::Ptr _certificate)
+{
+    auto certificateProposal = _certificate->consensusProposal();
+    if (certificateProposal->index() != _certificate->index() ||
+        certificateProposal->hash() != _certificate->hash())
+    {
+        return false;
     }
-    // check the quorum
+    auto voteType = (_certificate->packetType() == PacketType::PrepareCertificatePacket) ?
+                        PacketType::PreparePacket :
+                        PacketType::CommitPacket;
+    auto signedHash = m_config->voteSignatureHash(voteType, _certificate->view(),
+        certificateProposal->index(), certificateProposal->hash(), _certificate->version());
+    auto snapshot = m_config->nodeSnapshot();
+    auto weight = m_config->signatureProofVerifier()->verifyProofs(
+        signedHash, signatureProofs(certificateProposal), snapshot->consensusNodeList());
     return (weight >= m_config->minRequiredQuorum());
 }
 
@@ -755,6 +880,10 @@ void PBFTCacheProcessor::removeConsensusedCache(ViewType _view, BlockNumber _con
         }
         pcache++;
     }
+    m_collectorVoteTime.erase(
+        m_collectorVoteTime.begin(), m_collectorVoteTime.upper_bound(_consensusedNumber));
+    m_collectorFallbackIndexes.erase(m_collectorFallbackIndexes.begin(),
+        m_collectorFallbackIndexes.upper_bound(_consensusedNumber));
     removeInvalidViewChange(_view, _consensusedNumber);
     m_maxPrecommitIndex.clear();
     m_maxCommittedIndex.clear();
@@ -799,6 +928,10 @@ void PBFTCacheProcessor::removeInvalidViewChange(
         auto view = it->first;
         if (view <= _view)
         {
+            for (auto const& cache : it->second)
+            {
+                evictViewChangeReq(view, cache.first);
+            }
             it = m_viewChangeCache.erase(it);
             m_viewChangeWeight.erase(view);
             continue;
@@ -810,34 +943,19 @@ void PBFTCacheProcessor::removeInvalidViewChange(
             auto index = pcache->second->index();
             if (index < _latestCommittedProposal)
             {
+                evictViewChangeReq(view, pcache->first);
                 pcache = viewChangeCache.erase(pcache);
                 continue;
             }
             pcache++;
         }
-        it++;
-    }
-    // recalculate m_viewChangeWeight
-    reCalculateViewChangeWeight();
-}
-
-void PBFTCacheProcessor::reCalculateViewChangeWeight()
-{
-    for (auto const& it : m_viewChangeCache)
-    {
-        auto view = it.first;
-        m_viewChangeWeight[view] = 0;
-        auto const& viewChangeCache = it.second;
-        for (auto const& cache : viewChangeCache)
+        if (viewChangeCache.empty())
         {
-            auto generatedFrom = cache.second->generatedFrom();
-            auto nodeInfo = m_config->getConsensusNodeByIndex(generatedFrom);
-            if (!nodeInfo)
-            {
-                continue;
-            }
-            m_viewChangeWeight[view] += nodeInfo->weight();
+            it = m_viewChangeCache.erase(it);
+            m_viewChangeWeight.erase(view);
+            continue;
         }
+        it++;
     }
 }
 
@@ -982,6 +1100,7 @@ void PBFTCacheProcessor::removeFutureProposals()
         m_config->validator()->asyncResetTxsFlag(proposal->data(), false);
     }
     m_committedProposalList.clear();
+    updateExecutionBacklog();
 
     // clear stable checkpoint queue
     std::priority_queue<PBFTProposalInterface::Ptr, std::vector<PBFTProposalInterface::Ptr>,
@@ -1024,6 +1143,7 @@ void PBFTCacheProcessor::clearExpiredExecutingProposal()
         }
         it = m_executingProposals.erase(it);
     }
+    updateExecutionBacklog();
 }
 
 void PBFTCacheProcessor::addRecoverReqCache(PBFTMessageInterface::Ptr _recoverResponse)
@@ -1091,4 +1211,279 @@ PBFTProposalInterface::Ptr PBFTCacheProcessor::fetchPrecommitProposal(
         return nullptr;
     }
     return cache->preCommitCache()->consensusProposal();
-}
\ No newline at end of file
+}
+PBFTProposalList PBFTCacheProcessor::fetchPendingCheckPoints()
+{
+    auto pendingCheckPoints = std::move(m_pendingCheckPoints);
+    m_pendingCheckPoints.clear();
+    m_lastCheckPointFlushTime = utcTime();
+    return pendingCheckPoints;
+}
+
+void PBFTCacheProcessor::piggybackCheckPoints(PBFTMessageInterface::Ptr _pbftMsg)
+{
+    // Note: the proposals of the batched message are occupied by the batched entries, and the
+    // votes are only sent to the collector in collector mode
+    if (!m_config->piggybackCheckPoint() || m_config->batchConsensusMsg() ||
+        m_config->collectorMode() || m_pendingCheckPoints.empty())
+    {
+        return;
+    }
+    // Note: the receiver only accepts the checkpoints lower than the index of the carrier, the
+    // others are kept for the next carrier or the flush timer
+    PBFTProposalList checkPoints;
+    PBFTProposalList remainingCheckPoints;
+    for (auto const& checkPoint : m_pendingCheckPoints)
+    {
+        if (checkPoint->index() < _pbftMsg->index())
+        {
+            checkPoints.push_back(checkPoint);
+            continue;
+        }
+        remainingCheckPoints.push_back(checkPoint);
+    }
+    if (checkPoints.empty())
+    {
+        return;
+    }
+    if (remainingCheckPoints.empty())
+    {
+        m_lastCheckPointFlushTime = utcTime();
+    }
+    m_pendingCheckPoints = std::move(remainingCheckPoints);
+    _pbftMsg->setProposals(checkPoints);
+    PBFT_LOG(DEBUG) << LOG_DESC("piggybackCheckPoints") << printPBFTMsgInfo(_pbftMsg)
+                    << LOG_KV("checkPoints", checkPoints.size())
+                    << LOG_KV("remaining", m_pendingCheckPoints.size());
+}
+
+bool PBFTCacheProcessor::existPendingVote()
+{
+    for (auto const& it : m_caches)
+    {
+        if (it.first < m_config->expectedCheckPoint())
+        {
+            continue;
+        }
+        // the commit message will be sent after collecting enough prepare messages
+        auto cache = it.second;
+        if (cache->prePrepareCache() && !cache->precommitted())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PBFTCacheProcessor::tryToBatchConsensusMsg(PBFTMessageInterface::Ptr _pbftMsg)
+{
+    if (!m_config->batchConsensusMsg())
+    {
+        return false;
+    }
+    if (m_batchedConsensusMsgSize == 0)
+    {
+        m_batchStartTime = utcTime();
+    }
+    auto& batchedMsgs = m_batchedConsensusMsgs[_pbftMsg->packetType()];
+    batchedMsgs.push_back(_pbftMsg);
+    m_batchedConsensusMsgSize++;
+    // the batch can't exceed the waterMark
+    if ((int64_t)batchedMsgs.size() >= m_config->warterMarkLimit())
+    {
+        flushBatchedConsensusMsg(true);
+    }
+    return true;
+}
+
+void PBFTCacheProcessor::flushBatchedConsensusMsg(bool _enforce)
+{
+    if (m_batchedConsensusMsgSize == 0)
+    {
+        return;
+    }
+    if (!_enforce && (utcTime() - m_batchStartTime) < m_config->consensusMsgBatchDelay())
+    {
+        return;
+    }
+    // Note: the map is ordered by the packetType, the PrePrepare messages are broadcasted firstly
+    for (auto const& it : m_batchedConsensusMsgs)
+    {
+        auto const& batchedMsgs = it.second;
+        if (batchedMsgs.empty())
+        {
+            continue;
+        }
+        if (it.first == PacketType::PrePreparePacket)
+        {
+            sendBatchedConsensusMsg(it.first, batchedMsgs, *(m_config->consensusNodeIDList()));
+            continue;
+        }
+        // Note: in collector mode, every vote is sent to the collector of its own index
+        std::map<std::string, std::pair<NodeIDs, PBFTMessageList>> collectorBatches;
+        for (auto const& msg : batchedMsgs)
+        {
+            auto receivers = voteReceivers(msg->index());
+            // the collector of the index is the node itself
+            if (receivers.empty())
+            {
+                continue;
+            }
+            auto collectorKey = (receivers.size() == 1) ? receivers[0]->hex() : std::string();
+            auto& collectorBatch = collectorBatches[collectorKey];
+            if (collectorBatch.first.empty())
+            {
+                collectorBatch.first = std::move(receivers);
+            }
+            collectorBatch.second.push_back(msg);
+        }
+        for (auto const& collectorBatch : collectorBatches)
+        {
+            sendBatchedConsensusMsg(
+                it.first, collectorBatch.second.second, collectorBatch.second.first);
+        }
+    }
+    m_batchedConsensusMsgs.clear();
+    m_batchedConsensusMsgSize = 0;
+}
+
+void PBFTCacheProcessor::sendBatchedConsensusMsg(
+    PacketType _packetType, PBFTMessageList const& _batchedMsgs, NodeIDs const& _receivers)
+{
+    PBFTProposalList entries;
+    for (auto const& msg : _batchedMsgs)
+    {
+        entries.push_back(msg->consensusProposal());
+    }
+    auto firstMsg = _batchedMsgs[0];
+    auto batchMsg = m_config->pbftMessageFactory()->createPBFTMsg();
+    batchMsg->setPacketType(batchedPacketType(_packetType));
+    // the entries are verified with the version of the batch
+    batchMsg->setVersion(firstMsg->version());
+    batchMsg->setView(firstMsg->view());
+    batchMsg->setTimestamp(utcTime());
+    batchMsg->setGeneratedFrom(m_config->nodeIndex());
+    batchMsg->setIndex(firstMsg->index());
+    batchMsg->setProposals(entries);
+    // bind the entries to the signed envelope, so that the entries can't be relabelled or
+    // replayed with another packetType or view
+    batchMsg->setHash(calculateBatchDigest(batchMsg));
+    auto encodedData = m_config->codec()->encode(batchMsg);
+    m_config->frontService()->asyncSendMessageByNodeIDs(
+        ModuleID::PBFT, _receivers, ref(*encodedData));
+    PBFT_LOG(INFO) << LOG_DESC("sendBatchedConsensusMsg") << printPBFTMsgInfo(batchMsg)
+                   << LOG_KV("batchSize", entries.size())
+                   << LOG_KV("receivers", _receivers.size());
+    // return back the ownership of the entries
+    batchMsg->setProposals(PBFTProposalList());
+}
+
+HashType PBFTCacheProcessor::calculateBatchDigest(PBFTMessageInterface::Ptr _batchMsg)
+{
+    bytes digestData;
+    auto appendValue = [&digestData](int64_t _value) {
+        for (int i = 7; i >= 0; i--)
+        {
+            digestData.push_back((byte)(((uint64_t)_value >> (8 * i)) & 0xff));
+        }
+    };
+    appendValue(_batchMsg->packetType());
+    appendValue(_batchMsg->view());
+    for (auto const& proposal : _batchMsg->proposals())
+    {
+        appendValue(proposal->index());
+        auto const& hash = proposal->hash();
+        digestData.insert(digestData.end(), hash.data(), hash.data() + HashType::size);
+    }
+    return m_config->cryptoSuite()->hashImpl()->hash(digestData);
+}
+
+NodeIDs PBFTCacheProcessor::voteReceivers(BlockNumber _index)
+{
+    if (!m_config->collectorMode() || m_collectorFallbackIndexes.count(_index))
+    {
+        return *(m_config->consensusNodeIDList());
+    }
+    auto collectorIndex = m_config->leaderIndex(_index);
+    // the collector collects the votes from the other nodes
+    if (collectorIndex == m_config->nodeIndex())
+    {
+        return NodeIDs();
+    }
+    auto collector = m_config->getConsensusNodeByIndex(collectorIndex);
+    if (!collector)
+    {
+        return *(m_config->consensusNodeIDList());
+    }
+    // wait for the certificate from the collector
+    m_collectorVoteTime[_index] = utcTime();
+    NodeIDs receivers;
+    receivers.push_back(collector->nodeID());
+    return receivers;
+}
+
+void PBFTCacheProcessor::tryToBroadcastCertificates()
+{
+    if (!m_config->collectorMode())
+    {
+        return;
+    }
+    for (auto const& it : m_caches)
+    {
+        if (m_config->leaderIndex(it.first) != m_config->nodeIndex())
+        {
+            continue;
+        }
+        // Note: the prepare certificate must be broadcasted before the commit certificate
+        broadcastCertificate(it.second->generateCertificate(PacketType::PrepareCertificatePacket));
+        broadcastCertificate(it.second->generateCertificate(PacketType::CommitCertificatePacket));
+    }
+}
+
+void PBFTCacheProcessor::broadcastCertificate(PBFTMessageInterface::Ptr _certificate)
+{
+    if (!_certificate)
+    {
+        return;
+    }
+    auto encodedData = m_config->codec()->encode(_certificate, m_config->pbftMsgDefaultVersion());
+    m_config->frontService()->asyncSendMessageByNodeIDs(
+        ModuleID::PBFT, *(m_config->consensusNodeIDList()), ref(*encodedData));
+    PBFT_LOG(INFO) << LOG_DESC("broadcastCertificate") << printPBFTMsgInfo(_certificate)
+                   << LOG_KV("signatureSize",
+                          _certificate->consensusProposal()->signatureProofSize());
+}
+
+void PBFTCacheProcessor::checkCollectorTimeout()
+{
+    auto currentTime = utcTime();
+    for (auto it = m_collectorVoteTime.begin(); it != m_collectorVoteTime.end();)
+    {
+        auto index = it->first;
+        if (!m_caches.count(index) || m_caches[index]->submitted())
+        {
+            it = m_collectorVoteTime.erase(it);
+            continue;
+        }
+        if ((currentTime - it->second) < m_config->collectorTimeout())
+        {
+            it++;
+            continue;
+        }
+        // fallback to all-to-all broadcast for the proposal
+        m_collectorFallbackIndexes.insert(index);
+        auto localVotes = m_caches[index]->localVotes();
+        for (auto const& vote : localVotes)
+        {
+            auto encodedData = m_config->codec()->encode(vote, m_config->pbftMsgDefaultVersion());
+            m_config->frontService()->asyncSendMessageByNodeIDs(
+                ModuleID::PBFT, *(m_config->consensusNodeIDList()), ref(*encodedData));
+        }
+        PBFT_LOG(WARNING) << LOG_DESC(
+                                 "checkCollectorTimeout: broadcast the votes to all the nodes")
+                          << LOG_KV("index", index)
+                          << LOG_KV("collector", m_config->leaderIndex(index))
+                          << LOG_KV("votes", localVotes.size()) << m_config->printCurrentState();
+        it = m_collectorVoteTime.erase(it);
+    }
+}
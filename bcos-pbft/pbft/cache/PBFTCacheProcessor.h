@@ -52,6 +52,8 @@ public:
         PBFTProposalList const& _committedProposals, bcos::crypto::NodeIDPtr _fromNode);
 
     virtual void addPrePrepareCache(PBFTMessageInterface::Ptr _prePrepareMsg);
+    // the trusted path for the prePrepare message generated by the leader-self
+    virtual void addLocalPrePrepareCache(PBFTMessageInterface::Ptr _prePrepareMsg);
     virtual bool existPrePrepare(PBFTMessageInterface::Ptr _prePrepareMsg);
 
     virtual bool tryToFillProposal(PBFTMessageInterface::Ptr _prePrepareMsg);
@@ -66,6 +68,15 @@ public:
             });
     }
 
+    // the trusted path for the prepare message generated by the node-self
+    virtual void addLocalPrepareCache(PBFTMessageInterface::Ptr _prepareMsg)
+    {
+        addCache(m_caches, _prepareMsg,
+            [](PBFTCache::Ptr _pbftCache, PBFTMessageInterface::Ptr _prepareMsg) {
+                _pbftCache->addLocalPrepareCache(_prepareMsg);
+            });
+    }
+
     virtual void addCommitReq(PBFTMessageInterface::Ptr _commitReq)
     {
         addCache(m_caches, _commitReq,
@@ -162,6 +173,7 @@ public:
             return;
         }
         m_executingProposals.erase(_hash);
+        updateExecutionBacklog();
     }
 
     virtual size_t executingProposalSize() { return m_executingProposals.size(); }
@@ -172,6 +184,43 @@ public:
         m_onLoadAndVerifyProposalSucc = _onLoadAndVerifyProposalSucc;
     }
 
+    // the signed checkpoint proposals waiting for broadcast
+    virtual void addPendingCheckPoint(PBFTProposalInterface::Ptr _checkPointProposal)
+    {
+        m_pendingCheckPoints.push_back(_checkPointProposal);
+    }
+    size_t pendingCheckPointSize() const { return m_pendingCheckPoints.size(); }
+    // the number of the cached viewChange and their estimated memory(in bytes)
+    size_t viewChangeCacheCount() const { return m_viewChangeNodeView.size(); }
+    size_t viewChangeCacheSize() const { return m_viewChangeCacheSize; }
+    int64_t lastCheckPointFlushTime() const { return m_lastCheckPointFlushTime; }
+    virtual PBFTProposalList fetchPendingCheckPoints();
+    // attach the pending checkpoints to the outgoing prepare/commit message
+    virtual void piggybackCheckPoints(PBFTMessageInterface::Ptr _pbftMsg);
+    // whether the node will send prepare/commit message for the proposals in consensus
+    virtual bool existPendingVote();
+
+    // collect the consensus message to be broadcasted in batch, return false when batch disabled
+    virtual bool tryToBatchConsensusMsg(PBFTMessageInterface::Ptr _pbftMsg);
+    // broadcast the batched consensus messages when wait long enough or _enforce
+    virtual void flushBatchedConsensusMsg(bool _enforce = false);
+    // sign the batch of _batchedMsgs and send it to _receivers
+    virtual void sendBatchedConsensusMsg(PacketType _packetType,
+        PBFTMessageList const& _batchedMsgs, bcos::crypto::NodeIDs const& _receivers);
+    // the digest of the packetType, view and entries of the batch, signed as the batch hash
+    virtual bcos::crypto::HashType calculateBatchDigest(PBFTMessageInterface::Ptr _batchMsg);
+    size_t batchedConsensusMsgSize() const { return m_batchedConsensusMsgSize; }
+
+    // the receivers of the prepare/commit message, only the collector in collector mode
+    virtual bcos::crypto::NodeIDs voteReceivers(bcos::protocol::BlockNumber _index);
+    // the collector broadcasts the certificates of the proposals with enough votes
+    virtual void tryToBroadcastCertificates();
+    // check the quorum of the votes in the certificate, the prepare votes sign the proposal hash
+    // and the commit votes sign the digest bound to the phase and view
+    virtual bool checkCertificate(PBFTMessageInterface::Ptr _certificate);
+    // broadcast the local votes to all the nodes when the certificate timeout
+    virtual void checkCollectorTimeout();
+
     virtual void addRecoverReqCache(PBFTMessageInterface::Ptr _recoverResponse);
     virtual bool checkAndTryToRecover();
 
@@ -201,12 +250,28 @@ protected:
 
     PBFTMessageList generatePrePrepareMsg(
         std::map<IndexType, ViewChangeMsgInterface::Ptr> _viewChangeCache);
-    void reCalculateViewChangeWeight();
     void removeInvalidRecoverCache(ViewType _view);
+    void updateViewChangeIndexes(ViewType _view, ViewChangeMsgInterface::Ptr _viewChange);
+    // remove the viewChange of the given node from the cache
+    void removeViewChangeReq(ViewType _view, IndexType _nodeIndex);
+    // deduct the weight and the size of the viewChange removed from m_viewChangeCache
+    void evictViewChangeReq(ViewType _view, IndexType _nodeIndex);
+    // drop the payloads of the prepared proposals that are already in the local precommit cache
+    void stripPreparedProposalData(ViewChangeMsgInterface::Ptr _viewChange);
+    // the estimated memory(in bytes) of the cached viewChange
+    size_t viewChangeReqSize(ViewChangeMsgInterface::Ptr _viewChange);
 
     virtual void notifyToSealNextBlock(PBFTProposalInterface::Ptr _checkpointProposal);
+    virtual void broadcastCertificate(PBFTMessageInterface::Ptr _certificate);
 
     void notifyMaxProposalIndex(bcos::protocol::BlockNumber _proposalIndex);
+    // register the handlers of the newly created cache
+    virtual void initCache(PBFTCache::Ptr _cache);
+    // report the execution backlog to the config for the sealer back-pressure
+    virtual void updateExecutionBacklog()
+    {
+        m_config->setExecutionBacklog(m_committedQueue.size() + m_executingProposals.size());
+    }
 
 protected:
     PBFTCacheFactory::Ptr m_cacheFactory;
@@ -217,7 +282,18 @@ protected:
     using ViewChangeCacheType =
         std::map<ViewType, std::map<IndexType, ViewChangeMsgInterface::Ptr>>;
     ViewChangeCacheType m_viewChangeCache;
+    // the running weight of every view, updated when the viewChange is cached or evicted
     std::map<ViewType, uint64_t> m_viewChangeWeight;
+    struct CachedViewChange
+    {
+        ViewType view;
+        uint64_t weight;
+        size_t size;
+    };
+    // the cached viewChange of every node, only the highest view is cached
+    std::map<IndexType, CachedViewChange> m_viewChangeNodeView;
+    size_t m_viewChangeCacheSize = 0;
+    const size_t c_viewChangeReqOverhead = 256;
     // only needed for viewchange
     std::map<ViewType, int64_t> m_maxCommittedIndex;
     std::map<ViewType, int64_t> m_maxPrecommitIndex;
@@ -246,6 +322,19 @@ protected:
     std::map<ViewType, uint64_t> m_recoverCacheWeight;
 
     bcos::protocol::BlockNumber m_maxNotifyIndex = 0;
+
+    PBFTProposalList m_pendingCheckPoints;
+    int64_t m_lastCheckPointFlushTime = 0;
+
+    // the consensus messages waiting to be broadcasted in batch
+    std::map<PacketType, PBFTMessageList> m_batchedConsensusMsgs;
+    std::atomic<size_t> m_batchedConsensusMsgSize = {0};
+    int64_t m_batchStartTime = 0;
+
+    // the time of the latest vote sent to the collector, indexed by the proposal index
+    std::map<bcos::protocol::BlockNumber, int64_t> m_collectorVoteTime;
+    // the proposals fallback to all-to-all broadcast for the collector timeout
+    std::set<bcos::protocol::BlockNumber> m_collectorFallbackIndexes;
 };
 }  // namespace consensus
 }  // namespace bcos
\ No newline at end of file
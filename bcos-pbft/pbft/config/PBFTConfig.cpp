@@ -48,13 +48,26 @@ void PBFTConfig::resetConfig(LedgerConfig::Ptr _ledgerConfig, bool _syncedBlock)
     committedProposal->setIndex(_ledgerConfig->blockNumber());
     committedProposal->setHash(_ledgerConfig->hash());
     setCommittedProposal(committedProposal);
-    // set blockTxCountLimit
-    setBlockTxCountLimit(_ledgerConfig->blockTxCountLimit());
-    // set ConsensusNodeList
-    auto& consensusList = _ledgerConfig->mutableConsensusNodeList();
-    setConsensusNodeList(consensusList);
-    // set leader_period
-    setLeaderSwitchPeriod(_ledgerConfig->leaderSwitchPeriod());
+    // the steady state: only advance the committed proposal
+    auto ledgerConfigChanged = ledgerConfigUpdated(_ledgerConfig);
+    if (ledgerConfigChanged)
+    {
+        // set blockTxCountLimit
+        setBlockTxCountLimit(_ledgerConfig->blockTxCountLimit());
+        // set ConsensusNodeList
+        setConsensusNodeList(_ledgerConfig->mutableConsensusNodeList());
+        // set leader_period
+        setLeaderSwitchPeriod(_ledgerConfig->leaderSwitchPeriod());
+        // the latencies are recorded by the index of the leader
+        if (m_nodeUpdated)
+        {
+            m_timeoutEstimator->reset();
+        }
+    }
+    else
+    {
+        m_nodeUpdated = false;
+    }
     // reset the timer
     resetTimer();
 
@@ -68,7 +81,12 @@ void PBFTConfig::resetConfig(LedgerConfig::Ptr _ledgerConfig, bool _syncedBlock)
                        << LOG_KV("txs", _ledgerConfig->txsSize()) << printCurrentState();
     }
     // notify the txpool validator to update the consensusNodeList.
-    m_validator->updateValidatorConfig(consensusList, _ledgerConfig->observerNodeList());
+    if (ledgerConfigChanged)
+    {
+        m_observerNodeList = _ledgerConfig->observerNodeList();
+        m_validator->updateValidatorConfig(
+            _ledgerConfig->mutableConsensusNodeList(), m_observerNodeList);
+    }
 
     // notify the latest block number to the sealer
     if (m_stateNotifier)
@@ -115,10 +133,38 @@ void PBFTConfig::resetConfig(LedgerConfig::Ptr _ledgerConfig, bool _syncedBlock)
                            << LOG_KV("notifyBeginIndex", notifyBeginIndex) << printCurrentState();
             reNotifySealer(notifyBeginIndex);
         }
+        // the committed proposal drains the commit backlog
+        tryToResumeSealing();
         notifySealer(sealStartIndex());
     }
 }
 
+bool PBFTConfig::ledgerConfigUpdated(LedgerConfig::Ptr _ledgerConfig)
+{
+    if (_ledgerConfig->blockTxCountLimit() != blockTxCountLimit() ||
+        _ledgerConfig->leaderSwitchPeriod() != m_leaderSwitchPeriod)
+    {
+        return true;
+    }
+    // Note: the order of the node list is not required to be the same with the snapshot
+    auto snapshot = nodeSnapshot();
+    auto const& consensusNodeList = _ledgerConfig->mutableConsensusNodeList();
+    // the consensus node list has never been set
+    if (snapshot->epoch() == 0 || consensusNodeList.size() != snapshot->size())
+    {
+        return true;
+    }
+    for (auto const& node : consensusNodeList)
+    {
+        auto nodeIndex = snapshot->nodeIndex(node->nodeID()->data());
+        if (nodeIndex == NON_CONSENSUS_NODE || snapshot->weight(nodeIndex) != node->weight())
+        {
+            return true;
+        }
+    }
+    return !compareConsensusNode(_ledgerConfig->observerNodeList(), m_observerNodeList);
+}
+
 void PBFTConfig::notifyResetSealing(std::function<void()> _callback)
 {
     if (!m_sealerResetNotifier)
@@ -262,6 +308,33 @@ void PBFTConfig::notifySealer(BlockNumber _progressedIndex, bool _enforce)
                        << LOG_KV("maxTxsToSeal", blockTxCountLimit()) << printCurrentState();
         return;
     }
+    // defer sealing when the execution or the ledger commit falls behind
+    auto stallReason = checkBackPressure();
+    {
+        std::lock_guard<std::mutex> l(x_sealStall);
+        if (stallReason != SealStallReason::NoStall)
+        {
+            if (m_sealStallReason == SealStallReason::NoStall ||
+                _progressedIndex < m_stalledSealIndex)
+            {
+                m_stalledSealIndex = _progressedIndex;
+            }
+            m_sealStallReason = stallReason;
+        }
+        else
+        {
+            m_sealStallReason = SealStallReason::NoStall;
+        }
+    }
+    if (stallReason != SealStallReason::NoStall)
+    {
+        PBFT_LOG(INFO) << LOG_DESC("notifySealer: defer sealing for back-pressure")
+                       << LOG_KV("reason", sealStallReasonDesc(stallReason))
+                       << LOG_KV("executionBacklog", m_executionBacklog)
+                       << LOG_KV("commitBacklog", commitBacklog())
+                       << LOG_KV("stalledSealIndex", m_stalledSealIndex) << printCurrentState();
+        return;
+    }
     int64_t endProposalIndex =
         (_progressedIndex / m_leaderSwitchPeriod + 1) * m_leaderSwitchPeriod - 1;
     // Note: the valid proposal index range should be [max(lowWaterMark, committedIndex+1,
@@ -305,6 +378,59 @@ void PBFTConfig::notifySealer(BlockNumber _progressedIndex, bool _enforce)
                    << LOG_KV("maxTxsToSeal", blockTxCountLimit()) << printCurrentState();
 }
 
+size_t PBFTConfig::commitBacklog()
+{
+    auto committedIndex = committedProposal()->index();
+    auto executedIndex = m_expectedCheckPoint - 1;
+    if (executedIndex <= committedIndex)
+    {
+        return 0;
+    }
+    return (executedIndex - committedIndex);
+}
+
+SealStallReason PBFTConfig::checkBackPressure()
+{
+    if (m_maxExecutionBacklog > 0 && m_executionBacklog >= m_maxExecutionBacklog)
+    {
+        return SealStallReason::ExecutionBacklog;
+    }
+    if (m_maxCommitBacklog > 0 && commitBacklog() >= m_maxCommitBacklog)
+    {
+        return SealStallReason::CommitBacklog;
+    }
+    return SealStallReason::NoStall;
+}
+
+void PBFTConfig::tryToResumeSealing()
+{
+    if (m_sealStallReason == SealStallReason::NoStall)
+    {
+        return;
+    }
+    if (checkBackPressure() != SealStallReason::NoStall)
+    {
+        return;
+    }
+    SealStallReason stallReason;
+    BlockNumber resumeIndex;
+    {
+        std::lock_guard<std::mutex> l(x_sealStall);
+        stallReason = m_sealStallReason;
+        // resumed by the other thread
+        if (stallReason == SealStallReason::NoStall)
+        {
+            return;
+        }
+        resumeIndex = std::max(m_stalledSealIndex.load(), sealStartIndex());
+        m_sealStallReason = SealStallReason::NoStall;
+    }
+    PBFT_LOG(INFO) << LOG_DESC("tryToResumeSealing: the backlog drained, resume sealing")
+                   << LOG_KV("stallReason", sealStallReasonDesc(stallReason))
+                   << LOG_KV("resumeIndex", resumeIndex) << printCurrentState();
+    notifySealer(resumeIndex);
+}
+
 void PBFTConfig::asyncNotifySealProposal(
     size_t _proposalIndex, size_t _proposalEndIndex, size_t _maxTxsToSeal, size_t _retryTime)
 {
@@ -355,15 +481,38 @@ uint64_t PBFTConfig::minRequiredQuorum() const
 
 void PBFTConfig::updateQuorum()
 {
-    m_totalQuorum.store(0);
-    ReadGuard l(x_consensusNodeList);
-    for (auto consensusNode : *m_consensusNodeList)
+    // the quorum has been precomputed by the snapshot
+    auto snapshot = nodeSnapshot();
+    m_totalQuorum.store(snapshot->totalWeight());
+    m_maxFaultyQuorum = snapshot->maxFaultyQuorum();
+    m_minRequiredQuorum = snapshot->minRequiredQuorum();
+}
+
+void PBFTConfig::updateConsensusTimeout()
+{
+    // Note: the running timer is only restarted when the timeout changed
+    if (m_consensusNodeNum == 0)
+    {
+        m_timer->reset(m_timeoutEstimator->maxTimeout());
+        return;
+    }
+    m_timer->reset(m_timeoutEstimator->timeout(getLeader()));
+}
+
+void PBFTConfig::updateConsensusLatency(IndexType _leaderIndex)
+{
+    auto progressTime = m_progressTime.load();
+    markConsensusProgress();
+    auto currentTime = m_progressTime.load();
+    if (progressTime == 0 || currentTime < progressTime)
     {
-        m_totalQuorum += consensusNode->weight();
+        return;
     }
-    // get m_maxFaultyQuorum
-    m_maxFaultyQuorum = (m_totalQuorum - 1) / 3;
-    m_minRequiredQuorum = m_totalQuorum - m_maxFaultyQuorum;
+    auto latency = currentTime - progressTime;
+    m_timeoutEstimator->updateLatency(_leaderIndex, latency);
+    PBFT_LOG(DEBUG) << LOG_DESC("updateConsensusLatency") << LOG_KV("leader", _leaderIndex)
+                    << LOG_KV("latency", latency)
+                    << LOG_KV("timeout", m_timeoutEstimator->estimatedTimeout(_leaderIndex));
 }
 
 IndexType PBFTConfig::leaderIndex(BlockNumber _proposalIndex)
@@ -388,6 +537,27 @@ IndexType PBFTConfig::leaderIndexInNewViewPeriod(
     return (_proposalIndex / m_leaderSwitchPeriod + _view) % m_consensusNodeNum;
 }
 
+bcos::crypto::HashType PBFTConfig::voteSignatureHash(PacketType _packetType, ViewType _view,
+    BlockNumber _index, bcos::crypto::HashType const& _hash, int32_t _version)
+{
+    if (_packetType != PacketType::CommitPacket || _version < c_commitVoteDigestVersion)
+    {
+        return _hash;
+    }
+    bytes digestData;
+    auto appendValue = [&digestData](int64_t _value) {
+        for (int i = 7; i >= 0; i--)
+        {
+            digestData.push_back((byte)(((uint64_t)_value >> (8 * i)) & 0xff));
+        }
+    };
+    appendValue(_packetType);
+    appendValue(_view);
+    appendValue(_index);
+    digestData.insert(digestData.end(), _hash.data(), _hash.data() + bcos::crypto::HashType::size);
+    return m_cryptoSuite->hashImpl()->hash(digestData);
+}
+
 PBFTProposalInterface::Ptr PBFTConfig::populateCommittedProposal()
 {
     ReadGuard l(x_committedProposal);
@@ -416,6 +586,7 @@ std::string PBFTConfig::printCurrentState()
                  << LOG_KV("unsealedTxs", m_unsealedTxsSize.load())
                  << LOG_KV("sealUntil", m_waitSealUntil)
                  << LOG_KV("waitResealUntil", m_waitResealUntil)
+                 << LOG_KV("sealStall", sealStallReasonDesc(m_sealStallReason))
                  << LOG_KV("nodeId", nodeID()->shortHex());
     return stringstream.str();
 }
\ No newline at end of file
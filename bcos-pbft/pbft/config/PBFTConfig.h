@@ -22,6 +22,9 @@
 #include "bcos-pbft/core/ConsensusConfig.h"
 #include "bcos-pbft/framework/StateMachineInterface.h"
 #include "bcos-pbft/pbft/engine/PBFTTimer.h"
+#include "bcos-pbft/pbft/engine/PublicKeyCache.h"
+#include "bcos-pbft/pbft/engine/SignatureProofVerifier.h"
+#include "bcos-pbft/pbft/engine/TimeoutEstimator.h"
 #include "bcos-pbft/pbft/engine/Validator.h"
 #include "bcos-pbft/pbft/interfaces/PBFTCodecInterface.h"
 #include "bcos-pbft/pbft/interfaces/PBFTMessageFactory.h"
@@ -54,7 +57,13 @@ public:
         m_frontService = _frontService;
         m_stateMachine = _stateMachine;
         m_storage = _storage;
-        m_timer = std::make_shared<PBFTTimer>(consensusTimeout());
+        // all the timers of the consensus engine and the caches are triggered by the wheel
+        m_timerWheel = std::make_shared<TimerWheel>("pbftTimer");
+        m_timer = std::make_shared<PBFTTimer>(m_timerWheel, consensusTimeout());
+        m_timeoutEstimator = std::make_shared<TimeoutEstimator>(consensusTimeout());
+        m_publicKeyCache = std::make_shared<PublicKeyCache>(
+            std::make_shared<DefaultParsedPublicKeyFactory>(m_cryptoSuite->signatureImpl()));
+        m_signatureProofVerifier = std::make_shared<SignatureProofVerifier>(m_publicKeyCache);
     }
 
     ~PBFTConfig() override {}
@@ -109,6 +118,32 @@ public:
     std::shared_ptr<PBFTMessageFactory> pbftMessageFactory() { return m_pbftMessageFactory; }
     std::shared_ptr<bcos::front::FrontServiceInterface> frontService() { return m_frontService; }
     std::shared_ptr<PBFTCodecInterface> codec() { return m_codec; }
+    // verify the signature proofs of the precommit and checkpoint proposals
+    SignatureProofVerifier::Ptr signatureProofVerifier() { return m_signatureProofVerifier; }
+    // the public keys of the consensus nodes parsed once for the signature verification
+    PublicKeyCache::Ptr publicKeyCache() { return m_publicKeyCache; }
+    void setParsedPublicKeyFactory(ParsedPublicKeyFactory::Ptr _factory)
+    {
+        m_publicKeyCache->setFactory(_factory);
+        m_publicKeyCache->update(*(consensusNodeIDList(false)));
+    }
+
+    // the consensus messages are parked in the msgQueue until the state recovered from the storage
+    bool stateRecovering() const { return m_stateRecovering; }
+    void setStateRecovering(bool _stateRecovering) { m_stateRecovering = _stateRecovering; }
+    // the engine is stopped since the state can't be recovered
+    bool stateRecoverFailed() const { return m_stateRecoverFailed; }
+    void setStateRecoverFailed(bool _stateRecoverFailed)
+    {
+        m_stateRecoverFailed = _stateRecoverFailed;
+    }
+
+    // the max data size(in bytes) of the committed proposals responded to one request
+    uint64_t maxCommittedResponseSize() const { return m_maxCommittedResponseSize; }
+    void setMaxCommittedResponseSize(uint64_t _maxCommittedResponseSize)
+    {
+        m_maxCommittedResponseSize = _maxCommittedResponseSize;
+    }
 
     PBFTProposalInterface::Ptr populateCommittedProposal();
     unsigned pbftMsgDefaultVersion() const { return c_pbftMsgDefaultVersion; }
@@ -122,12 +157,23 @@ public:
     void setLowWaterMark(bcos::protocol::BlockNumber _index) { m_lowWaterMark = _index; }
 
     PBFTTimer::Ptr timer() { return m_timer; }
+    TimerWheel::Ptr timerWheel() { return m_timerWheel; }
 
     void setConsensusTimeout(uint64_t _consensusTimeout) override
     {
         ConsensusConfig::setConsensusTimeout(_consensusTimeout);
-        m_timer->reset(_consensusTimeout);
+        // the configured timeout is the upper bound of the adaptive timeout
+        m_timeoutEstimator->setMaxTimeout(_consensusTimeout);
+        updateConsensusTimeout();
     }
+    TimeoutEstimator::Ptr timeoutEstimator() { return m_timeoutEstimator; }
+    // reset the timeout of the timer to the estimated timeout of the current leader
+    virtual void updateConsensusTimeout();
+    // sample the interval from the last progress to committing the proposal of the given leader,
+    // which is covered by the timer and includes the sealing of the leader
+    virtual void updateConsensusLatency(IndexType _leaderIndex);
+    // the consensus made progress or woke up from idle, the start of the next latency sample
+    void markConsensusProgress() { m_progressTime = utcTime(); }
 
     void setCommittedProposal(ProposalInterface::Ptr _committedProposal) override
     {
@@ -164,6 +210,75 @@ public:
         m_checkPointTimeoutInterval = _timeoutInterval;
     }
 
+    // broadcast one range checkpoint message every checkPointInterval executed proposals
+    int64_t checkPointInterval() const { return m_checkPointInterval; }
+    void setCheckPointInterval(int64_t _checkPointInterval)
+    {
+        m_checkPointInterval = std::max((int64_t)1, _checkPointInterval);
+    }
+    // the max time(ms) an executed proposal waits before its checkpoint being broadcasted
+    int64_t maxCheckPointDelay() const { return m_maxCheckPointDelay; }
+    void setMaxCheckPointDelay(int64_t _maxCheckPointDelay)
+    {
+        m_maxCheckPointDelay = _maxCheckPointDelay;
+    }
+
+    // piggyback the checkpoints of the executed proposals on the next prepare/commit message
+    bool piggybackCheckPoint() const { return m_piggybackCheckPoint; }
+    void setPiggybackCheckPoint(bool _piggybackCheckPoint)
+    {
+        m_piggybackCheckPoint = _piggybackCheckPoint;
+    }
+
+    // broadcast the PrePrepare/Prepare/Commit messages of consecutive proposals in batch
+    bool batchConsensusMsg() const { return m_batchConsensusMsg; }
+    void setBatchConsensusMsg(bool _batchConsensusMsg) { m_batchConsensusMsg = _batchConsensusMsg; }
+    // the max time(ms) a consensus message waits in the batch
+    int64_t consensusMsgBatchDelay() const { return m_consensusMsgBatchDelay; }
+    void setConsensusMsgBatchDelay(int64_t _batchDelay) { m_consensusMsgBatchDelay = _batchDelay; }
+
+    // send the prepare/commit messages to the collector(leader of the proposal) only, the collector
+    // broadcasts the quorum certificate after collecting enough votes
+    bool collectorMode() const { return m_collectorMode; }
+    void setCollectorMode(bool _collectorMode) { m_collectorMode = _collectorMode; }
+    // the max time(ms) waiting for the certificate before broadcasting the votes to all the nodes
+    int64_t collectorTimeout() const { return m_collectorTimeout; }
+    void setCollectorTimeout(int64_t _collectorTimeout) { m_collectorTimeout = _collectorTimeout; }
+    // encode the NewView messages with the certificate table, only enabled after all the consensus
+    // nodes are able to decode the table
+    bool newViewCertificateTable() const { return m_newViewCertificateTable; }
+    void setNewViewCertificateTable(bool _newViewCertificateTable)
+    {
+        m_newViewCertificateTable = _newViewCertificateTable;
+    }
+    int32_t newViewMsgVersion() const
+    {
+        return m_newViewCertificateTable ? c_newViewCertificateTableVersion :
+                                           (int32_t)c_pbftMsgDefaultVersion;
+    }
+    // sign the commit votes with the digest of the phase, view, index and hash, only enabled after
+    // all the consensus nodes are able to verify the digest
+    bool commitVoteDigest() const { return m_commitVoteDigest; }
+    void setCommitVoteDigest(bool _commitVoteDigest) { m_commitVoteDigest = _commitVoteDigest; }
+    int32_t voteMsgVersion() const
+    {
+        return m_commitVoteDigest ? c_commitVoteDigestVersion : (int32_t)c_pbftMsgDefaultVersion;
+    }
+
+    // the hash signed by the proposal signature of the PrePrepare/Prepare/Commit message
+    // Note: the commit vote of c_commitVoteDigestVersion signs the digest of the phase, view, index
+    // and hash, which differs from the proposal hash signed by the prepare vote (the proof of the
+    // precommit proposal), so that the votes can't be relabelled or replayed in another view by the
+    // batches or certificates; the votes of the older versions sign the proposal hash
+    virtual bcos::crypto::HashType voteSignatureHash(PacketType _packetType, ViewType _view,
+        bcos::protocol::BlockNumber _index, bcos::crypto::HashType const& _hash,
+        int32_t _version);
+    bcos::crypto::HashType voteSignatureHash(PBFTMessageInterface::Ptr _vote)
+    {
+        return voteSignatureHash((PacketType)_vote->packetType(), _vote->view(), _vote->index(),
+            _vote->hash(), _vote->version());
+    }
+
     void resetToView()
     {
         m_toView.store(m_view);
@@ -174,6 +289,31 @@ public:
 
     virtual void notifySealer(bcos::protocol::BlockNumber _progressedIndex, bool _enforce = false);
     virtual void reNotifySealer(bcos::protocol::BlockNumber _index);
+
+    // the number of committed proposals waiting for or under execution, updated by the cache
+    virtual void setExecutionBacklog(size_t _executionBacklog)
+    {
+        m_executionBacklog = _executionBacklog;
+    }
+    virtual size_t executionBacklog() const { return m_executionBacklog; }
+    // the number of executed proposals that have not been committed to the ledger
+    virtual size_t commitBacklog();
+
+    // the back-pressure thresholds, 0 means disabled
+    size_t maxExecutionBacklog() const { return m_maxExecutionBacklog; }
+    void setMaxExecutionBacklog(size_t _maxExecutionBacklog)
+    {
+        m_maxExecutionBacklog = _maxExecutionBacklog;
+    }
+    size_t maxCommitBacklog() const { return m_maxCommitBacklog; }
+    void setMaxCommitBacklog(size_t _maxCommitBacklog) { m_maxCommitBacklog = _maxCommitBacklog; }
+
+    virtual SealStallReason sealStallReason() const { return m_sealStallReason; }
+    // re-notify the sealer the deferred seal range when the backlog drained
+    virtual void tryToResumeSealing();
+    // the local execution or ledger commit falls behind, the sealing is held back by the leader
+    // and the consensus timer should not trigger view change
+    virtual bool sealingHeldBack() { return checkBackPressure() != SealStallReason::NoStall; }
     virtual bool shouldResetConfig(bcos::protocol::BlockNumber _index)
     {
         ReadGuard l(x_committedProposal);
@@ -224,6 +364,7 @@ public:
         m_unsealedTxsSize = _unsealedTxsSize;
         if (m_unsealedTxsSize > 0 && !m_timer->running())
         {
+            markConsensusProgress();
             m_timer->start();
         }
     }
@@ -237,6 +378,7 @@ public:
 
     virtual void freshTimer()
     {
+        updateConsensusTimeout();
         if (m_unsealedTxsSize > 0)
         {
             m_timer->restart();
@@ -299,6 +441,7 @@ public:
         {
             return;
         }
+        m_publicKeyCache->update(*(consensusNodeIDList(false)));
         if (committedProposal())
         {
             notifyResetSealing(sealStartIndex());
@@ -348,6 +491,9 @@ public:
 
 protected:
     void updateQuorum() override;
+    // whether the consensus nodes, observer nodes or parameters differ from the applied ones
+    virtual bool ledgerConfigUpdated(bcos::ledger::LedgerConfig::Ptr _ledgerConfig);
+    virtual SealStallReason checkBackPressure();
     virtual void asyncNotifySealProposal(size_t _proposalIndex, size_t _proposalEndIndex,
         size_t _maxTxsToSeal, size_t _retryTime = 0);
 
@@ -357,6 +503,11 @@ protected:
     std::shared_ptr<PBFTMessageFactory> m_pbftMessageFactory;
     // Codec for serialization/deserialization of PBFT message packets
     std::shared_ptr<PBFTCodecInterface> m_codec;
+    // the signature list by default
+    SignatureProofVerifier::Ptr m_signatureProofVerifier;
+    PublicKeyCache::Ptr m_publicKeyCache;
+    // the observer nodes of the latest applied ledger config
+    ConsensusNodeList m_observerNodeList;
     // Proposal validator
     std::shared_ptr<ValidatorInterface> m_validator;
     // FrontService, used to send/receive P2P message packages
@@ -364,7 +515,11 @@ protected:
     StateMachineInterface::Ptr m_stateMachine;
     PBFTStorage::Ptr m_storage;
     // Timer
+    TimerWheel::Ptr m_timerWheel;
     PBFTTimer::Ptr m_timer;
+    TimeoutEstimator::Ptr m_timeoutEstimator;
+    // the time of the last progress, zero before the first progress
+    std::atomic<uint64_t> m_progressTime = {0};
     // notify the sealer seal Proposal
     std::function<void(size_t, size_t, size_t, std::function<void(Error::Ptr)>)>
         m_sealProposalNotifier;
@@ -390,8 +545,19 @@ protected:
 
     int64_t m_warterMarkLimit = 10;
     std::atomic<int64_t> m_checkPointTimeoutInterval = {3000};
+    // default to broadcast checkpoint for every executed proposal
+    std::atomic<int64_t> m_checkPointInterval = {1};
+    std::atomic<int64_t> m_maxCheckPointDelay = {1000};
+    std::atomic_bool m_piggybackCheckPoint = {false};
+    std::atomic_bool m_batchConsensusMsg = {false};
+    std::atomic<int64_t> m_consensusMsgBatchDelay = {10};
+    std::atomic_bool m_collectorMode = {false};
+    std::atomic<int64_t> m_collectorTimeout = {1000};
+    std::atomic_bool m_newViewCertificateTable = {false};
+    std::atomic_bool m_commitVoteDigest = {false};
 
     std::atomic<uint64_t> m_leaderSwitchPeriod = {1};
+    std::atomic<uint64_t> m_maxCommittedResponseSize = {4 * 1024 * 1024};
     const unsigned c_pbftMsgDefaultVersion = 0;
     const unsigned c_networkTimeoutInterval = 1000;
     // state variable that identifies whether has timed out
@@ -402,6 +568,8 @@ protected:
     std::atomic<bcos::protocol::BlockNumber> m_waitResealUntil = {0};
     // notify the ealer to seal new block until m_waitSealUntil committed
     std::atomic<bcos::protocol::BlockNumber> m_waitSealUntil = {0};
+    std::atomic_bool m_stateRecovering = {false};
+    std::atomic_bool m_stateRecoverFailed = {false};
 
     bcos::crypto::NodeIDSetPtr m_connectedNodeList;
     SharedMutex x_connectedNodeList;
@@ -409,6 +577,17 @@ protected:
     std::function<void()> m_fastViewChangeHandler;
 
     std::atomic_bool m_startRecovered = {false};
+
+    // back-pressure to the sealer
+    std::atomic<size_t> m_executionBacklog = {0};
+    // disabled by default, the waterMark already bounds the proposals in the pipeline
+    std::atomic<size_t> m_maxExecutionBacklog = {0};
+    std::atomic<size_t> m_maxCommitBacklog = {0};
+    std::atomic<SealStallReason> m_sealStallReason = {SealStallReason::NoStall};
+    // the proposal index deferred to notify the sealer for the back-pressure
+    std::atomic<bcos::protocol::BlockNumber> m_stalledSealIndex = {0};
+    // serialize the update of the stall reason and the stalled seal index
+    mutable std::mutex x_sealStall;
 };
 }  // namespace consensus
 }  // namespace bcos
@@ -94,7 +94,9 @@ bool BlockValidator::checkSealerListAndWeightList(Block::Ptr _block)
     // check the sealer list
     auto blockSealerList = blockHeader->sealerList();
     auto blockWeightList = blockHeader->consensusWeights();
-    auto consensusNodeList = m_config->consensusNodeList();
+    // Note: the snapshot is held until the whole sealer list is checked
+    auto snapshot = m_config->nodeSnapshot();
+    auto const& consensusNodeList = snapshot->consensusNodeList();
     if ((size_t)blockSealerList.size() != (size_t)consensusNodeList.size() ||
         (size_t)blockWeightList.size() != (size_t)consensusNodeList.size())
     {
@@ -140,34 +142,37 @@ bool BlockValidator::checkSealerListAndWeightList(Block::Ptr _block)
 
 bool BlockValidator::checkSignatureList(Block::Ptr _block)
 {
-    // check sign num
     // Note: for tars service, blockHeader must be here to ensure the signatureList
     auto blockHeader = _block->blockHeader();
+    // Note: the proofs reference the signatures, the signature list must be kept until verified
     auto signatureList = blockHeader->signatureList();
-    // check sign and weight
-    size_t signatureWeight = 0;
-    for (auto const& sign : signatureList)
+    std::vector<Signature> signatures(signatureList.begin(), signatureList.end());
+    SignatureProofList proofs;
+    for (auto const& sign : signatures)
     {
-        auto nodeIndex = sign.index;
-        auto nodeInfo = m_config->getConsensusNodeByIndex(nodeIndex);
-        if (!nodeInfo || !m_config->cryptoSuite()->signatureImpl()->verify(
-                             nodeInfo->nodeID(), blockHeader->hash(), ref(sign.signature)))
-        {
-            PBFT_LOG(ERROR) << LOG_DESC("checkBlock for sync module: checkSign failed")
-                            << LOG_KV("sealerIdx", nodeIndex)
-                            << LOG_KV("blockHash", blockHeader->hash().abridged())
-                            << LOG_KV("number", blockHeader->number());
-            return false;
-        }
-        signatureWeight += nodeInfo->weight();
+        proofs.push_back(std::make_pair(sign.index, ref(sign.signature)));
     }
-    if (signatureWeight < (size_t)m_config->minRequiredQuorum())
+    CertificateList certificates{std::make_pair(blockHeader->hash(), std::move(proofs))};
+    // check sign
+    std::vector<uint64_t> signatureWeights;
+    auto snapshot = m_config->nodeSnapshot();
+    if (!m_config->signatureProofVerifier()->batchVerifyProofs(
+            certificates, snapshot->consensusNodeList(), m_verifyPool, signatureWeights))
+    {
+        PBFT_LOG(ERROR) << LOG_DESC("checkBlock for sync module: checkSign failed")
+                        << LOG_KV("number", blockHeader->number())
+                        << LOG_KV("hash", blockHeader->hash().abridged());
+        return false;
+    }
+    // check weight
+    if (signatureWeights[0] < m_config->minRequiredQuorum())
     {
         PBFT_LOG(ERROR) << LOG_DESC("checkBlock for sync module: insufficient signatures")
-                        << LOG_KV("signNum", signatureList.size())
-                        << LOG_KV("sigWeight", signatureWeight)
+                        << LOG_KV("number", blockHeader->number())
+                        << LOG_KV("signNum", signatures.size())
+                        << LOG_KV("sigWeight", signatureWeights[0])
                         << LOG_KV("minRequiredQuorum", m_config->minRequiredQuorum());
         return false;
     }
     return true;
-}
\ No newline at end of file
+}
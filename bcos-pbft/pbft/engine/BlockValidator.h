@@ -30,8 +30,11 @@ class BlockValidator : public std::enable_shared_from_this<BlockValidator>
 {
 public:
     using Ptr = std::shared_ptr<BlockValidator>;
-    explicit BlockValidator(PBFTConfig::Ptr _config)
-      : m_config(_config), m_taskPool(std::make_shared<ThreadPool>("blockValidator", 1))
+    // _verifyPool: the signature verification pool shared with the engine
+    BlockValidator(PBFTConfig::Ptr _config, ThreadPool::Ptr _verifyPool)
+      : m_config(_config),
+        m_taskPool(std::make_shared<ThreadPool>("blockValidator", 1)),
+        m_verifyPool(_verifyPool)
     {}
     virtual ~BlockValidator() {}
 
@@ -48,11 +51,15 @@ public:
 
 protected:
     virtual bool checkSealerListAndWeightList(bcos::protocol::Block::Ptr _block);
+    // verify the signature list in parallel, fail fast on the first invalid signature and check
+    // the consensus weight after verification
     virtual bool checkSignatureList(bcos::protocol::Block::Ptr _block);
 
 private:
     PBFTConfig::Ptr m_config;
     ThreadPool::Ptr m_taskPool;
+    // the signatures of the block are verified concurrently, owned by the engine
+    ThreadPool::Ptr m_verifyPool;
 };
 }  // namespace consensus
 }  // namespace bcos
\ No newline at end of file
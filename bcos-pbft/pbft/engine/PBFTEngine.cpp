@@ -25,6 +25,7 @@
 #include <bcos-framework/interfaces/protocol/Protocol.h>
 #include <bcos-framework/libutilities/ThreadPool.h>
 #include <boost/bind/bind.hpp>
+#include <thread>
 using namespace bcos;
 using namespace bcos::consensus;
 using namespace bcos::ledger;
@@ -36,11 +37,13 @@ PBFTEngine::PBFTEngine(PBFTConfig::Ptr _config)
   : ConsensusEngine("pbft", 0),
     m_config(_config),
     m_worker(std::make_shared<ThreadPool>("pbftWorker", 1)),
+    m_verifyPool(std::make_shared<ThreadPool>(
+        "sigVerifier", std::min(std::max(std::thread::hardware_concurrency(), 1u), 4u))),
     m_msgQueue(std::make_shared<PBFTMsgQueue>())
 {
     auto cacheFactory = std::make_shared<PBFTCacheFactory>();
     m_cacheProcessor = std::make_shared<PBFTCacheProcessor>(cacheFactory, _config);
-    m_logSync = std::make_shared<PBFTLogSync>(m_config, m_cacheProcessor);
+    m_logSync = std::make_shared<PBFTLogSync>(m_config, m_cacheProcessor, m_verifyPool);
     // register the timeout function
     m_config->timer()->registerTimeoutHandler(boost::bind(&PBFTEngine::onTimeout, this));
     m_config->storage()->registerFinalizeHandler(boost::bind(
@@ -97,7 +100,144 @@ void PBFTEngine::start()
 {
     ConsensusEngine::start();
     // when the node setup, start the timer for view recovery
+    // Note: the timer is started by asyncRecoverState when the state is recovering
+    if (!m_config->stateRecovering())
+    {
+        m_config->timer()->start();
+    }
+}
+
+void PBFTEngine::asyncRecoverState(
+    BlockNumber _stabledIndex, std::function<void(Error::Ptr)> _onRecovered)
+{
+    m_config->setStateRecovering(true);
+    auto context = std::make_shared<RecoverStateContext>();
+    context->stabledIndex = _stabledIndex;
+    context->onRecovered = _onRecovered;
+    context->startTime = utcTime();
+    // the storage may never respond
+    auto self = std::weak_ptr<PBFTEngine>(shared_from_this());
+    context->timeoutTimer =
+        m_config->timerWheel()->schedule(m_recoverStateTimeout.load(), [self, context]() {
+            auto engine = self.lock();
+            if (!engine)
+            {
+                return;
+            }
+            engine->onRecoverStateFailed(context,
+                std::make_shared<Error>(PBFTErrorCode::RecoverStateTimeout,
+                    "recover the state timeout"));
+        });
+    tryToRecoverState(context);
+}
+
+void PBFTEngine::tryToRecoverState(RecoverStateContext::Ptr _context)
+{
+    auto self = std::weak_ptr<PBFTEngine>(shared_from_this());
+    m_config->storage()->asyncLoadState(_context->stabledIndex,
+        [self, _context](Error::Ptr _error, PBFTProposalListPtr _stateProposals) {
+            auto engine = self.lock();
+            if (!engine || _context->finished)
+            {
+                return;
+            }
+            if (_error)
+            {
+                engine->onLoadStateFailed(_context, _error);
+                return;
+            }
+            try
+            {
+                engine->onRecoverStateLoaded(_context, _stateProposals);
+            }
+            catch (std::exception const& e)
+            {
+                PBFT_LOG(WARNING) << LOG_DESC("asyncRecoverState exception")
+                                  << LOG_KV("error", boost::diagnostic_information(e));
+                engine->onRecoverStateFailed(_context,
+                    std::make_shared<Error>(
+                        PBFTErrorCode::StorageException, boost::diagnostic_information(e)));
+            }
+        });
+}
+
+void PBFTEngine::onRecoverStateLoaded(
+    RecoverStateContext::Ptr _context, PBFTProposalListPtr _stateProposals)
+{
+    RecursiveGuard l(m_mutex);
+    if (_context->finished.exchange(true))
+    {
+        return;
+    }
+    m_config->timerWheel()->cancel(_context->timeoutTimer);
+    if (_stateProposals && _stateProposals->size() > 0)
+    {
+        initState(*_stateProposals, m_config->keyPair()->publicKey());
+        auto lowWaterMark = _stateProposals->back()->index();
+        m_config->setLowWaterMark(lowWaterMark + 1);
+        PBFT_LOG(INFO) << LOG_DESC("init PBFT state")
+                       << LOG_KV("stateProposals", _stateProposals->size())
+                       << LOG_KV("lowWaterMark", lowWaterMark)
+                       << LOG_KV("highWaterMark", m_config->highWaterMark());
+    }
+    m_config->setStateRecovering(false);
     m_config->timer()->start();
+    // handle the parked messages
+    m_signalled.notify_all();
+    PBFT_LOG(INFO) << LOG_DESC("asyncRecoverState success")
+                   << LOG_KV("retryTime", _context->retryTime)
+                   << LOG_KV("timecost", utcTime() - _context->startTime);
+    if (_context->onRecovered)
+    {
+        _context->onRecovered(nullptr);
+    }
+}
+
+void PBFTEngine::onLoadStateFailed(RecoverStateContext::Ptr _context, Error::Ptr _error)
+{
+    auto backoff = m_recoverStateRetryInterval.load() << _context->retryTime;
+    PBFT_LOG(WARNING) << LOG_DESC("asyncRecoverState failed")
+                      << LOG_KV("code", _error->errorCode())
+                      << LOG_KV("msg", _error->errorMessage())
+                      << LOG_KV("retryTime", _context->retryTime) << LOG_KV("backoff", backoff);
+    if (_context->retryTime >= c_maxRecoverStateRetryTime ||
+        (utcTime() - _context->startTime + backoff) >= m_recoverStateTimeout)
+    {
+        onRecoverStateFailed(_context, _error);
+        return;
+    }
+    _context->retryTime++;
+    auto self = std::weak_ptr<PBFTEngine>(shared_from_this());
+    m_config->timerWheel()->schedule(backoff, [self, _context]() {
+        auto engine = self.lock();
+        if (!engine || _context->finished)
+        {
+            return;
+        }
+        engine->tryToRecoverState(_context);
+    });
+}
+
+void PBFTEngine::onRecoverStateFailed(RecoverStateContext::Ptr _context, Error::Ptr _error)
+{
+    if (_context->finished.exchange(true))
+    {
+        return;
+    }
+    m_config->timerWheel()->cancel(_context->timeoutTimer);
+    // Note: the node can't participate in the consensus without the committed proposals, stop the
+    // engine instead of parking the received messages forever
+    PBFT_LOG(ERROR) << LOG_DESC("asyncRecoverState failed, stop the PBFTEngine")
+                    << LOG_KV("code", _error->errorCode())
+                    << LOG_KV("msg", _error->errorMessage())
+                    << LOG_KV("retryTime", _context->retryTime)
+                    << LOG_KV("timecost", utcTime() - _context->startTime);
+    m_config->setStateRecoverFailed(true);
+    stop();
+    if (_context->onRecovered)
+    {
+        _context->onRecovered(_error);
+    }
 }
 
 void PBFTEngine::stop()
@@ -117,6 +257,10 @@ void PBFTEngine::stop()
     {
         m_logSync->stop();
     }
+    if (m_verifyPool)
+    {
+        m_verifyPool->stop();
+    }
     if (m_config)
     {
         m_config->stop();
@@ -159,30 +303,192 @@ void PBFTEngine::onProposalApplyFailed(PBFTProposalInterface::Ptr _proposal)
 void PBFTEngine::onProposalApplySuccess(
     PBFTProposalInterface::Ptr _proposal, PBFTProposalInterface::Ptr _executedProposal)
 {
+    {
+        // Note: must lock here to ensure thread safe
+        RecursiveGuard l(m_mutex);
+        // restart the timer when proposal execute finished to in case of timeout
+        if (m_config->timer()->running())
+        {
+            m_config->timer()->restart();
+        }
+        // apply the next committed proposal without waiting for the storage
+        m_cacheProcessor->setCheckPointProposal(_executedProposal);
+        m_config->setExpectedCheckPoint(_executedProposal->index() + 1);
+        m_cacheProcessor->tryToApplyCommitQueue();
+        m_cacheProcessor->eraseExecutedProposal(_proposal->hash());
+    }
+    // resume sealing if the proposal execution drains the backlog
+    m_config->tryToResumeSealing();
     // commit the proposal when execute success
-    m_config->storage()->asyncCommitProposal(_proposal);
+    // Note: the checkpoint of the proposal is broadcasted after the proposal is durable, in case
+    // of the committed proposal lost after crash while other nodes have acted on its checkpoint
+    auto self = std::weak_ptr<PBFTEngine>(shared_from_this());
+    m_config->storage()->asyncCommitProposal(
+        _proposal, [self, _proposal, _executedProposal](Error::Ptr _error) {
+            try
+            {
+                auto engine = self.lock();
+                if (!engine)
+                {
+                    return;
+                }
+                // the storage retries the failed writes until success, the error means that the
+                // storage has been released
+                if (_error)
+                {
+                    PBFT_LOG(ERROR) << LOG_DESC("commit proposal failed, skip the checkpoint")
+                                    << LOG_KV("code", _error->errorCode())
+                                    << LOG_KV("msg", _error->errorMessage())
+                                    << printPBFTProposal(_proposal);
+                    return;
+                }
+                engine->onProposalPersisted(_proposal, _executedProposal);
+            }
+            catch (std::exception const& e)
+            {
+                PBFT_LOG(WARNING) << LOG_DESC("onProposalPersisted exception")
+                                  << printPBFTProposal(_proposal)
+                                  << LOG_KV("error", boost::diagnostic_information(e));
+            }
+        });
+}
 
-    // broadcast checkpoint message
+void PBFTEngine::onProposalPersisted(
+    PBFTProposalInterface::Ptr, PBFTProposalInterface::Ptr _executedProposal)
+{
+    // generate checkpoint message
     auto checkPointMsg = m_config->pbftMessageFactory()->populateFrom(PacketType::CheckPoint,
         m_config->pbftMsgDefaultVersion(), m_config->view(), utcTime(), m_config->nodeIndex(),
         _executedProposal, m_config->cryptoSuite(), m_config->keyPair(), true);
+    PBFTMessageInterface::Ptr rangeCheckPointMsg;
+    {
+        // Note: must lock here to ensure thread safe
+        RecursiveGuard l(m_mutex);
+        m_cacheProcessor->addCheckPointMsg(checkPointMsg);
+        m_cacheProcessor->checkAndCommitStableCheckPoint();
+        rangeCheckPointMsg = collectCheckPointMsg(checkPointMsg);
+    }
+    // broadcast checkpoint message without holding the lock
+    broadcastCheckPointMsg(rangeCheckPointMsg);
+}
+
+PBFTMessageInterface::Ptr PBFTEngine::collectCheckPointMsg(
+    PBFTMessageInterface::Ptr _checkPointMsg)
+{
+    m_cacheProcessor->addPendingCheckPoint(_checkPointMsg->consensusProposal());
+    auto pendingSize = (int64_t)(m_cacheProcessor->pendingCheckPointSize());
+    auto delay = utcTime() - m_cacheProcessor->lastCheckPointFlushTime();
+    // broadcast the range checkpoint when collect enough executed proposals, wait too long or no
+    // more proposals waiting for execution
+    if (pendingSize < m_config->checkPointInterval() && delay < m_config->maxCheckPointDelay() &&
+        m_config->executionBacklog() > 0)
+    {
+        PBFT_LOG(DEBUG) << LOG_DESC("collectCheckPointMsg: delay the checkpoint")
+                        << LOG_KV("index", _checkPointMsg->index())
+                        << LOG_KV("pendingSize", pendingSize) << LOG_KV("delay", delay);
+        scheduleCheckPointFlush(m_config->maxCheckPointDelay() - delay);
+        return nullptr;
+    }
+    // the checkpoints will be piggybacked on the next prepare/commit message
+    if (m_config->piggybackCheckPoint() && !m_config->batchConsensusMsg() &&
+        !m_config->collectorMode() && delay < m_config->maxCheckPointDelay() &&
+        m_cacheProcessor->existPendingVote())
+    {
+        PBFT_LOG(DEBUG) << LOG_DESC("collectCheckPointMsg: piggyback the checkpoint")
+                        << LOG_KV("index", _checkPointMsg->index())
+                        << LOG_KV("pendingSize", pendingSize) << LOG_KV("delay", delay);
+        // flush the checkpoints not piggybacked within maxCheckPointDelay
+        scheduleCheckPointFlush(m_config->maxCheckPointDelay() - delay);
+        return nullptr;
+    }
+    return fetchRangeCheckPointMsg();
+}
+
+PBFTMessageInterface::Ptr PBFTEngine::fetchRangeCheckPointMsg()
+{
+    auto checkPoints = m_cacheProcessor->fetchPendingCheckPoints();
+    if (m_checkPointFlushTimer)
+    {
+        m_config->timerWheel()->cancel(m_checkPointFlushTimer);
+        m_checkPointFlushTimer = 0;
+    }
+    if (checkPoints.empty())
+    {
+        return nullptr;
+    }
+    // the latest executed proposal is carried by the consensusProposal,
+    // the previous executed proposals are carried by the proposals
+    auto latestCheckPoint = checkPoints.back();
+    checkPoints.pop_back();
+    auto checkPointMsg = m_config->pbftMessageFactory()->populateFrom(PacketType::CheckPoint,
+        latestCheckPoint, m_config->pbftMsgDefaultVersion(), m_config->view(), utcTime(),
+        m_config->nodeIndex());
+    checkPointMsg->setProposals(checkPoints);
+    return checkPointMsg;
+}
 
-    auto encodedData = m_config->codec()->encode(checkPointMsg);
+void PBFTEngine::broadcastCheckPointMsg(PBFTMessageInterface::Ptr _checkPointMsg)
+{
+    if (!_checkPointMsg)
+    {
+        return;
+    }
+    auto encodedData = m_config->codec()->encode(_checkPointMsg);
     m_config->frontService()->asyncSendMessageByNodeIDs(
-        ModuleID::PBFT, m_config->consensusNodeIDList(), ref(*encodedData));
-    // Note: must lock here to ensure thread safe
-    RecursiveGuard l(m_mutex);
-    // restart the timer when proposal execute finished to in case of timeout
-    if (m_config->timer()->running())
+        ModuleID::PBFT, *(m_config->consensusNodeIDList()), ref(*encodedData));
+    PBFT_LOG(INFO) << LOG_DESC("broadcastCheckPointMsg") << LOG_KV("index", _checkPointMsg->index())
+                   << LOG_KV("rangeSize", _checkPointMsg->proposals().size() + 1);
+}
+
+void PBFTEngine::scheduleCheckPointFlush(int64_t _delay)
+{
+    if (m_checkPointFlushTimer)
     {
-        m_config->timer()->restart();
+        return;
     }
-    m_cacheProcessor->addCheckPointMsg(checkPointMsg);
-    m_cacheProcessor->setCheckPointProposal(_executedProposal);
-    m_config->setExpectedCheckPoint(_executedProposal->index() + 1);
-    m_cacheProcessor->checkAndCommitStableCheckPoint();
-    m_cacheProcessor->tryToApplyCommitQueue();
-    m_cacheProcessor->eraseExecutedProposal(_proposal->hash());
+    // Note: the pending checkpoints should be broadcasted within maxCheckPointDelay even if no
+    // more proposal is executed, e.g. the execution waits for the missed proposal
+    auto self = std::weak_ptr<PBFTEngine>(shared_from_this());
+    m_checkPointFlushTimer =
+        m_config->timerWheel()->schedule(std::max(_delay, (int64_t)1), [self]() {
+            auto engine = self.lock();
+            if (!engine)
+            {
+                return;
+            }
+            engine->m_worker->enqueue([self]() {
+                try
+                {
+                    auto engine = self.lock();
+                    if (!engine)
+                    {
+                        return;
+                    }
+                    engine->onCheckPointFlushTimeout();
+                }
+                catch (std::exception const& e)
+                {
+                    PBFT_LOG(WARNING) << LOG_DESC("onCheckPointFlushTimeout exception")
+                                      << LOG_KV("error", boost::diagnostic_information(e));
+                }
+            });
+        });
+}
+
+void PBFTEngine::onCheckPointFlushTimeout()
+{
+    PBFTMessageInterface::Ptr checkPointMsg;
+    {
+        RecursiveGuard l(m_mutex);
+        m_checkPointFlushTimer = 0;
+        checkPointMsg = fetchRangeCheckPointMsg();
+    }
+    if (checkPointMsg)
+    {
+        PBFT_LOG(INFO) << LOG_DESC("onCheckPointFlushTimeout: flush the pending checkpoints")
+                       << LOG_KV("index", checkPointMsg->index()) << m_config->printCurrentState();
+    }
+    broadcastCheckPointMsg(checkPointMsg);
 }
 
 // called after proposal executed successfully
@@ -269,6 +575,15 @@ void PBFTEngine::onRecvProposal(bool _containSysTxs, bytesConstRef _proposalData
         m_config->validator()->asyncResetTxsFlag(_proposalData, false);
         return;
     }
+    if (m_config->stateRecovering())
+    {
+        PBFT_LOG(INFO) << LOG_DESC("onRecvProposal failed for the state is recovering")
+                       << LOG_KV("index", _proposalIndex)
+                       << LOG_KV("hash", _proposalHash.abridged());
+        m_config->notifyResetSealing();
+        m_config->validator()->asyncResetTxsFlag(_proposalData, false);
+        return;
+    }
     if (m_config->timeout())
     {
         PBFT_LOG(INFO) << LOG_DESC("onRecvProposal failed for timout now")
@@ -287,6 +602,13 @@ void PBFTEngine::onRecvProposal(bool _containSysTxs, bytesConstRef _proposalData
     pbftProposal->setHash(_proposalHash);
     pbftProposal->setSealerId(m_config->nodeIndex());
     pbftProposal->setSystemProposal(_containSysTxs);
+    // the batched entries are authenticated by the proposal signature
+    if (m_config->batchConsensusMsg())
+    {
+        auto signatureData =
+            m_config->cryptoSuite()->signatureImpl()->sign(m_config->keyPair(), _proposalHash);
+        pbftProposal->setSignature(*signatureData);
+    }
 
     auto pbftMessage =
         m_config->pbftMessageFactory()->populateFrom(PacketType::PrePreparePacket, pbftProposal,
@@ -298,14 +620,19 @@ void PBFTEngine::onRecvProposal(bool _containSysTxs, bytesConstRef _proposalData
 
     // handle the pre-prepare packet
     RecursiveGuard l(m_mutex);
-    auto ret = handlePrePrepareMsg(pbftMessage, false, false, false);
+    auto ret = handleLocalPrePrepareMsg(pbftMessage);
     // only broadcast the prePrepareMsg when local handlePrePrepareMsg success
-    if (ret)
+    if (ret && m_cacheProcessor->tryToBatchConsensusMsg(pbftMessage))
+    {
+        PBFT_LOG(INFO) << LOG_DESC("onRecvProposal: broadcast the prePrepare in batch")
+                       << printPBFTMsgInfo(pbftMessage);
+    }
+    else if (ret)
     {
         // broadcast the pre-prepare packet
         auto encodedData = m_config->codec()->encode(pbftMessage);
         m_config->frontService()->asyncSendMessageByNodeIDs(
-            ModuleID::PBFT, m_config->consensusNodeIDList(), ref(*encodedData));
+            ModuleID::PBFT, *(m_config->consensusNodeIDList()), ref(*encodedData));
     }
     else
     {
@@ -368,7 +695,7 @@ void PBFTEngine::onReceivePBFTMessage(Error::Ptr _error, NodeIDPtr _fromNode, by
 {
     try
     {
-        if (_error != nullptr)
+        if (_error != nullptr || m_stopped)
         {
             return;
         }
@@ -454,6 +781,24 @@ void PBFTEngine::executeWorker()
         waitSignal();
         return;
     }
+    // park the received messages in the msgQueue until the state recovered
+    if (m_config->stateRecovering())
+    {
+        waitSignal();
+        return;
+    }
+    // broadcast the consensus messages waiting in the batch
+    if (m_cacheProcessor->batchedConsensusMsgSize() > 0)
+    {
+        RecursiveGuard l(m_mutex);
+        m_cacheProcessor->flushBatchedConsensusMsg();
+    }
+    // broadcast the votes to all the nodes when the collector timeout
+    if (m_config->collectorMode())
+    {
+        RecursiveGuard l(m_mutex);
+        m_cacheProcessor->checkCollectorTimeout();
+    }
     // handle the PBFT message(here will wait when the msgQueue is empty)
     auto messageResult = m_msgQueue->tryPop(c_PopWaitSeconds);
     auto empty = m_msgQueue->empty();
@@ -545,6 +890,21 @@ void PBFTEngine::handleMsg(std::shared_ptr<PBFTBaseMessageInterface> _msg)
         handleCheckPointMsg(checkPointMsg);
         break;
     }
+    case PacketType::PrePrepareBatchPacket:
+    case PacketType::PrepareBatchPacket:
+    case PacketType::CommitBatchPacket:
+    {
+        auto batchMsg = std::dynamic_pointer_cast<PBFTMessageInterface>(_msg);
+        handleBatchMsg(batchMsg);
+        break;
+    }
+    case PacketType::PrepareCertificatePacket:
+    case PacketType::CommitCertificatePacket:
+    {
+        auto certificate = std::dynamic_pointer_cast<PBFTMessageInterface>(_msg);
+        handleCertificateMsg(certificate);
+        break;
+    }
     case PacketType::RecoverRequest:
     {
         auto request = std::dynamic_pointer_cast<PBFTMessageInterface>(_msg);
@@ -568,6 +928,130 @@ void PBFTEngine::handleMsg(std::shared_ptr<PBFTBaseMessageInterface> _msg)
     }
 }
 
+void PBFTEngine::handleBatchMsg(PBFTMessageInterface::Ptr _batchMsg)
+{
+    auto packetType = unbatchedPacketType((PacketType)_batchMsg->packetType());
+    PBFT_LOG(DEBUG) << LOG_DESC("handleBatchMsg") << printPBFTMsgInfo(_batchMsg)
+                    << LOG_KV("batchSize", _batchMsg->proposals().size());
+    if (_batchMsg->view() < m_config->view())
+    {
+        PBFT_LOG(DEBUG) << LOG_DESC("handleBatchMsg: invalid batch for expired view")
+                        << printPBFTMsgInfo(_batchMsg) << m_config->printCurrentState();
+        return;
+    }
+    // the envelope signed by the generator binds the packetType, view and entries of the batch
+    if (_batchMsg->hash() != m_cacheProcessor->calculateBatchDigest(_batchMsg))
+    {
+        PBFT_LOG(WARNING) << LOG_DESC("handleBatchMsg: invalid batch digest")
+                          << printPBFTMsgInfo(_batchMsg);
+        return;
+    }
+    if (checkSignature(_batchMsg) == CheckResult::INVALID)
+    {
+        PBFT_LOG(WARNING) << LOG_DESC("handleBatchMsg: invalid batch signature")
+                          << printPBFTMsgInfo(_batchMsg);
+        return;
+    }
+    for (auto const& proposal : _batchMsg->proposals())
+    {
+        auto pbftMsg = m_config->pbftMessageFactory()->populateFrom(packetType, proposal,
+            _batchMsg->version(), _batchMsg->view(), _batchMsg->timestamp(),
+            _batchMsg->generatedFrom());
+        pbftMsg->setFrom(_batchMsg->from());
+        // every batched entry must also carry the proposal signature of the generator
+        if (!checkProposalSignature(_batchMsg->generatedFrom(), proposal,
+                m_config->voteSignatureHash(pbftMsg)))
+        {
+            PBFT_LOG(WARNING) << LOG_DESC("handleBatchMsg: invalid proposal signature")
+                              << printPBFTProposal(proposal) << printPBFTMsgInfo(_batchMsg);
+            continue;
+        }
+        switch (packetType)
+        {
+        case PacketType::PrePreparePacket:
+            handlePrePrepareMsg(pbftMsg, true, false, false);
+            break;
+        case PacketType::PreparePacket:
+            handlePrepareMsg(pbftMsg, false);
+            break;
+        case PacketType::CommitPacket:
+            handleCommitMsg(pbftMsg, false);
+            break;
+        default:
+            return;
+        }
+    }
+}
+
+bool PBFTEngine::handleCertificateMsg(PBFTMessageInterface::Ptr _certificate)
+{
+    PBFT_LOG(DEBUG) << LOG_DESC("handleCertificateMsg") << printPBFTMsgInfo(_certificate)
+                    << m_config->printCurrentState();
+    if (checkPBFTMsgState(_certificate) == CheckResult::INVALID)
+    {
+        return false;
+    }
+    if (_certificate->generatedFrom() == m_config->nodeIndex())
+    {
+        return false;
+    }
+    // the certificate can only be generated by the collector of the current view
+    if (_certificate->view() != m_config->view() ||
+        _certificate->generatedFrom() != m_config->leaderIndex(_certificate->index()))
+    {
+        PBFT_LOG(DEBUG) << LOG_DESC("handleCertificateMsg: invalid view or collector")
+                        << printPBFTMsgInfo(_certificate) << m_config->printCurrentState();
+        return false;
+    }
+    if (checkSignature(_certificate) == CheckResult::INVALID)
+    {
+        return false;
+    }
+    if (m_cacheProcessor->conflictWithProcessedReq(_certificate))
+    {
+        return false;
+    }
+    // the votes of the certificate are authenticated by the signature list
+    if (!m_cacheProcessor->checkCertificate(_certificate))
+    {
+        PBFT_LOG(WARNING) << LOG_DESC("handleCertificateMsg: invalid certificate")
+                          << printPBFTMsgInfo(_certificate);
+        return false;
+    }
+    auto isPrepareCertificate =
+        (_certificate->packetType() == PacketType::PrepareCertificatePacket);
+    auto voteType = isPrepareCertificate ? PacketType::PreparePacket : PacketType::CommitPacket;
+    auto certificateProposal = _certificate->consensusProposal();
+    auto proofSize = certificateProposal->signatureProofSize();
+    for (size_t i = 0; i < proofSize; i++)
+    {
+        auto proof = certificateProposal->signatureProof(i);
+        auto voteProposal = m_config->pbftMessageFactory()->createPBFTProposal();
+        voteProposal->setIndex(certificateProposal->index());
+        voteProposal->setHash(certificateProposal->hash());
+        voteProposal->setSignature(proof.second.toBytes());
+        auto vote = m_config->pbftMessageFactory()->populateFrom(voteType, voteProposal,
+            _certificate->version(), _certificate->view(), _certificate->timestamp(), proof.first);
+        if (isPrepareCertificate)
+        {
+            m_cacheProcessor->addPrepareCache(vote);
+        }
+        else
+        {
+            m_cacheProcessor->addCommitReq(vote);
+        }
+    }
+    if (isPrepareCertificate)
+    {
+        m_cacheProcessor->checkAndPreCommit();
+    }
+    else
+    {
+        m_cacheProcessor->checkAndCommit();
+    }
+    return true;
+}
+
 CheckResult PBFTEngine::checkPBFTMsgState(PBFTMessageInterface::Ptr _pbftReq) const
 {
     if (!_pbftReq->consensusProposal())
@@ -634,8 +1118,8 @@ CheckResult PBFTEngine::checkSignature(PBFTBaseMessageInterface::Ptr _req)
                           << printPBFTMsgInfo(_req);
         return CheckResult::INVALID;
     }
-    auto publicKey = nodeInfo->nodeID();
-    if (!_req->verifySignature(m_config->cryptoSuite(), publicKey))
+    auto parsedKey = m_config->publicKeyCache()->parsedKey(nodeInfo->nodeID());
+    if (!_req->verifySignature(parsedKey))
     {
         PBFT_LOG(WARNING) << LOG_DESC("checkSignature failed for invalid signature")
                           << printPBFTMsgInfo(_req);
@@ -646,6 +1130,16 @@ CheckResult PBFTEngine::checkSignature(PBFTBaseMessageInterface::Ptr _req)
 
 bool PBFTEngine::checkProposalSignature(
     IndexType _generatedFrom, PBFTProposalInterface::Ptr _proposal)
+{
+    if (!_proposal)
+    {
+        return false;
+    }
+    return checkProposalSignature(_generatedFrom, _proposal, _proposal->hash());
+}
+
+bool PBFTEngine::checkProposalSignature(IndexType _generatedFrom,
+    PBFTProposalInterface::Ptr _proposal, bcos::crypto::HashType const& _signedHash)
 {
     if (!_proposal || _proposal->signature().size() == 0)
     {
@@ -660,8 +1154,8 @@ bool PBFTEngine::checkProposalSignature(
         return false;
     }
 
-    return m_config->cryptoSuite()->signatureImpl()->verify(
-        nodeInfo->nodeID(), _proposal->hash(), _proposal->signature());
+    return m_config->publicKeyCache()->verify(
+        nodeInfo->nodeID(), _signedHash, _proposal->signature());
 }
 
 bool PBFTEngine::isSyncingHigher()
@@ -807,6 +1301,37 @@ bool PBFTEngine::handlePrePrepareMsg(PBFTMessageInterface::Ptr _prePrepareMsg,
     return true;
 }
 
+bool PBFTEngine::handleLocalPrePrepareMsg(PBFTMessageInterface::Ptr _prePrepareMsg)
+{
+    // Note: the prePrepareMsg is generated by the leader-self in onRecvProposal, which has checked
+    // the leader and the index, so only the leader check of the network path is skipped here
+    if (isSyncingHigher())
+    {
+        return false;
+    }
+    // the sealer may resubmit the proposal that has reached consensus and is executing
+    if (m_cacheProcessor->executingProposals().count(_prePrepareMsg->hash()))
+    {
+        PBFT_LOG(DEBUG) << LOG_DESC("handleLocalPrePrepareMsg: reject the proposal for executing")
+                        << printPBFTMsgInfo(_prePrepareMsg) << m_config->printCurrentState();
+        return false;
+    }
+    // the sealer may resubmit the same proposal, and the leader must not propose conflicting
+    // proposals for the same index
+    if (checkPrePrepareMsg(_prePrepareMsg) == CheckResult::INVALID)
+    {
+        return false;
+    }
+    m_config->validator()->asyncResetTxsFlag(_prePrepareMsg->consensusProposal()->data(), true);
+    m_cacheProcessor->addLocalPrePrepareCache(_prePrepareMsg);
+    m_config->timer()->restart();
+    broadcastPrepareMsg(_prePrepareMsg);
+    PBFT_LOG(INFO) << LOG_DESC("handleLocalPrePrepareMsg and broadcast prepare packet")
+                   << printPBFTMsgInfo(_prePrepareMsg) << m_config->printCurrentState();
+    m_cacheProcessor->checkAndPreCommit();
+    return true;
+}
+
 void PBFTEngine::broadcastPrepareMsg(PBFTMessageInterface::Ptr _prePrepareMsg)
 {
     auto prepareMsg = m_config->pbftMessageFactory()->populateFrom(PacketType::PreparePacket,
@@ -814,18 +1339,36 @@ void PBFTEngine::broadcastPrepareMsg(PBFTMessageInterface::Ptr _prePrepareMsg)
         _prePrepareMsg->consensusProposal(), m_config->cryptoSuite(), m_config->keyPair());
     prepareMsg->setIndex(_prePrepareMsg->index());
     // add the message to local cache
-    m_cacheProcessor->addPrepareCache(prepareMsg);
+    m_cacheProcessor->addLocalPrepareCache(prepareMsg);
+    // the prepareMsg will be broadcasted in batch
+    if (m_cacheProcessor->tryToBatchConsensusMsg(prepareMsg))
+    {
+        m_cacheProcessor->checkAndPreCommit();
+        return;
+    }
+    // piggyback the checkpoints of the executed proposals
+    m_cacheProcessor->piggybackCheckPoints(prepareMsg);
 
-    auto encodedData = m_config->codec()->encode(prepareMsg, m_config->pbftMsgDefaultVersion());
-    // only broadcast to the consensus nodes
-    m_config->frontService()->asyncSendMessageByNodeIDs(
-        ModuleID::PBFT, m_config->consensusNodeIDList(), ref(*encodedData));
+    // only broadcast to the consensus nodes(or the collector in collector mode)
+    auto receivers = m_cacheProcessor->voteReceivers(prepareMsg->index());
+    if (!receivers.empty())
+    {
+        auto encodedData =
+            m_config->codec()->encode(prepareMsg, m_config->pbftMsgDefaultVersion());
+        m_config->frontService()->asyncSendMessageByNodeIDs(
+            ModuleID::PBFT, receivers, ref(*encodedData));
+    }
+    if (prepareMsg->proposals().size() > 0)
+    {
+        prepareMsg->setProposals(PBFTProposalList());
+    }
     // try to precommit the message
     m_cacheProcessor->checkAndPreCommit();
 }
 
 
-CheckResult PBFTEngine::checkPBFTMsg(std::shared_ptr<PBFTMessageInterface> _prepareMsg)
+CheckResult PBFTEngine::checkPBFTMsg(
+    std::shared_ptr<PBFTMessageInterface> _prepareMsg, bool _needCheckSignature)
 {
     auto result = checkPBFTMsgState(_prepareMsg);
     if (result == CheckResult::INVALID)
@@ -847,19 +1390,27 @@ CheckResult PBFTEngine::checkPBFTMsg(std::shared_ptr<PBFTMessageInterface> _prep
             return CheckResult::INVALID;
         }
     }
+    if (!_needCheckSignature)
+    {
+        return CheckResult::VALID;
+    }
     return checkSignature(_prepareMsg);
 }
 
-bool PBFTEngine::handlePrepareMsg(PBFTMessageInterface::Ptr _prepareMsg)
+bool PBFTEngine::handlePrepareMsg(PBFTMessageInterface::Ptr _prepareMsg, bool _needCheckSignature)
 {
     PBFT_LOG(TRACE) << LOG_DESC("handlePrepareMsg") << printPBFTMsgInfo(_prepareMsg)
                     << m_config->printCurrentState();
-    auto result = checkPBFTMsg(_prepareMsg);
+    auto result = checkPBFTMsg(_prepareMsg, _needCheckSignature);
+    // handle the piggybacked checkpoints after the message is validated
+    handlePiggybackedCheckPoints(
+        _prepareMsg, (result != CheckResult::INVALID && _needCheckSignature));
     if (result == CheckResult::INVALID)
     {
         return false;
     }
-    if (!checkProposalSignature(_prepareMsg->generatedFrom(), _prepareMsg->consensusProposal()))
+    if (_needCheckSignature &&
+        !checkProposalSignature(_prepareMsg->generatedFrom(), _prepareMsg->consensusProposal()))
     {
         return false;
     }
@@ -868,15 +1419,25 @@ bool PBFTEngine::handlePrepareMsg(PBFTMessageInterface::Ptr _prepareMsg)
     return true;
 }
 
-bool PBFTEngine::handleCommitMsg(PBFTMessageInterface::Ptr _commitMsg)
+bool PBFTEngine::handleCommitMsg(PBFTMessageInterface::Ptr _commitMsg, bool _needCheckSignature)
 {
     PBFT_LOG(TRACE) << LOG_DESC("handleCommitMsg") << printPBFTMsgInfo(_commitMsg)
                     << m_config->printCurrentState();
-    auto result = checkPBFTMsg(_commitMsg);
+    auto result = checkPBFTMsg(_commitMsg, _needCheckSignature);
+    // handle the piggybacked checkpoints after the message is validated
+    handlePiggybackedCheckPoints(
+        _commitMsg, (result != CheckResult::INVALID && _needCheckSignature));
     if (result == CheckResult::INVALID)
     {
         return false;
     }
+    // the collector puts the signatures of the commit votes into the commit certificate
+    if (_needCheckSignature && m_config->collectorMode() &&
+        !checkProposalSignature(_commitMsg->generatedFrom(), _commitMsg->consensusProposal(),
+            m_config->voteSignatureHash(_commitMsg)))
+    {
+        return false;
+    }
     m_cacheProcessor->addCommitReq(_commitMsg);
     m_cacheProcessor->checkAndCommit();
     return true;
@@ -909,6 +1470,17 @@ void PBFTEngine::onTimeout()
         m_config->timer()->restart();
         return;
     }
+    // the leader holds back sealing when the execution or the ledger commit falls behind, the
+    // backlog is drained before the next proposal, not trigger timeout
+    if (m_config->sealingHeldBack())
+    {
+        PBFT_LOG(INFO) << LOG_DESC("onTimeout: sealing is held back, restart the timer")
+                       << LOG_KV("executionBacklog", m_config->executionBacklog())
+                       << LOG_KV("commitBacklog", m_config->commitBacklog())
+                       << m_config->printCurrentState();
+        m_config->timer()->restart();
+        return;
+    }
     triggerTimeout(true);
     PBFT_LOG(WARNING) << LOG_DESC("onTimeout") << m_config->printCurrentState();
 }
@@ -988,7 +1560,7 @@ void PBFTEngine::broadcastViewChangeReq()
     auto encodedData = m_config->codec()->encode(viewChangeReq);
     // only broadcast to the consensus nodes
     m_config->frontService()->asyncSendMessageByNodeIDs(
-        ModuleID::PBFT, m_config->consensusNodeIDList(), ref(*encodedData));
+        ModuleID::PBFT, *(m_config->consensusNodeIDList()), ref(*encodedData));
     PBFT_LOG(INFO) << LOG_DESC("broadcastViewChangeReq") << printPBFTMsgInfo(viewChangeReq);
     // collect the viewchangeReq
     m_cacheProcessor->addViewChangeReq(viewChangeReq);
@@ -1185,6 +1757,7 @@ void PBFTEngine::reHandlePrePrepareProposals(NewViewMsgInterface::Ptr _newViewRe
     m_config->notifyResetSealing();
     auto const& prePrepareList = _newViewReq->prePrepareList();
     auto maxProposalIndex = m_config->committedProposal()->index();
+    std::map<IndexType, PBFTMessageList> missedPrePrepares;
     for (auto prePrepare : prePrepareList)
     {
         if (prePrepare->index() > maxProposalIndex)
@@ -1210,15 +1783,23 @@ void PBFTEngine::reHandlePrePrepareProposals(NewViewMsgInterface::Ptr _newViewRe
             continue;
         }
         // miss the cache, request to from node
-        auto from = m_config->getConsensusNodeByIndex(prePrepare->generatedFrom());
+        missedPrePrepares[prePrepare->generatedFrom()].push_back(prePrepare);
+    }
+    // request all the missed proposals of the same node in one request
+    for (auto const& it : missedPrePrepares)
+    {
+        auto from = m_config->getConsensusNodeByIndex(it.first);
         m_logSync->requestPrecommitData(
-            from->nodeID(), prePrepare, [this](PBFTMessageInterface::Ptr _prePrepare) {
+            from->nodeID(), it.second, [this](PBFTMessageList const& _prePrepares) {
                 PBFT_LOG(INFO)
                     << LOG_DESC(
-                           "reHandlePrePrepareProposals: get the missed proposal and handle now")
-                    << printPBFTMsgInfo(_prePrepare) << m_config->printCurrentState();
+                           "reHandlePrePrepareProposals: get the missed proposals and handle now")
+                    << LOG_KV("size", _prePrepares.size()) << m_config->printCurrentState();
                 RecursiveGuard l(m_mutex);
-                handlePrePrepareMsg(_prePrepare, true, true, false);
+                for (auto const& prePrepare : _prePrepares)
+                {
+                    handlePrePrepareMsg(prePrepare, true, true, false);
+                }
             });
     }
     if (prePrepareList.size() > 0)
@@ -1250,6 +1831,7 @@ void PBFTEngine::finalizeConsensus(LedgerConfig::Ptr _ledgerConfig, bool _synced
     {
         // Note: should reNotifySealer or not?
         m_cacheProcessor->removeFutureProposals();
+        m_config->storage()->onSyncedBlock(_ledgerConfig->blockNumber());
     }
 }
 
@@ -1295,7 +1877,12 @@ bool PBFTEngine::handleCheckPointMsg(std::shared_ptr<PBFTMessageInterface> _chec
     }
     PBFT_LOG(INFO) << LOG_DESC(
                           "handleCheckPointMsg: try to add the checkpoint message into the cache")
-                   << printPBFTMsgInfo(_checkPointMsg) << m_config->printCurrentState();
+                   << printPBFTMsgInfo(_checkPointMsg)
+                   << LOG_KV("rangeSize", _checkPointMsg->proposals().size() + 1)
+                   << m_config->printCurrentState();
+    // the peer maintains the committed proposals before the checkpoint
+    m_logSync->updatePeerCheckPoint(_checkPointMsg->from(), _checkPointMsg->index());
+    handleRangeCheckPoints(_checkPointMsg);
     m_cacheProcessor->addCheckPointMsg(_checkPointMsg);
     m_cacheProcessor->tryToApplyCommitQueue();
     m_cacheProcessor->checkAndCommitStableCheckPoint();
@@ -1310,6 +1897,52 @@ bool PBFTEngine::handleCheckPointMsg(std::shared_ptr<PBFTMessageInterface> _chec
     return true;
 }
 
+void PBFTEngine::handlePiggybackedCheckPoints(
+    PBFTMessageInterface::Ptr _pbftMsg, bool _validated)
+{
+    if (_pbftMsg->proposals().empty())
+    {
+        return;
+    }
+    // the expired prepare/commit message still carries the checkpoints, only accept the
+    // checkpoints when the message is signed by the consensus node
+    if (!_validated && checkSignature(_pbftMsg) == CheckResult::INVALID)
+    {
+        PBFT_LOG(WARNING) << LOG_DESC("handlePiggybackedCheckPoints: invalid carrier message")
+                          << printPBFTMsgInfo(_pbftMsg);
+        return;
+    }
+    // every checkpoint is verified with its own signature
+    handleRangeCheckPoints(_pbftMsg);
+    m_cacheProcessor->checkAndCommitStableCheckPoint();
+}
+
+void PBFTEngine::handleRangeCheckPoints(PBFTMessageInterface::Ptr _checkPointMsg)
+{
+    // the range checkpoint or the prepare/commit message carries the signed checkpoints of the
+    // previous executed proposals
+    for (auto const& proposal : _checkPointMsg->proposals())
+    {
+        if (proposal->index() <= m_config->committedProposal()->index() ||
+            proposal->index() >= _checkPointMsg->index())
+        {
+            continue;
+        }
+        if (!checkProposalSignature(_checkPointMsg->generatedFrom(), proposal))
+        {
+            PBFT_LOG(WARNING) << LOG_DESC("handleRangeCheckPoints: invalid proposal signature")
+                              << printPBFTProposal(proposal) << printPBFTMsgInfo(_checkPointMsg);
+            continue;
+        }
+        auto checkPointMsg =
+            m_config->pbftMessageFactory()->populateFrom(PacketType::CheckPoint, proposal,
+                _checkPointMsg->version(), _checkPointMsg->view(), _checkPointMsg->timestamp(),
+                _checkPointMsg->generatedFrom());
+        checkPointMsg->setFrom(_checkPointMsg->from());
+        m_cacheProcessor->addCheckPointMsg(checkPointMsg);
+    }
+}
+
 void PBFTEngine::handleRecoverResponse(PBFTMessageInterface::Ptr _recoverResponse)
 {
     if (checkSignature(_recoverResponse) == CheckResult::INVALID)
@@ -1334,9 +1967,31 @@ void PBFTEngine::handleRecoverRequest(PBFTMessageInterface::Ptr _request)
 void PBFTEngine::sendCommittedProposalResponse(
     PBFTProposalList const& _proposalList, SendResponseCallback _sendResponse)
 {
+    // cap the memory of the response
+    PBFTProposalList responseProposals;
+    uint64_t responseSize = 0;
+    auto maxResponseSize = m_config->maxCommittedResponseSize();
+    for (auto const& proposal : _proposalList)
+    {
+        auto dataSize = proposal->data().size();
+        if (!responseProposals.empty() && responseSize + dataSize > maxResponseSize)
+        {
+            break;
+        }
+        responseProposals.emplace_back(proposal);
+        responseSize += dataSize;
+    }
+    if (responseProposals.size() < _proposalList.size())
+    {
+        PBFT_LOG(INFO) << LOG_DESC("sendCommittedProposalResponse: truncate the response")
+                       << LOG_KV("fromIndex", _proposalList[0]->index())
+                       << LOG_KV("loaded", _proposalList.size())
+                       << LOG_KV("responsed", responseProposals.size())
+                       << LOG_KV("responseSize", responseSize);
+    }
     auto pbftMessage = m_config->pbftMessageFactory()->createPBFTMsg();
     pbftMessage->setPacketType(PacketType::CommittedProposalResponse);
-    pbftMessage->setProposals(_proposalList);
+    pbftMessage->setProposals(responseProposals);
     auto encodedData = m_config->codec()->encode(pbftMessage);
     _sendResponse(ref(*encodedData));
 }
@@ -1344,21 +1999,29 @@ void PBFTEngine::sendCommittedProposalResponse(
 void PBFTEngine::onReceiveCommittedProposalRequest(
     PBFTBaseMessageInterface::Ptr _pbftMsg, SendResponseCallback _sendResponse)
 {
-    RecursiveGuard l(m_mutex);
     auto pbftRequest = std::dynamic_pointer_cast<PBFTRequestInterface>(_pbftMsg);
     PBFT_LOG(INFO) << LOG_DESC("Receive CommittedProposalRequest")
                    << LOG_KV("fromIndex", pbftRequest->index())
                    << LOG_KV("size", pbftRequest->size());
     // hit the local cache
-    auto proposal = m_cacheProcessor->fetchPrecommitProposal(pbftRequest->index());
-    if (pbftRequest->size() == 1 && proposal)
+    if (pbftRequest->size() == 1)
     {
-        PBFTProposalList proposalList;
-        proposalList.emplace_back(proposal);
-        sendCommittedProposalResponse(proposalList, _sendResponse);
-        return;
+        PBFTProposalInterface::Ptr proposal = nullptr;
+        {
+            RecursiveGuard l(m_mutex);
+            proposal = m_cacheProcessor->fetchPrecommitProposal(pbftRequest->index());
+        }
+        if (proposal)
+        {
+            PBFTProposalList proposalList;
+            proposalList.emplace_back(proposal);
+            sendCommittedProposalResponse(proposalList, _sendResponse);
+            return;
+        }
     }
-    m_config->storage()->asyncGetCommittedProposals(pbftRequest->index(), pbftRequest->size(),
+    // Note: load and encode the proposals without holding the engine lock
+    auto requestSize = std::min(pbftRequest->size(), c_maxCommittedProposalsPerResponse);
+    m_config->storage()->asyncGetCommittedProposals(pbftRequest->index(), requestSize,
         [this, pbftRequest, _sendResponse](PBFTProposalListPtr _proposalList) {
             // empty case
             if (!_proposalList || _proposalList->size() == 0)
@@ -1375,28 +2038,48 @@ void PBFTEngine::onReceiveCommittedProposalRequest(
         });
 }
 
-
 void PBFTEngine::onReceivePrecommitRequest(
     std::shared_ptr<PBFTBaseMessageInterface> _pbftMessage, SendResponseCallback _sendResponse)
 {
     RecursiveGuard l(m_mutex);
     // receive the precommitted proposals request message
     auto pbftRequest = std::dynamic_pointer_cast<PBFTRequestInterface>(_pbftMessage);
+    auto proposalKeys = pbftRequest->proposalKeys();
+    // the single-key request
+    if (proposalKeys.empty())
+    {
+        proposalKeys.emplace_back(pbftRequest->index(), pbftRequest->hash());
+    }
     // get the local precommitData
-    auto precommitMsg =
-        m_cacheProcessor->fetchPrecommitData(pbftRequest->index(), pbftRequest->hash());
-    if (!precommitMsg)
+    PBFTMessageList precommitMessages;
+    for (auto const& proposalKey : proposalKeys)
+    {
+        auto precommitMsg =
+            m_cacheProcessor->fetchPrecommitData(proposalKey.first, proposalKey.second);
+        if (!precommitMsg)
+        {
+            PBFT_LOG(INFO) << LOG_DESC("onReceivePrecommitRequest: miss the requested precommit")
+                           << LOG_KV("hash", proposalKey.second.abridged())
+                           << LOG_KV("index", proposalKey.first);
+            continue;
+        }
+        auto const& preparedProposals = precommitMsg->preparedProposals();
+        precommitMessages.insert(
+            precommitMessages.end(), preparedProposals.begin(), preparedProposals.end());
+    }
+    if (precommitMessages.empty())
     {
-        PBFT_LOG(INFO) << LOG_DESC("onReceivePrecommitRequest: miss the requested precommit")
-                       << LOG_KV("hash", pbftRequest->hash().abridged())
-                       << LOG_KV("index", pbftRequest->index());
         return;
     }
-    precommitMsg->setPacketType(PacketType::PreparedProposalResponse);
-    auto encodedData = m_config->codec()->encode(precommitMsg);
-    // response the precommitData
+    // response all the hit precommitData in one message
+    auto precommitResponse = m_config->pbftMessageFactory()->createViewChangeMsg();
+    precommitResponse->setPreparedProposals(precommitMessages);
+    precommitResponse->setPacketType(PacketType::PreparedProposalResponse);
+    auto encodedData = m_config->codec()->encode(precommitResponse);
     _sendResponse(ref(*encodedData));
     PBFT_LOG(INFO) << LOG_DESC("Receive precommitRequest and send response")
                    << LOG_KV("hash", pbftRequest->hash().abridged())
-                   << LOG_KV("index", pbftRequest->index());
+                   << LOG_KV("index", pbftRequest->index())
+                   << LOG_KV("requested", proposalKeys.size())
+                   << LOG_KV("responsed", precommitMessages.size());
 }
\ No newline at end of file
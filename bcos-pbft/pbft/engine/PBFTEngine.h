@@ -65,6 +65,7 @@ public:
         std::function<void(Error::Ptr)> _onProposalSubmitted);
 
     std::shared_ptr<PBFTConfig> pbftConfig() { return m_config; }
+    ThreadPool::Ptr verifyPool() { return m_verifyPool; }
 
     // Receive PBFT message package from frontService
     virtual void onReceivePBFTMessage(bcos::Error::Ptr _error, std::string const& _id,
@@ -75,6 +76,19 @@ public:
         m_cacheProcessor->initState(_proposals, _fromNode);
     }
 
+    // recover the committed proposals after _stabledIndex from the storage asynchronously, the
+    // received messages are parked until the recovery finished.
+    // the failed loads are retried with exponential backoff, and the engine is stopped when the
+    // state can't be recovered in m_recoverStateTimeout ms
+    virtual void asyncRecoverState(bcos::protocol::BlockNumber _stabledIndex,
+        std::function<void(Error::Ptr)> _onRecovered = nullptr);
+    void setRecoverStateRetryInterval(uint64_t _retryInterval)
+    {
+        m_recoverStateRetryInterval = _retryInterval;
+    }
+    void setRecoverStateTimeout(uint64_t _timeout) { m_recoverStateTimeout = _timeout; }
+    bool stopped() const { return m_stopped; }
+
     virtual void asyncNotifyNewBlock(
         bcos::ledger::LedgerConfig::Ptr _ledgerConfig, std::function<void(Error::Ptr)> _onRecv);
 
@@ -88,6 +102,24 @@ public:
     }
 
 protected:
+    struct RecoverStateContext
+    {
+        using Ptr = std::shared_ptr<RecoverStateContext>;
+        bcos::protocol::BlockNumber stabledIndex;
+        std::function<void(Error::Ptr)> onRecovered;
+        uint64_t startTime;
+        size_t retryTime = 0;
+        // the recovery finishes only once, either succeeded or failed
+        std::atomic_bool finished = {false};
+        TimerWheel::TimerID timeoutTimer = 0;
+    };
+    virtual void tryToRecoverState(RecoverStateContext::Ptr _context);
+    virtual void onRecoverStateLoaded(
+        RecoverStateContext::Ptr _context, PBFTProposalListPtr _stateProposals);
+    // retry the failed load after the backoff, or fail the recovery
+    virtual void onLoadStateFailed(RecoverStateContext::Ptr _context, Error::Ptr _error);
+    virtual void onRecoverStateFailed(RecoverStateContext::Ptr _context, Error::Ptr _error);
+
     virtual void initSendResponseHandler();
     virtual void onReceivePBFTMessage(bcos::Error::Ptr _error, bcos::crypto::NodeIDPtr _nodeID,
         bytesConstRef _data, SendResponseCallback _sendResponse);
@@ -111,16 +143,29 @@ protected:
     virtual CheckResult checkSignature(std::shared_ptr<PBFTBaseMessageInterface> _req);
     virtual bool checkProposalSignature(
         IndexType _generatedFrom, PBFTProposalInterface::Ptr _proposal);
+    // check the proposal signature over _signedHash, eg. the digest signed by the commit vote
+    virtual bool checkProposalSignature(IndexType _generatedFrom,
+        PBFTProposalInterface::Ptr _proposal, bcos::crypto::HashType const& _signedHash);
 
     virtual CheckResult checkPBFTMsgState(std::shared_ptr<PBFTMessageInterface> _pbftReq) const;
 
+    // the trusted path for the prePrepareMsg generated by the leader-self
+    virtual bool handleLocalPrePrepareMsg(std::shared_ptr<PBFTMessageInterface> _prePrepareMsg);
     virtual void broadcastPrepareMsg(std::shared_ptr<PBFTMessageInterface> _prePrepareMsg);
 
     // Process the Prepare type message packet
-    virtual bool handlePrepareMsg(std::shared_ptr<PBFTMessageInterface> _prepareMsg);
-    virtual CheckResult checkPBFTMsg(std::shared_ptr<PBFTMessageInterface> _prepareMsg);
+    virtual bool handlePrepareMsg(
+        std::shared_ptr<PBFTMessageInterface> _prepareMsg, bool _needCheckSignature = true);
+    virtual CheckResult checkPBFTMsg(
+        std::shared_ptr<PBFTMessageInterface> _prepareMsg, bool _needCheckSignature = true);
+
+    virtual bool handleCommitMsg(
+        std::shared_ptr<PBFTMessageInterface> _commitMsg, bool _needCheckSignature = true);
 
-    virtual bool handleCommitMsg(std::shared_ptr<PBFTMessageInterface> _commitMsg);
+    // Process the batched PrePrepare/Prepare/Commit message packets
+    virtual void handleBatchMsg(std::shared_ptr<PBFTMessageInterface> _batchMsg);
+    // expand the certificate broadcasted by the collector into the prepare/commit messages
+    virtual bool handleCertificateMsg(std::shared_ptr<PBFTMessageInterface> _certificate);
 
     virtual void onTimeout();
     virtual ViewChangeMsgInterface::Ptr generateViewChange();
@@ -138,6 +183,23 @@ protected:
 
     // handle the checkpoint message
     virtual bool handleCheckPointMsg(std::shared_ptr<PBFTMessageInterface> _checkPointMsg);
+    // add the checkpoints of the previous executed proposals carried by the range checkpoint
+    virtual void handleRangeCheckPoints(std::shared_ptr<PBFTMessageInterface> _checkPointMsg);
+    // handle the checkpoints piggybacked on the prepare/commit message
+    // _validated: the signature of the carrier message has been checked
+    virtual void handlePiggybackedCheckPoints(
+        std::shared_ptr<PBFTMessageInterface> _pbftMsg, bool _validated);
+    // collect the checkpoint of the executed proposal, return the range checkpoint covering the
+    // executed proposals since the last broadcast, nullptr when the checkpoint is delayed
+    virtual PBFTMessageInterface::Ptr collectCheckPointMsg(
+        std::shared_ptr<PBFTMessageInterface> _checkPointMsg);
+    // the range checkpoint of all the pending checkpoints, nullptr if no pending checkpoint
+    virtual PBFTMessageInterface::Ptr fetchRangeCheckPointMsg();
+    // encode and broadcast the range checkpoint, called without holding m_mutex
+    virtual void broadcastCheckPointMsg(std::shared_ptr<PBFTMessageInterface> _checkPointMsg);
+    // flush the pending checkpoints after _delay ms
+    virtual void scheduleCheckPointFlush(int64_t _delay);
+    virtual void onCheckPointFlushTimeout();
 
     // function called after reaching a consensus
     virtual void finalizeConsensus(
@@ -148,6 +210,9 @@ protected:
         PBFTProposalInterface::Ptr _executedProposal);
     virtual void onProposalApplySuccess(
         PBFTProposalInterface::Ptr _proposal, PBFTProposalInterface::Ptr _executedProposal);
+    // generate and handle the checkpoint after the committed proposal is durable
+    virtual void onProposalPersisted(
+        PBFTProposalInterface::Ptr _proposal, PBFTProposalInterface::Ptr _executedProposal);
     virtual void onProposalApplyFailed(PBFTProposalInterface::Ptr _proposal);
     virtual void onLoadAndVerifyProposalSucc(PBFTProposalInterface::Ptr _proposal);
     virtual void triggerTimeout(bool _incTimeout = true);
@@ -174,6 +239,8 @@ protected:
      */
     virtual void onReceivePrecommitRequest(
         std::shared_ptr<PBFTBaseMessageInterface> _pbftMessage, SendResponseCallback _sendResponse);
+    // only the prefix of _proposalList within maxCommittedResponseSize is responded, the requester
+    // requests the remaining proposals again
     void sendCommittedProposalResponse(
         PBFTProposalList const& _proposalList, SendResponseCallback _sendResponse);
 
@@ -191,6 +258,9 @@ protected:
     // such as consensus node list, consensus weight, etc.
     std::shared_ptr<PBFTConfig> m_config;
     ThreadPool::Ptr m_worker;
+    // verify the signature lists of the synced blocks and the fetched proposals, shared by the
+    // block validator and the log sync
+    ThreadPool::Ptr m_verifyPool;
 
     // PBFT message cache queue
     PBFTMsgQueuePtr m_msgQueue;
@@ -207,15 +277,26 @@ protected:
     mutable RecursiveMutex m_mutex;
 
     const unsigned c_PopWaitSeconds = 5;
+    const size_t c_maxRecoverStateRetryTime = 5;
+    // the backoff(in ms) before the first retry, doubled for every retry
+    std::atomic<uint64_t> m_recoverStateRetryInterval = {500};
+    // the max time(in ms) to recover the state
+    std::atomic<uint64_t> m_recoverStateTimeout = {60 * 1000};
+    // the max committed proposals loaded from the storage for one request
+    const int64_t c_maxCommittedProposalsPerResponse = 64;
 
     // Message packets allowed to be processed in timeout mode
     const std::set<PacketType> c_timeoutAllowedPacket = {ViewChangePacket, NewViewPacket,
         CommittedProposalRequest, CommittedProposalResponse, PreparedProposalRequest,
         PreparedProposalResponse, CheckPoint, RecoverRequest, RecoverResponse};
 
-    const std::set<PacketType> c_consensusPacket = {PrePreparePacket, PreparePacket, CommitPacket};
+    const std::set<PacketType> c_consensusPacket = {PrePreparePacket, PreparePacket, CommitPacket,
+        PrePrepareBatchPacket, PrepareBatchPacket, CommitBatchPacket, PrepareCertificatePacket,
+        CommitCertificatePacket};
 
     std::atomic_bool m_stopped = {false};
+    // the timer to flush the delayed checkpoints, protected by m_mutex
+    TimerWheel::TimerID m_checkPointFlushTimer = 0;
 };
 }  // namespace consensus
 }  // namespace bcos
\ No newline at end of file
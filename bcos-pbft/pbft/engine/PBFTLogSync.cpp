@@ -19,7 +19,9 @@
  * @date 2021-04-28
  */
 #include "PBFTLogSync.h"
+#include "SignatureProofVerifier.h"
 #include <bcos-framework/interfaces/protocol/Protocol.h>
+#include <algorithm>
 
 using namespace bcos;
 using namespace bcos::front;
@@ -27,39 +29,260 @@ using namespace bcos::protocol;
 using namespace bcos::crypto;
 using namespace bcos::consensus;
 
-PBFTLogSync::PBFTLogSync(PBFTConfig::Ptr _config, PBFTCacheProcessor::Ptr _pbftCache)
+PBFTLogSync::PBFTLogSync(PBFTConfig::Ptr _config, PBFTCacheProcessor::Ptr _pbftCache,
+    ThreadPool::Ptr _verifyPool)
   : m_config(_config),
     m_pbftCache(_pbftCache),
-    m_requestThread(std::make_shared<ThreadPool>("pbftLogSync", 1))
+    m_requestThread(std::make_shared<ThreadPool>("pbftLogSync", 1)),
+    m_verifyPool(_verifyPool)
 {}
 
 void PBFTLogSync::requestCommittedProposals(
     PublicPtr _from, BlockNumber _startIndex, size_t _offset)
 {
+    if (_offset == 0)
+    {
+        return;
+    }
+    auto task = std::make_shared<SyncTask>();
+    task->from = _from;
+    task->startIndex = _startIndex;
+    task->offset = _offset;
+    task->chunkSize = m_syncChunkSize;
+    task->chunks.resize(task->chunkCount());
+    task->sources.resize(task->chunkCount());
+    task->received.resize(task->chunkCount(), 0);
+    task->finished.resize(task->chunkCount(), false);
+    PBFT_LOG(INFO) << LOG_DESC("requestCommittedProposals") << LOG_KV("from", _from->shortHex())
+                   << LOG_KV("startIndex", _startIndex) << LOG_KV("offset", _offset)
+                   << LOG_KV("chunks", task->chunkCount());
+    // the chunks are fetched from different peers concurrently
+    for (size_t chunk = 0; chunk < task->chunkCount(); chunk++)
+    {
+        requestChunk(task, chunk, std::make_shared<TriedPeers>());
+    }
+}
+
+void PBFTLogSync::updatePeerCheckPoint(PublicPtr _peer, BlockNumber _checkPointIndex)
+{
+    std::lock_guard<std::mutex> l(x_peerCheckPoints);
+    auto& peerCheckPoint = m_peerCheckPoints[_peer->data()];
+    if (!peerCheckPoint.first || peerCheckPoint.second < _checkPointIndex)
+    {
+        peerCheckPoint = std::make_pair(_peer, _checkPointIndex);
+    }
+}
+
+PublicPtr PBFTLogSync::selectSyncPeer(
+    SyncTask::Ptr _task, size_t _chunk, TriedPeers const& _triedPeers)
+{
+    auto chunkEnd = _task->chunkStart(_chunk) + _task->chunkOffset(_chunk) - 1;
+    std::vector<PublicPtr> candidates;
+    if (!_triedPeers.count(_task->from->data()))
+    {
+        candidates.push_back(_task->from);
+    }
+    {
+        std::lock_guard<std::mutex> l(x_peerCheckPoints);
+        for (auto const& it : m_peerCheckPoints)
+        {
+            auto const& peer = it.second.first;
+            if (it.second.second < chunkEnd || _triedPeers.count(it.first) ||
+                peer->data() == _task->from->data() ||
+                peer->data() == m_config->nodeID()->data())
+            {
+                continue;
+            }
+            candidates.push_back(peer);
+        }
+    }
+    if (candidates.empty())
+    {
+        return nullptr;
+    }
+    // spread the chunks over the candidates
+    return candidates[_chunk % candidates.size()];
+}
+
+void PBFTLogSync::requestChunk(SyncTask::Ptr _task, size_t _chunk,
+    std::shared_ptr<TriedPeers> _triedPeers, size_t _retryTime)
+{
+    auto peer = selectSyncPeer(_task, _chunk, *_triedPeers);
+    auto startIndex = _task->pendingStart(_chunk);
+    auto offset = _task->pendingOffset(_chunk);
+    if (!peer || _retryTime > c_maxSyncRetryTime)
+    {
+        PBFT_LOG(WARNING) << LOG_DESC("requestCommittedProposals: no available peer for the chunk")
+                          << LOG_KV("startIndex", startIndex) << LOG_KV("offset", offset)
+                          << LOG_KV("triedPeers", _triedPeers->size());
+        onChunkFetched(_task, _chunk);
+        return;
+    }
+    _triedPeers->insert(peer->data());
     auto pbftRequest = m_config->pbftMessageFactory()->populateFrom(
-        PacketType::CommittedProposalRequest, _startIndex, _offset);
-    requestPBFTData(_from, pbftRequest,
-        [this, _startIndex, _offset](Error::Ptr _error, NodeIDPtr _nodeID, bytesConstRef _data,
-            std::string const&, SendResponseCallback _sendResponse) {
-            return this->onRecvCommittedProposalsResponse(
-                _error, _nodeID, _data, _startIndex, _offset, _sendResponse);
+        PacketType::CommittedProposalRequest, startIndex, offset);
+    auto self = std::weak_ptr<PBFTLogSync>(shared_from_this());
+    requestPBFTData(peer, pbftRequest,
+        [self, _task, _chunk, _triedPeers, _retryTime](Error::Ptr _error, NodeIDPtr _nodeID,
+            bytesConstRef _data, std::string const&, SendResponseCallback) {
+            auto logSync = self.lock();
+            if (!logSync)
+            {
+                return;
+            }
+            logSync->onRecvCommittedProposalsResponse(
+                _error, _nodeID, _data, _task, _chunk, _triedPeers, _retryTime);
         });
 }
 
 void PBFTLogSync::requestPrecommitData(bcos::crypto::PublicPtr _from,
     PBFTMessageInterface::Ptr _prePrepareMsg, HandlePrePrepareCallback _prePrepareCallback)
 {
+    requestPrecommitData(_from, PBFTMessageList{_prePrepareMsg},
+        [_prePrepareCallback](PBFTMessageList const& _prePrepareMsgs) {
+            for (auto const& prePrepareMsg : _prePrepareMsgs)
+            {
+                _prePrepareCallback(prePrepareMsg);
+            }
+        });
+}
+
+void PBFTLogSync::requestPrecommitData(bcos::crypto::PublicPtr _from,
+    PBFTMessageList const& _prePrepareMsgs, HandlePrePreparesCallback _prePreparesCallback)
+{
+    if (_prePrepareMsgs.empty())
+    {
+        return;
+    }
+    auto request = std::make_shared<PrecommitRequest>();
+    request->prePrepareMsgs = _prePrepareMsgs;
+    request->filled.resize(_prePrepareMsgs.size(), false);
+    request->prePreparesCallback = _prePreparesCallback;
+    request->candidates.push_back(_from);
+    // the signers of the precommit proposals also maintain the precommit data
+    std::set<bytes> candidateSet = {_from->data(), m_config->nodeID()->data()};
+    for (auto const& prePrepareMsg : _prePrepareMsgs)
+    {
+        auto proposal = prePrepareMsg->consensusProposal();
+        for (size_t i = 0; i < proposal->signatureProofSize(); i++)
+        {
+            auto signer = m_config->getConsensusNodeByIndex(proposal->signatureProof(i).first);
+            if (!signer || !candidateSet.insert(signer->nodeID()->data()).second)
+            {
+                continue;
+            }
+            request->candidates.push_back(signer->nodeID());
+        }
+    }
+    PBFT_LOG(INFO) << LOG_DESC("request the missed precommit proposals")
+                   << LOG_KV("startIndex", _prePrepareMsgs[0]->index())
+                   << LOG_KV("size", _prePrepareMsgs.size())
+                   << LOG_KV("candidates", request->candidates.size())
+                   << LOG_KV("hedgeDelay", hedgeDelay());
+    sendPrecommitRequest(request);
+}
+
+bool PBFTLogSync::sendPrecommitRequest(PrecommitRequest::Ptr _request)
+{
+    bcos::crypto::PublicPtr peer = nullptr;
+    ProposalKeyList proposalKeys;
+    {
+        std::lock_guard<std::mutex> l(_request->mutex);
+        if (_request->finished || _request->nextCandidate >= _request->candidates.size())
+        {
+            return false;
+        }
+        // only request the unfilled proposals
+        for (size_t i = 0; i < _request->prePrepareMsgs.size(); i++)
+        {
+            if (_request->filled[i])
+            {
+                continue;
+            }
+            auto const& prePrepareMsg = _request->prePrepareMsgs[i];
+            proposalKeys.emplace_back(prePrepareMsg->index(), prePrepareMsg->hash());
+        }
+        if (proposalKeys.empty())
+        {
+            return false;
+        }
+        peer = _request->candidates[_request->nextCandidate++];
+        _request->pendingResponses++;
+    }
     auto pbftRequest = m_config->pbftMessageFactory()->populateFrom(
-        PacketType::PreparedProposalRequest, _prePrepareMsg->index(), _prePrepareMsg->hash());
-    PBFT_LOG(INFO) << LOG_DESC("request the missed precommit proposal")
-                   << LOG_KV("index", _prePrepareMsg->index())
-                   << LOG_KV("hash", _prePrepareMsg->hash().abridged());
-    requestPBFTData(_from, pbftRequest,
-        [this, _prePrepareMsg, _prePrepareCallback](Error::Ptr _error, NodeIDPtr _nodeID,
-            bytesConstRef _data, std::string const&, SendResponseCallback _sendResponse) {
-            return this->onRecvPrecommitResponse(
-                _error, _nodeID, _data, _prePrepareMsg, _prePrepareCallback, _sendResponse);
+        PacketType::PreparedProposalRequest, proposalKeys);
+    auto self = std::weak_ptr<PBFTLogSync>(shared_from_this());
+    auto requestTime = utcTime();
+    requestPBFTData(peer, pbftRequest,
+        [self, _request, requestTime](Error::Ptr _error, NodeIDPtr _nodeID, bytesConstRef _data,
+            std::string const&, SendResponseCallback) {
+            auto logSync = self.lock();
+            if (!logSync)
+            {
+                return;
+            }
+            logSync->onRecvPrecommitResponse(_error, _nodeID, _data, _request, requestTime);
         });
+    scheduleHedge(_request);
+    return true;
+}
+
+void PBFTLogSync::scheduleHedge(PrecommitRequest::Ptr _request)
+{
+    {
+        std::lock_guard<std::mutex> l(_request->mutex);
+        if (_request->nextCandidate >= _request->candidates.size())
+        {
+            return;
+        }
+    }
+    auto self = std::weak_ptr<PBFTLogSync>(shared_from_this());
+    m_config->timerWheel()->schedule(hedgeDelay(), [self, _request]() {
+        try
+        {
+            auto logSync = self.lock();
+            if (!logSync || _request->finished)
+            {
+                return;
+            }
+            PBFT_LOG(INFO) << LOG_DESC("hedge the precommit request")
+                           << LOG_KV("index", _request->prePrepareMsgs[0]->index())
+                           << LOG_KV("proposals", _request->prePrepareMsgs.size());
+            logSync->sendPrecommitRequest(_request);
+        }
+        catch (std::exception const& e)
+        {
+            PBFT_LOG(WARNING) << LOG_DESC("hedge the precommit request exception")
+                              << LOG_KV("error", boost::diagnostic_information(e));
+        }
+    });
+}
+
+uint64_t PBFTLogSync::hedgeDelay() const
+{
+    std::vector<uint64_t> roundTripTimes;
+    {
+        std::lock_guard<std::mutex> l(x_roundTripTimes);
+        roundTripTimes.assign(m_roundTripTimes.begin(), m_roundTripTimes.end());
+    }
+    if (roundTripTimes.empty())
+    {
+        return c_defaultHedgeDelay;
+    }
+    auto p95 = roundTripTimes.begin() + (roundTripTimes.size() * 95 / 100);
+    std::nth_element(roundTripTimes.begin(), p95, roundTripTimes.end());
+    return std::min(
+        std::max(*p95, c_minHedgeDelay), (uint64_t)m_config->networkTimeoutInterval());
+}
+
+void PBFTLogSync::recordRoundTripTime(uint64_t _rtt)
+{
+    std::lock_guard<std::mutex> l(x_roundTripTimes);
+    m_roundTripTimes.push_back(_rtt);
+    if (m_roundTripTimes.size() > c_maxRoundTripSamples)
+    {
+        m_roundTripTimes.pop_front();
+    }
 }
 
 void PBFTLogSync::requestPBFTData(
@@ -99,44 +322,205 @@ void PBFTLogSync::requestPBFTData(
 }
 
 void PBFTLogSync::onRecvCommittedProposalsResponse(Error::Ptr _error, NodeIDPtr _nodeID,
-    bytesConstRef _data, bcos::protocol::BlockNumber _startIndex, size_t _offset,
-    SendResponseCallback)
+    bytesConstRef _data, SyncTask::Ptr _task, size_t _chunk,
+    std::shared_ptr<TriedPeers> _triedPeers, size_t _retryTime)
 {
-    if (_error)
+    auto startIndex = _task->pendingStart(_chunk);
+    auto endIndex = _task->chunkStart(_chunk) + _task->chunkOffset(_chunk) - 1;
+    PBFTProposalListPtr proposals = nullptr;
+    try
     {
-        PBFT_LOG(WARNING) << LOG_DESC("onRecvCommittedProposalResponse error")
-                          << LOG_KV("from", _nodeID->shortHex())
-                          << LOG_KV("errorCode", _error->errorCode())
-                          << LOG_KV("errorMsg", _error->errorMessage());
-        for (size_t i = 0; i < _offset; i++)
+        if (_error)
         {
-            m_pbftCache->eraseCommittedProposalList(_startIndex + i);
+            PBFT_LOG(WARNING) << LOG_DESC("onRecvCommittedProposalResponse error")
+                              << LOG_KV("from", _nodeID->shortHex())
+                              << LOG_KV("errorCode", _error->errorCode())
+                              << LOG_KV("errorMsg", _error->errorMessage());
+        }
+        else if (_data.size() > 0)
+        {
+            auto response = m_config->codec()->decode(_data);
+            if (response->packetType() == PacketType::CommittedProposalResponse)
+            {
+                auto proposalResponse = std::dynamic_pointer_cast<PBFTMessageInterface>(response);
+                proposals = std::make_shared<PBFTProposalList>();
+                for (auto const& proposal : proposalResponse->proposals())
+                {
+                    if (proposal->index() >= startIndex && proposal->index() <= endIndex)
+                    {
+                        proposals->push_back(proposal);
+                    }
+                }
+            }
         }
-        return;
     }
-    if (_data.size() == 0)
+    catch (std::exception const& e)
     {
-        return;
+        PBFT_LOG(WARNING) << LOG_DESC("onRecvCommittedProposalsResponse exception")
+                          << LOG_KV("from", _nodeID->shortHex())
+                          << LOG_KV("error", boost::diagnostic_information(e));
     }
-    auto response = m_config->codec()->decode(_data);
-    if (response->packetType() != PacketType::CommittedProposalResponse)
+    // retry the chunk on the other peers
+    if (!proposals || proposals->empty())
     {
+        requestChunk(_task, _chunk, _triedPeers, _retryTime + 1);
         return;
     }
-    auto proposalResponse = std::dynamic_pointer_cast<PBFTMessageInterface>(response);
-    // TODO: check the proposal to ensure security
-    // load the fetched checkpoint proposal into the cache
-    auto proposals = proposalResponse->proposals();
-    m_pbftCache->initState(proposals, _nodeID);
     PBFT_LOG(INFO) << LOG_DESC("onRecvCommittedProposalsResponse")
-                   << LOG_KV("from", _nodeID->shortHex())
-                   << LOG_KV("proposalSize", proposals.size());
+                   << LOG_KV("from", _nodeID->shortHex()) << LOG_KV("startIndex", startIndex)
+                   << LOG_KV("proposalSize", proposals->size());
+    asyncVerifyChunk(_task, _chunk, _nodeID, proposals, _triedPeers, _retryTime);
+}
+
+void PBFTLogSync::asyncVerifyChunk(SyncTask::Ptr _task, size_t _chunk, NodeIDPtr _fromNode,
+    PBFTProposalListPtr _proposals, std::shared_ptr<TriedPeers> _triedPeers, size_t _retryTime)
+{
+    auto self = std::weak_ptr<PBFTLogSync>(shared_from_this());
+    m_verifyPool->enqueue([self, _task, _chunk, _fromNode, _proposals, _triedPeers, _retryTime]() {
+        try
+        {
+            auto logSync = self.lock();
+            if (!logSync)
+            {
+                return;
+            }
+            auto startT = utcTime();
+            auto startIndex = _task->pendingStart(_chunk);
+            if (!logSync->verifyCommittedProposals(*_proposals, startIndex))
+            {
+                PBFT_LOG(WARNING) << LOG_DESC("Recv invalid committed proposals, try another peer")
+                                  << LOG_KV("from", _fromNode->shortHex())
+                                  << LOG_KV("startIndex", startIndex)
+                                  << LOG_KV("proposalSize", _proposals->size());
+                logSync->requestChunk(_task, _chunk, _triedPeers, _retryTime + 1);
+                return;
+            }
+            PBFT_LOG(INFO) << LOG_DESC("verify committed proposals success")
+                           << LOG_KV("from", _fromNode->shortHex())
+                           << LOG_KV("startIndex", startIndex)
+                           << LOG_KV("proposalSize", _proposals->size())
+                           << LOG_KV("timeCost", utcTime() - startT);
+            logSync->onChunkProgress(_task, _chunk, _fromNode, _proposals);
+        }
+        catch (std::exception const& e)
+        {
+            PBFT_LOG(WARNING) << LOG_DESC("asyncVerifyChunk exception")
+                              << LOG_KV("error", boost::diagnostic_information(e));
+        }
+    });
+}
+
+bool PBFTLogSync::verifyCommittedProposals(
+    PBFTProposalList const& _proposals, BlockNumber _startIndex)
+{
+    // the proposals must be linked from the requested index without gap
+    auto expectedIndex = _startIndex;
+    CertificateList certificates;
+    for (auto const& proposal : _proposals)
+    {
+        if (proposal->index() != expectedIndex)
+        {
+            PBFT_LOG(WARNING) << LOG_DESC("verifyCommittedProposals: unlinked proposal")
+                              << LOG_KV("expectedIndex", expectedIndex)
+                              << LOG_KV("index", proposal->index());
+            return false;
+        }
+        expectedIndex++;
+        certificates.push_back(std::make_pair(proposal->hash(), signatureProofs(proposal)));
+    }
+    // verify the signature lists of all the proposals in parallel
+    std::vector<uint64_t> weights;
+    auto snapshot = m_config->nodeSnapshot();
+    if (!m_config->signatureProofVerifier()->batchVerifyProofs(
+            certificates, snapshot->consensusNodeList(), m_verifyPool, weights))
+    {
+        PBFT_LOG(WARNING) << LOG_DESC("verifyCommittedProposals: invalid signature list")
+                          << LOG_KV("startIndex", _startIndex);
+        return false;
+    }
+    // check the quorum weight
+    for (size_t i = 0; i < weights.size(); i++)
+    {
+        if (weights[i] < m_config->minRequiredQuorum())
+        {
+            PBFT_LOG(WARNING) << LOG_DESC("verifyCommittedProposals: insufficient quorum")
+                              << LOG_KV("index", _proposals[i]->index())
+                              << LOG_KV("weight", weights[i])
+                              << LOG_KV("minRequiredQuorum", m_config->minRequiredQuorum());
+            return false;
+        }
+    }
+    return true;
+}
+
+void PBFTLogSync::onChunkProgress(
+    SyncTask::Ptr _task, size_t _chunk, NodeIDPtr _fromNode, PBFTProposalListPtr _proposals)
+{
+    size_t received = 0;
+    {
+        std::lock_guard<std::mutex> l(_task->mutex);
+        if (!_task->chunks[_chunk])
+        {
+            _task->chunks[_chunk] = std::make_shared<PBFTProposalList>();
+        }
+        auto chunkProposals = _task->chunks[_chunk];
+        chunkProposals->insert(chunkProposals->end(), _proposals->begin(), _proposals->end());
+        _task->sources[_chunk] = _fromNode;
+        _task->received[_chunk] += _proposals->size();
+        received = _task->received[_chunk];
+    }
+    if (received >= _task->chunkOffset(_chunk))
+    {
+        onChunkFetched(_task, _chunk);
+        return;
+    }
+    // the response is truncated by the responder, request the remaining proposals
+    PBFT_LOG(INFO) << LOG_DESC("requestCommittedProposals: request the remaining of the chunk")
+                   << LOG_KV("startIndex", _task->pendingStart(_chunk))
+                   << LOG_KV("offset", _task->pendingOffset(_chunk));
+    requestChunk(_task, _chunk, std::make_shared<TriedPeers>());
+}
+
+void PBFTLogSync::onChunkFetched(SyncTask::Ptr _task, size_t _chunk)
+{
+    // Note: the cache is fed in order of the proposal index, the chunks fetched ahead wait for
+    // the previous ones
+    std::lock_guard<std::mutex> l(_task->mutex);
+    _task->finished[_chunk] = true;
+    while (_task->nextChunk < _task->chunkCount() && _task->finished[_task->nextChunk])
+    {
+        auto chunk = _task->nextChunk;
+        // the prefix of the chunk received before the failure is still loaded
+        auto proposals = _task->chunks[chunk];
+        if (proposals && !proposals->empty())
+        {
+            // load the fetched checkpoint proposal into the cache
+            m_pbftCache->initState(*proposals, _task->sources[chunk]);
+        }
+        // the failed range can be requested again
+        for (size_t i = _task->received[chunk]; i < _task->chunkOffset(chunk); i++)
+        {
+            m_pbftCache->eraseCommittedProposalList(_task->chunkStart(chunk) + i);
+        }
+        _task->chunks[chunk] = nullptr;
+        _task->sources[chunk] = nullptr;
+        _task->nextChunk++;
+    }
 }
 
 void PBFTLogSync::onRecvPrecommitResponse(Error::Ptr _error, bcos::crypto::NodeIDPtr _nodeID,
-    bytesConstRef _data, PBFTMessageInterface::Ptr _prePrepareMsg,
-    HandlePrePrepareCallback _prePrepareCallback, SendResponseCallback)
+    bytesConstRef _data, PrecommitRequest::Ptr _request, uint64_t _requestTime)
 {
+    {
+        std::lock_guard<std::mutex> l(_request->mutex);
+        _request->pendingResponses--;
+    }
+    // the request has been answered by other nodes
+    if (_request->finished)
+    {
+        return;
+    }
+    size_t filledCount = 0;
     if (_error != nullptr)
     {
         PBFT_LOG(WARNING) << LOG_DESC("onRecvPrecommitResponse error")
@@ -144,31 +528,115 @@ void PBFTLogSync::onRecvPrecommitResponse(Error::Ptr _error, bcos::crypto::NodeI
                           << LOG_KV("errorCode", _error->errorCode())
                           << LOG_KV("errorMsg", _error->errorMessage());
     }
-    auto response = m_config->codec()->decode(_data);
-    if (response->packetType() != PacketType::PreparedProposalResponse)
+    else
     {
-        return;
+        try
+        {
+            filledCount = fillPrecommitData(_data, _request);
+        }
+        catch (std::exception const& e)
+        {
+            PBFT_LOG(WARNING) << LOG_DESC("onRecvPrecommitResponse exception")
+                              << LOG_KV("from", _nodeID->shortHex())
+                              << LOG_KV("error", boost::diagnostic_information(e));
+        }
     }
-    PBFT_LOG(INFO) << LOG_DESC("onRecvPrecommitResponse") << printPBFTMsgInfo(response);
-    auto pbftMessage = std::dynamic_pointer_cast<ViewChangeMsgInterface>(response);
-    assert(pbftMessage->preparedProposals().size() == 1);
-    auto precommitMsg = (pbftMessage->preparedProposals())[0];
-    if (!precommitMsg->consensusProposal())
+    if (filledCount > 0)
     {
-        return;
+        recordRoundTripTime(utcTime() - _requestTime);
+        PBFT_LOG(INFO) << LOG_DESC("onRecvPrecommitResponse: hit the precommit data")
+                       << LOG_KV("from", _nodeID->shortHex()) << LOG_KV("filled", filledCount)
+                       << LOG_KV("requested", _request->prePrepareMsgs.size())
+                       << LOG_KV("rtt", (utcTime() - _requestTime));
     }
-    if (precommitMsg->consensusProposal()->index() !=
-            _prePrepareMsg->consensusProposal()->index() ||
-        precommitMsg->consensusProposal()->hash() != _prePrepareMsg->consensusProposal()->hash())
+    onPrecommitResponseHandled(_request);
+}
+
+void PBFTLogSync::onPrecommitResponseHandled(PrecommitRequest::Ptr _request)
+{
+    bool allFilled = false;
+    bool pending = false;
+    {
+        std::lock_guard<std::mutex> l(_request->mutex);
+        allFilled = (_request->filledCount == _request->prePrepareMsgs.size());
+        pending = (_request->pendingResponses > 0);
+    }
+    // hedge the unfilled proposals to the next node immediately
+    if (!allFilled && (sendPrecommitRequest(_request) || pending))
     {
         return;
     }
-    if (!m_pbftCache->checkPrecommitMsg(precommitMsg))
+    // all the proposals are filled, or no node can provide the unfilled proposals
+    if (_request->finished.exchange(true))
     {
-        PBFT_LOG(WARNING) << LOG_DESC("Recv invalid precommit response")
-                          << printPBFTMsgInfo(precommitMsg);
         return;
     }
-    _prePrepareMsg->consensusProposal()->setData(precommitMsg->consensusProposal()->data());
-    _prePrepareCallback(_prePrepareMsg);
-}
\ No newline at end of file
+    PBFTMessageList filledMsgs;
+    {
+        std::lock_guard<std::mutex> l(_request->mutex);
+        for (size_t i = 0; i < _request->prePrepareMsgs.size(); i++)
+        {
+            if (_request->filled[i])
+            {
+                filledMsgs.push_back(_request->prePrepareMsgs[i]);
+            }
+        }
+    }
+    if (filledMsgs.size() < _request->prePrepareMsgs.size())
+    {
+        PBFT_LOG(WARNING) << LOG_DESC("requestPrecommitData: miss some precommit proposals")
+                          << LOG_KV("filled", filledMsgs.size())
+                          << LOG_KV("requested", _request->prePrepareMsgs.size());
+    }
+    if (!filledMsgs.empty())
+    {
+        _request->prePreparesCallback(filledMsgs);
+    }
+}
+
+size_t PBFTLogSync::fillPrecommitData(bytesConstRef _data, PrecommitRequest::Ptr _request)
+{
+    if (_data.size() == 0)
+    {
+        return 0;
+    }
+    auto response = m_config->codec()->decode(_data);
+    if (response->packetType() != PacketType::PreparedProposalResponse)
+    {
+        return 0;
+    }
+    PBFT_LOG(INFO) << LOG_DESC("onRecvPrecommitResponse") << printPBFTMsgInfo(response);
+    auto pbftMessage = std::dynamic_pointer_cast<ViewChangeMsgInterface>(response);
+    size_t filledCount = 0;
+    for (auto const& precommitMsg : pbftMessage->preparedProposals())
+    {
+        auto precommitProposal = precommitMsg->consensusProposal();
+        if (!precommitProposal)
+        {
+            continue;
+        }
+        // find the requested prePrepare message
+        std::lock_guard<std::mutex> l(_request->mutex);
+        for (size_t i = 0; i < _request->prePrepareMsgs.size(); i++)
+        {
+            auto prePrepareProposal = _request->prePrepareMsgs[i]->consensusProposal();
+            if (_request->filled[i] || precommitProposal->index() != prePrepareProposal->index() ||
+                precommitProposal->hash() != prePrepareProposal->hash())
+            {
+                continue;
+            }
+            if (!m_pbftCache->checkPrecommitMsg(precommitMsg))
+            {
+                PBFT_LOG(WARNING) << LOG_DESC("Recv invalid precommit response")
+                                  << printPBFTMsgInfo(precommitMsg);
+                break;
+            }
+            prePrepareProposal->setData(precommitProposal->data());
+            _request->filled[i] = true;
+            _request->filledCount++;
+            filledCount++;
+            break;
+        }
+    }
+    return filledCount;
+}
@@ -23,6 +23,10 @@
 #include "../config/PBFTConfig.h"
 #include <bcos-framework/interfaces/crypto/KeyInterface.h>
 #include <bcos-framework/libutilities/ThreadPool.h>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
 namespace bcos
 {
 namespace consensus
@@ -31,12 +35,16 @@ class PBFTLogSync : public std::enable_shared_from_this<PBFTLogSync>
 {
 public:
     using Ptr = std::shared_ptr<PBFTLogSync>;
-    PBFTLogSync(PBFTConfig::Ptr _config, PBFTCacheProcessor::Ptr _pbftCache);
+    // _verifyPool: the signature verification pool shared with the engine
+    PBFTLogSync(PBFTConfig::Ptr _config, PBFTCacheProcessor::Ptr _pbftCache,
+        ThreadPool::Ptr _verifyPool);
     virtual ~PBFTLogSync() {}
     using SendResponseCallback = std::function<void(bytesConstRef _respData)>;
     using HandlePrePrepareCallback = std::function<void(PBFTMessageInterface::Ptr)>;
+    using HandlePrePreparesCallback = std::function<void(PBFTMessageList const&)>;
     /**
-     * @brief batch request committed proposals to the given node
+     * @brief batch request committed proposals, the range is split into chunks fetched from the
+     * given node and the other peers that advertised a higher checkpoint
      *
      * @param _from the node that maintains the requested proposals
      * @param _startIndex the start index of the request
@@ -45,8 +53,19 @@ public:
     virtual void requestCommittedProposals(
         bcos::crypto::PublicPtr _from, bcos::protocol::BlockNumber _startIndex, size_t _offset);
 
+    // record the checkpoint advertised by the peer
+    virtual void updatePeerCheckPoint(
+        bcos::crypto::PublicPtr _peer, bcos::protocol::BlockNumber _checkPointIndex);
+
+    void setSyncChunkSize(size_t _syncChunkSize)
+    {
+        m_syncChunkSize = std::max((size_t)1, _syncChunkSize);
+    }
+    size_t syncChunkSize() const { return m_syncChunkSize; }
+
     /**
-     * @brief request precommit data from the given node
+     * @brief request precommit data from the given node, the request is hedged to the other
+     * signers of the precommit proposal if the node doesn't respond in time
      *
      * @param _from the node that maintain the precommit data
      * @param _index the index of the requested precommit data
@@ -55,25 +74,139 @@ public:
     virtual void requestPrecommitData(bcos::crypto::PublicPtr _from,
         PBFTMessageInterface::Ptr _prePrepareMsg, HandlePrePrepareCallback _prePrepareCallback);
 
+    /**
+     * @brief request the precommit data of all the given prePrepare messages in one request
+     *
+     * @param _from the node that maintain the precommit data
+     * @param _prePrepareMsgs the prePrepare messages missing the proposal data
+     * @param _prePreparesCallback called once with the prePrepare messages filled with the data
+     */
+    virtual void requestPrecommitData(bcos::crypto::PublicPtr _from,
+        PBFTMessageList const& _prePrepareMsgs, HandlePrePreparesCallback _prePreparesCallback);
+
     virtual void stop() { m_requestThread->stop(); }
 
+    // the delay(in ms) before hedging the precommit request to another node: the p95 of the
+    // recent round-trip times
+    virtual uint64_t hedgeDelay() const;
+
 protected:
+    // the committed proposals requested by one requestCommittedProposals
+    struct SyncTask
+    {
+        using Ptr = std::shared_ptr<SyncTask>;
+        bcos::crypto::PublicPtr from;
+        bcos::protocol::BlockNumber startIndex;
+        size_t offset;
+        size_t chunkSize;
+        // the fetched proposals of every chunk
+        std::vector<PBFTProposalListPtr> chunks;
+        // the peer that responded every chunk
+        std::vector<bcos::crypto::NodeIDPtr> sources;
+        // the verified proposals of every chunk, the responder may only respond a prefix of the
+        // chunk for the response size limit, the remaining proposals are requested again
+        std::vector<size_t> received;
+        std::vector<bool> finished;
+        // the chunks before nextChunk have been delivered to the cache
+        size_t nextChunk = 0;
+        std::mutex mutex;
+
+        size_t chunkCount() const { return (offset + chunkSize - 1) / chunkSize; }
+        bcos::protocol::BlockNumber chunkStart(size_t _chunk) const
+        {
+            return startIndex + _chunk * chunkSize;
+        }
+        size_t chunkOffset(size_t _chunk) const
+        {
+            return std::min(chunkSize, offset - _chunk * chunkSize);
+        }
+        // the range of the chunk has not been received
+        bcos::protocol::BlockNumber pendingStart(size_t _chunk)
+        {
+            std::lock_guard<std::mutex> l(mutex);
+            return chunkStart(_chunk) + received[_chunk];
+        }
+        size_t pendingOffset(size_t _chunk)
+        {
+            std::lock_guard<std::mutex> l(mutex);
+            return chunkOffset(_chunk) - received[_chunk];
+        }
+    };
+    using TriedPeers = std::set<bytes>;
+
+    virtual void requestChunk(SyncTask::Ptr _task, size_t _chunk,
+        std::shared_ptr<TriedPeers> _triedPeers, size_t _retryTime = 0);
+    // select the untried peer whose checkpoint covers the chunk, nullptr if no peer is available
+    virtual bcos::crypto::PublicPtr selectSyncPeer(
+        SyncTask::Ptr _task, size_t _chunk, TriedPeers const& _triedPeers);
     virtual void onRecvCommittedProposalsResponse(bcos::Error::Ptr _error,
-        bcos::crypto::NodeIDPtr _nodeID, bytesConstRef _data,
-        bcos::protocol::BlockNumber _startIndex, size_t _offset,
-        SendResponseCallback _sendResponse);
+        bcos::crypto::NodeIDPtr _nodeID, bytesConstRef _data, SyncTask::Ptr _task, size_t _chunk,
+        std::shared_ptr<TriedPeers> _triedPeers, size_t _retryTime);
+    // verify the fetched chunk on the verify pool, request the chunk from another peer if invalid
+    virtual void asyncVerifyChunk(SyncTask::Ptr _task, size_t _chunk,
+        bcos::crypto::NodeIDPtr _fromNode, PBFTProposalListPtr _proposals,
+        std::shared_ptr<TriedPeers> _triedPeers, size_t _retryTime);
+    // check the linkage of the indexes and the quorum certificates of the fetched proposals
+    virtual bool verifyCommittedProposals(
+        PBFTProposalList const& _proposals, bcos::protocol::BlockNumber _startIndex);
+    // append the verified proposals to the chunk, request the remaining proposals if any
+    virtual void onChunkProgress(SyncTask::Ptr _task, size_t _chunk,
+        bcos::crypto::NodeIDPtr _fromNode, PBFTProposalListPtr _proposals);
+    // finish the chunk when all proposals received or the remaining can't be fetched from any
+    // peer, and deliver the finished chunks in order
+    virtual void onChunkFetched(SyncTask::Ptr _task, size_t _chunk);
 
+    // the precommit data requested from several nodes, the first valid response of every
+    // proposal wins
+    struct PrecommitRequest
+    {
+        using Ptr = std::shared_ptr<PrecommitRequest>;
+        PBFTMessageList prePrepareMsgs;
+        std::vector<bool> filled;
+        size_t filledCount = 0;
+        HandlePrePreparesCallback prePreparesCallback;
+        // the from node and the other signers of the precommit proposals
+        std::vector<bcos::crypto::PublicPtr> candidates;
+        size_t nextCandidate = 0;
+        size_t pendingResponses = 0;
+        std::atomic_bool finished = {false};
+        std::mutex mutex;
+    };
+    // request the unfilled proposals from the next candidate, return false if all the candidates
+    // are requested
+    virtual bool sendPrecommitRequest(PrecommitRequest::Ptr _request);
+    virtual void scheduleHedge(PrecommitRequest::Ptr _request);
     virtual void onRecvPrecommitResponse(bcos::Error::Ptr _error, bcos::crypto::NodeIDPtr _nodeID,
-        bytesConstRef _data, PBFTMessageInterface::Ptr _prePrepareMsg,
-        HandlePrePrepareCallback _prePrepareCallback, SendResponseCallback _sendResponse);
+        bytesConstRef _data, PrecommitRequest::Ptr _request, uint64_t _requestTime);
+    // fill the prePrepare messages with the response, return the number of the filled messages
+    virtual size_t fillPrecommitData(bytesConstRef _data, PrecommitRequest::Ptr _request);
+    // hedge the unfilled proposals or finish the request
+    virtual void onPrecommitResponseHandled(PrecommitRequest::Ptr _request);
+    void recordRoundTripTime(uint64_t _rtt);
 
-    void requestPBFTData(bcos::crypto::PublicPtr _from, PBFTRequestInterface::Ptr _pbftRequest,
-        bcos::front::CallbackFunc _callback);
+    virtual void requestPBFTData(bcos::crypto::PublicPtr _from,
+        PBFTRequestInterface::Ptr _pbftRequest, bcos::front::CallbackFunc _callback);
 
 private:
     PBFTConfig::Ptr m_config;
     PBFTCacheProcessor::Ptr m_pbftCache;
     std::shared_ptr<ThreadPool> m_requestThread;
+
+    // the latest checkpoint advertised by every peer
+    std::map<bytes, std::pair<bcos::crypto::PublicPtr, bcos::protocol::BlockNumber>>
+        m_peerCheckPoints;
+    mutable std::mutex x_peerCheckPoints;
+    size_t m_syncChunkSize = 16;
+    const size_t c_maxSyncRetryTime = 3;
+
+    // verify the fetched committed proposals, owned by the engine
+    std::shared_ptr<ThreadPool> m_verifyPool;
+    // the round-trip times(in ms) of the recent precommit requests
+    std::deque<uint64_t> m_roundTripTimes;
+    mutable std::mutex x_roundTripTimes;
+    const size_t c_maxRoundTripSamples = 64;
+    const uint64_t c_defaultHedgeDelay = 200;
+    const uint64_t c_minHedgeDelay = 20;
 };
 }  // namespace consensus
 }  // namespace bcos
\ No newline at end of file
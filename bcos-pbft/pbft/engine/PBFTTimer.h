@@ -19,18 +19,67 @@
  * @date 2021-04-26
  */
 #pragma once
-#include <bcos-framework/libutilities/Timer.h>
+#include "TimerWheel.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 namespace bcos
 {
 namespace consensus
 {
-class PBFTTimer : public Timer
+// Note: the timer only holds the id of the scheduled timer, all the timers are triggered by the
+// shared TimerWheel
+class PBFTTimer : public std::enable_shared_from_this<PBFTTimer>
 {
 public:
     using Ptr = std::shared_ptr<PBFTTimer>;
-    explicit PBFTTimer(uint64_t _timeout) : Timer(_timeout) { updateAdjustedTimeout(); }
+    PBFTTimer(TimerWheel::Ptr _timerWheel, uint64_t _timeout)
+      : m_timerWheel(_timerWheel), m_timeout(_timeout)
+    {
+        updateAdjustedTimeout();
+    }
+    // the timer with a dedicated wheel
+    explicit PBFTTimer(uint64_t _timeout)
+      : PBFTTimer(std::make_shared<TimerWheel>("pbftTimer"), _timeout)
+    {}
+
+    virtual ~PBFTTimer() { stop(); }
+
+    virtual void registerTimeoutHandler(std::function<void()> _timeoutHandler)
+    {
+        std::lock_guard<std::mutex> l(x_timer);
+        m_timeoutHandler = _timeoutHandler;
+    }
+
+    virtual void start()
+    {
+        std::lock_guard<std::mutex> l(x_timer);
+        if (m_running)
+        {
+            return;
+        }
+        m_running = true;
+        scheduleTimer();
+    }
 
-    ~PBFTTimer() override {}
+    virtual void stop()
+    {
+        std::lock_guard<std::mutex> l(x_timer);
+        m_running = false;
+        cancelTimer();
+    }
+
+    virtual void restart()
+    {
+        std::lock_guard<std::mutex> l(x_timer);
+        cancelTimer();
+        m_running = true;
+        scheduleTimer();
+    }
+
+    virtual void destroy() { stop(); }
+    virtual bool running() const { return m_running; }
+    virtual uint64_t timeout() const { return m_timeout; }
 
     void updateChangeCycle(uint64_t _changeCycle)
     {
@@ -44,7 +93,7 @@ public:
     void resetChangeCycle() { updateChangeCycle(0); }
     uint64_t changeCycle() const { return m_changeCycle; }
 
-    void reset(uint64_t _timeout) override
+    virtual void reset(uint64_t _timeout)
     {
         m_timeout = _timeout;
         updateAdjustedTimeout();
@@ -67,9 +116,64 @@ protected:
             restart();
         }
     }
-    uint64_t adjustTimeout() override { return m_adjustedTimeout; }
+    virtual uint64_t adjustTimeout() { return m_adjustedTimeout; }
+
+    // Note: must hold x_timer
+    void scheduleTimer()
+    {
+        auto self = std::weak_ptr<PBFTTimer>(shared_from_this());
+        auto sequence = (++m_sequence);
+        m_timerID = m_timerWheel->schedule(adjustTimeout(), [self, sequence]() {
+            auto timer = self.lock();
+            if (!timer)
+            {
+                return;
+            }
+            timer->onTimeout(sequence);
+        });
+    }
+    // Note: must hold x_timer
+    void cancelTimer()
+    {
+        // the timer popped by the wheel before cancelled is ignored by onTimeout
+        m_sequence++;
+        if (m_timerID == 0)
+        {
+            return;
+        }
+        m_timerWheel->cancel(m_timerID);
+        m_timerID = 0;
+    }
+
+    virtual void onTimeout(uint64_t _sequence)
+    {
+        std::function<void()> timeoutHandler;
+        {
+            std::lock_guard<std::mutex> l(x_timer);
+            if (_sequence != m_sequence)
+            {
+                return;
+            }
+            // Note: the timer keeps running until stopped, the handler restarts it if required
+            m_timerID = 0;
+            timeoutHandler = m_timeoutHandler;
+        }
+        if (timeoutHandler)
+        {
+            timeoutHandler();
+        }
+    }
 
 private:
+    TimerWheel::Ptr m_timerWheel;
+    std::function<void()> m_timeoutHandler;
+    TimerWheel::TimerID m_timerID = 0;
+    // the sequence of the scheduled timer, increased when the timer is restarted or stopped
+    uint64_t m_sequence = 0;
+    std::atomic_bool m_running = {false};
+    mutable std::mutex x_timer;
+
+    std::atomic<uint64_t> m_timeout = {0};
     std::atomic<uint64_t> m_adjustedTimeout = {0};
     std::atomic<uint64_t> m_changeCycle = {0};
     double const m_base = 1.5;
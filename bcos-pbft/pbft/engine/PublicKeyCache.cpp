@@ -0,0 +1,63 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief cache for the parsed public keys of the consensus nodes
+ * @file PublicKeyCache.cpp
+ * @author: yujiechen
+ * @date 2021-06-18
+ */
+#include "PublicKeyCache.h"
+
+using namespace bcos;
+using namespace bcos::consensus;
+using namespace bcos::crypto;
+
+void PublicKeyCache::setFactory(ParsedPublicKeyFactory::Ptr _factory)
+{
+    std::lock_guard<std::mutex> l(x_update);
+    std::atomic_store(&m_factory, _factory);
+    std::atomic_store(&m_parsedKeys, std::make_shared<ParsedKeyMap>());
+}
+
+void PublicKeyCache::update(NodeIDs const& _nodeIDs)
+{
+    std::lock_guard<std::mutex> l(x_update);
+    auto factory = std::atomic_load(&m_factory);
+    auto currentKeys = std::atomic_load(&m_parsedKeys);
+    std::unordered_map<bytes, ParsedPublicKeyInterface::Ptr, NodeIDHasher> parsedKeys;
+    for (auto const& nodeID : _nodeIDs)
+    {
+        auto const& nodeIDData = nodeID->data();
+        auto it = currentKeys->find(nodeIDData);
+        if (it != currentKeys->end())
+        {
+            parsedKeys[nodeIDData] = it->second;
+            continue;
+        }
+        parsedKeys[nodeIDData] = factory->createParsedPublicKey(nodeID);
+    }
+    std::atomic_store(&m_parsedKeys, std::make_shared<ParsedKeyMap>(std::move(parsedKeys)));
+}
+
+ParsedPublicKeyInterface::Ptr PublicKeyCache::parsedKey(PublicPtr _nodeID)
+{
+    auto parsedKeys = std::atomic_load(&m_parsedKeys);
+    auto it = parsedKeys->find(_nodeID->data());
+    if (it != parsedKeys->end())
+    {
+        return it->second;
+    }
+    return std::atomic_load(&m_factory)->createParsedPublicKey(_nodeID);
+}
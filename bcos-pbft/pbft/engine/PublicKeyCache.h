@@ -0,0 +1,105 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief cache for the parsed public keys of the consensus nodes
+ * @file PublicKeyCache.h
+ * @author: yujiechen
+ * @date 2021-06-18
+ */
+#pragma once
+#include "../interfaces/ParsedPublicKeyInterface.h"
+#include "bcos-pbft/core/ConsensusNodeSnapshot.h"
+#include <bcos-framework/interfaces/crypto/CryptoSuite.h>
+#include <mutex>
+#include <unordered_map>
+
+namespace bcos
+{
+namespace consensus
+{
+// the default parsed key: delegate to the SignatureCrypto with the decoded public key
+class DefaultParsedPublicKey : public ParsedPublicKeyInterface
+{
+public:
+    DefaultParsedPublicKey(
+        bcos::crypto::SignatureCrypto::Ptr _signatureImpl, bcos::crypto::PublicPtr _nodeID)
+      : m_signatureImpl(_signatureImpl), m_nodeID(_nodeID)
+    {}
+    ~DefaultParsedPublicKey() override {}
+
+    bcos::crypto::PublicPtr nodeID() const override { return m_nodeID; }
+    bool verify(bcos::crypto::HashType const& _hash, bytesConstRef _signature) const override
+    {
+        return m_signatureImpl->verify(m_nodeID, _hash, _signature);
+    }
+
+private:
+    bcos::crypto::SignatureCrypto::Ptr m_signatureImpl;
+    bcos::crypto::PublicPtr m_nodeID;
+};
+
+class DefaultParsedPublicKeyFactory : public ParsedPublicKeyFactory
+{
+public:
+    explicit DefaultParsedPublicKeyFactory(bcos::crypto::SignatureCrypto::Ptr _signatureImpl)
+      : m_signatureImpl(_signatureImpl)
+    {}
+    ~DefaultParsedPublicKeyFactory() override {}
+
+    ParsedPublicKeyInterface::Ptr createParsedPublicKey(bcos::crypto::PublicPtr _nodeID) override
+    {
+        return std::make_shared<DefaultParsedPublicKey>(m_signatureImpl, _nodeID);
+    }
+
+private:
+    bcos::crypto::SignatureCrypto::Ptr m_signatureImpl;
+};
+
+// Note: the keys are parsed once when the consensus node list changed, the verifiers hold the
+// whole key map without lock, and the keys of the unchanged nodes are reused across the updates
+class PublicKeyCache
+{
+public:
+    using Ptr = std::shared_ptr<PublicKeyCache>;
+    using ParsedKeyMap =
+        std::unordered_map<bytes, ParsedPublicKeyInterface::Ptr, NodeIDHasher> const;
+
+    explicit PublicKeyCache(ParsedPublicKeyFactory::Ptr _factory)
+      : m_factory(_factory), m_parsedKeys(std::make_shared<ParsedKeyMap>())
+    {}
+    virtual ~PublicKeyCache() {}
+
+    // replace the factory and drop all the keys parsed by the old factory
+    virtual void setFactory(ParsedPublicKeyFactory::Ptr _factory);
+    // parse the keys of the new consensus node list
+    virtual void update(bcos::crypto::NodeIDs const& _nodeIDs);
+
+    // the parsed key of the given node, parsed on the fly for the non-consensus nodes
+    virtual ParsedPublicKeyInterface::Ptr parsedKey(bcos::crypto::PublicPtr _nodeID);
+    virtual bool verify(bcos::crypto::PublicPtr _nodeID, bcos::crypto::HashType const& _hash,
+        bytesConstRef _signature)
+    {
+        return parsedKey(_nodeID)->verify(_hash, _signature);
+    }
+    size_t size() const { return std::atomic_load(&m_parsedKeys)->size(); }
+
+private:
+    ParsedPublicKeyFactory::Ptr m_factory;
+    std::shared_ptr<ParsedKeyMap> m_parsedKeys;
+    // serialize the writers
+    std::mutex x_update;
+};
+}  // namespace consensus
+}  // namespace bcos
@@ -0,0 +1,127 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief verify the signature proofs of the proposals
+ * @file SignatureProofVerifier.cpp
+ * @author: yujiechen
+ * @date 2021-06-10
+ */
+#include "SignatureProofVerifier.h"
+#include <condition_variable>
+#include <set>
+
+using namespace bcos;
+using namespace bcos::consensus;
+using namespace bcos::crypto;
+
+uint64_t SignatureProofVerifier::verifyProofs(HashType const& _hash,
+    SignatureProofList const& _proofs, ConsensusNodeList const& _consensusNodes)
+{
+    uint64_t weight = 0;
+    std::set<int64_t> signers;
+    for (auto const& proof : _proofs)
+    {
+        // unknown or duplicated signer
+        if (proof.first < 0 || (size_t)proof.first >= _consensusNodes.size() ||
+            !signers.insert(proof.first).second)
+        {
+            return 0;
+        }
+        auto nodeInfo = _consensusNodes[proof.first];
+        if (!m_publicKeyCache->verify(nodeInfo->nodeID(), _hash, proof.second))
+        {
+            return 0;
+        }
+        weight += nodeInfo->weight();
+    }
+    return weight;
+}
+
+bool SignatureProofVerifier::batchVerifyProofs(CertificateList const& _certificates,
+    ConsensusNodeList const& _consensusNodes, ThreadPool::Ptr _verifyPool,
+    std::vector<uint64_t>& _weights)
+{
+    _weights.clear();
+    // check the signers and calculate the weights before verifying the signatures
+    auto signatures = std::make_shared<
+        std::vector<std::tuple<HashType, ParsedPublicKeyInterface::Ptr, bytesConstRef>>>();
+    for (auto const& certificate : _certificates)
+    {
+        uint64_t weight = 0;
+        std::set<int64_t> signers;
+        for (auto const& proof : certificate.second)
+        {
+            if (proof.first < 0 || (size_t)proof.first >= _consensusNodes.size() ||
+                !signers.insert(proof.first).second)
+            {
+                return false;
+            }
+            auto nodeInfo = _consensusNodes[proof.first];
+            signatures->emplace_back(
+                certificate.first, m_publicKeyCache->parsedKey(nodeInfo->nodeID()), proof.second);
+            weight += nodeInfo->weight();
+        }
+        if (weight == 0)
+        {
+            return false;
+        }
+        _weights.push_back(weight);
+    }
+    auto chunkSize = c_verifyChunkSize;
+    auto chunks = (signatures->size() + chunkSize - 1) / chunkSize;
+    struct VerifyState
+    {
+        std::atomic<size_t> nextChunk = {0};
+        std::atomic<size_t> finishedChunks = {0};
+        std::atomic_bool invalid = {false};
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto state = std::make_shared<VerifyState>();
+    // Note: the chunks are claimed by both the pool and the caller, the caller never waits for the
+    // chunks not started by the pool
+    auto verifyChunks = [state, signatures, chunks, chunkSize]() {
+        size_t chunk;
+        while ((chunk = state->nextChunk++) < chunks)
+        {
+            auto end = std::min(signatures->size(), (chunk + 1) * chunkSize);
+            for (size_t i = chunk * chunkSize; i < end && !state->invalid; i++)
+            {
+                auto const& signature = (*signatures)[i];
+                if (!std::get<1>(signature)->verify(std::get<0>(signature), std::get<2>(signature)))
+                {
+                    // fail fast, the other tasks skip the remaining signatures
+                    state->invalid = true;
+                }
+            }
+            if (++state->finishedChunks == chunks)
+            {
+                std::lock_guard<std::mutex> l(state->mutex);
+                state->finished.notify_all();
+            }
+        }
+    };
+    if (_verifyPool)
+    {
+        for (size_t i = 1; i < chunks; i++)
+        {
+            _verifyPool->enqueue(verifyChunks);
+        }
+    }
+    verifyChunks();
+    std::unique_lock<std::mutex> l(state->mutex);
+    state->finished.wait(l, [state, chunks]() { return state->finishedChunks >= chunks; });
+    return !state->invalid;
+}
@@ -0,0 +1,75 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief verify the signature proofs of the proposals
+ * @file SignatureProofVerifier.h
+ * @author: yujiechen
+ * @date 2021-06-10
+ */
+#pragma once
+#include "../interfaces/PBFTProposalInterface.h"
+#include "PublicKeyCache.h"
+#include <bcos-framework/interfaces/consensus/ConsensusNodeInterface.h>
+#include <bcos-framework/interfaces/crypto/CryptoSuite.h>
+#include <bcos-framework/libutilities/ThreadPool.h>
+
+namespace bcos
+{
+namespace consensus
+{
+// (nodeIndex, signature) pairs
+using SignatureProofList = std::vector<std::pair<int64_t, bytesConstRef>>;
+// (hash, proofs) pairs
+using CertificateList = std::vector<std::pair<bcos::crypto::HashType, SignatureProofList>>;
+
+inline SignatureProofList signatureProofs(PBFTProposalInterface::Ptr _proposal)
+{
+    SignatureProofList proofs;
+    auto proofSize = _proposal->signatureProofSize();
+    for (size_t i = 0; i < proofSize; i++)
+    {
+        proofs.push_back(_proposal->signatureProof(i));
+    }
+    return proofs;
+}
+
+// verify the signature lists of the proposals, which prove that enough consensus nodes signed the
+// same hash
+class SignatureProofVerifier
+{
+public:
+    using Ptr = std::shared_ptr<SignatureProofVerifier>;
+    explicit SignatureProofVerifier(PublicKeyCache::Ptr _publicKeyCache)
+      : m_publicKeyCache(_publicKeyCache)
+    {}
+    virtual ~SignatureProofVerifier() {}
+
+    // return the weight of the signers, zero if any signature is invalid
+    virtual uint64_t verifyProofs(bcos::crypto::HashType const& _hash,
+        SignatureProofList const& _proofs, ConsensusNodeList const& _consensusNodes);
+    // verify the proofs of several hashes, return false once any proof is invalid, the weights of
+    // the signers are returned by _weights
+    // Note: the signature verification of all the proofs is fanned across the _verifyPool
+    virtual bool batchVerifyProofs(CertificateList const& _certificates,
+        ConsensusNodeList const& _consensusNodes, ThreadPool::Ptr _verifyPool,
+        std::vector<uint64_t>& _weights);
+
+protected:
+    PublicKeyCache::Ptr m_publicKeyCache;
+    // the signatures verified by one task
+    const size_t c_verifyChunkSize = 8;
+};
+}  // namespace consensus
+}  // namespace bcos
@@ -0,0 +1,65 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief estimate the consensus timeout from the observed consensus latencies
+ * @file TimeoutEstimator.cpp
+ * @author: yujiechen
+ * @date 2021-06-25
+ */
+#include "TimeoutEstimator.h"
+#include <cmath>
+
+using namespace bcos;
+using namespace bcos::consensus;
+
+void TimeoutEstimator::updateLatency(IndexType _leaderIndex, uint64_t _latency)
+{
+    std::lock_guard<std::mutex> l(x_latencies);
+    auto it = m_latencies.find(_leaderIndex);
+    if (it == m_latencies.end())
+    {
+        LatencyEstimate estimate;
+        estimate.smoothedLatency = _latency;
+        estimate.latencyVariance = (double)_latency / 2;
+        m_latencies[_leaderIndex] = estimate;
+        return;
+    }
+    auto& estimate = it->second;
+    auto deviation = std::abs(estimate.smoothedLatency - (double)_latency);
+    estimate.latencyVariance =
+        (1 - c_varianceWeight) * estimate.latencyVariance + c_varianceWeight * deviation;
+    estimate.smoothedLatency =
+        (1 - c_latencyWeight) * estimate.smoothedLatency + c_latencyWeight * _latency;
+}
+
+uint64_t TimeoutEstimator::estimatedTimeout(IndexType _leaderIndex) const
+{
+    std::lock_guard<std::mutex> l(x_latencies);
+    auto it = m_latencies.find(_leaderIndex);
+    if (it == m_latencies.end())
+    {
+        return m_maxTimeout;
+    }
+    auto const& estimate = it->second;
+    auto timeout = (uint64_t)(
+        c_latencyMultiplier * (estimate.smoothedLatency + 4 * estimate.latencyVariance));
+    return std::min(std::max(timeout, minTimeout()), m_maxTimeout.load());
+}
+
+uint64_t TimeoutEstimator::timeout(IndexType _leaderIndex)
+{
+    auto timeout = estimatedTimeout(_leaderIndex);
+    return std::max((uint64_t)(timeout * (1 - m_jitter)), minTimeout());
+}
@@ -0,0 +1,108 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief estimate the consensus timeout from the observed consensus latencies
+ * @file TimeoutEstimator.h
+ * @author: yujiechen
+ * @date 2021-06-25
+ */
+#pragma once
+#include "bcos-pbft/core/Common.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <random>
+
+namespace bcos
+{
+namespace consensus
+{
+// Note: the timeout of every leader is estimated from the EWMA of the intervals covered by the
+// timer(from the last progress to the commit, including the sealing of the leader) like the TCP
+// retransmission timeout, and bounded by the configured consensus timeout. The timeout is shortened
+// by a random jitter drawn once per node to avoid all the nodes triggering view change together,
+// the timeout only changes with the estimate
+class TimeoutEstimator
+{
+public:
+    using Ptr = std::shared_ptr<TimeoutEstimator>;
+    explicit TimeoutEstimator(uint64_t _maxTimeout)
+      : m_maxTimeout(_maxTimeout), m_random(std::random_device{}())
+    {
+        drawJitter();
+    }
+    virtual ~TimeoutEstimator() {}
+
+    // the configured consensus timeout, the upper bound of the estimated timeout
+    virtual void setMaxTimeout(uint64_t _maxTimeout) { m_maxTimeout = _maxTimeout; }
+    virtual uint64_t maxTimeout() const { return m_maxTimeout; }
+    virtual void setMinTimeout(uint64_t _minTimeout) { m_minTimeout = _minTimeout; }
+    virtual uint64_t minTimeout() const
+    {
+        return std::min(m_minTimeout.load(), m_maxTimeout.load());
+    }
+    // the max ratio of the timeout shortened by the jitter
+    virtual void setJitterRatio(double _jitterRatio)
+    {
+        m_jitterRatio = _jitterRatio;
+        drawJitter();
+    }
+    virtual double jitter() const { return m_jitter; }
+
+    // update the latency(in ms) from the last progress to committing the proposal
+    virtual void updateLatency(IndexType _leaderIndex, uint64_t _latency);
+    // the timeout of the proposals proposed by the given leader
+    virtual uint64_t timeout(IndexType _leaderIndex);
+    // the estimated timeout without jitter, the max timeout for the leader without latency
+    virtual uint64_t estimatedTimeout(IndexType _leaderIndex) const;
+    // drop the latencies when the consensus node list changed
+    virtual void reset()
+    {
+        std::lock_guard<std::mutex> l(x_latencies);
+        m_latencies.clear();
+    }
+
+protected:
+    void drawJitter()
+    {
+        std::lock_guard<std::mutex> l(x_latencies);
+        m_jitter = std::uniform_real_distribution<double>(0, m_jitterRatio)(m_random);
+    }
+
+    struct LatencyEstimate
+    {
+        double smoothedLatency = 0;
+        double latencyVariance = 0;
+    };
+
+private:
+    std::atomic<uint64_t> m_maxTimeout;
+    std::atomic<uint64_t> m_minTimeout = {1000};
+    std::atomic<double> m_jitterRatio = {0.1};
+    std::atomic<double> m_jitter = {0};
+    // the timeout is the multiple of the estimated latency to tolerate the execution of the
+    // proposal and the fluctuation of the latency
+    const double c_latencyMultiplier = 3;
+    // the weights of the new latency sample
+    const double c_latencyWeight = 0.125;
+    const double c_varianceWeight = 0.25;
+
+    std::map<IndexType, LatencyEstimate> m_latencies;
+    mutable std::mutex x_latencies;
+    std::mt19937_64 m_random;
+};
+}  // namespace consensus
+}  // namespace bcos
@@ -0,0 +1,232 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief hierarchical timer wheel shared by all the PBFT timers
+ * @file TimerWheel.cpp
+ * @author: yujiechen
+ * @date 2021-06-24
+ */
+#include "TimerWheel.h"
+#include "bcos-pbft/pbft/utilities/Common.h"
+
+using namespace bcos;
+using namespace bcos::consensus;
+
+TimerWheel::TimerWheel(std::string const& _threadName, uint64_t _tickInterval)
+  : m_tickInterval(std::max(_tickInterval, (uint64_t)1)),
+    m_startTime(std::chrono::steady_clock::now()),
+    m_worker(std::make_shared<ThreadPool>(_threadName, 1))
+{
+    m_worker->enqueue([this]() { run(); });
+}
+
+uint64_t TimerWheel::currentTick() const
+{
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - m_startTime);
+    return elapsed.count() / m_tickInterval;
+}
+
+TimerWheel::TimerID TimerWheel::schedule(uint64_t _timeout, std::function<void()> _handler)
+{
+    auto elapsed = std::chrono::ceil<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - m_startTime);
+    // never trigger the timer before the timeout
+    uint64_t expiredTick = (elapsed.count() + _timeout + m_tickInterval - 1) / m_tickInterval;
+    bool notify = false;
+    TimerID timerID = 0;
+    {
+        std::lock_guard<std::mutex> l(x_wheel);
+        if (!m_running)
+        {
+            return 0;
+        }
+        // the wheel is idle: skip the elapsed ticks and drop the cancelled ids
+        if (m_timers.empty())
+        {
+            for (auto& level : m_slots)
+            {
+                for (auto& slot : level)
+                {
+                    slot.clear();
+                }
+            }
+            m_tick = std::max(m_tick, currentTick());
+        }
+        expiredTick = std::max(expiredTick, m_tick + 1);
+        timerID = (++m_timerID);
+        m_timers.emplace(timerID, TimerEntry{expiredTick, std::move(_handler)});
+        insert(timerID, expiredTick);
+        // wake up the worker only when the timer expires before the worker wakes up
+        notify = (expiredTick < m_wakeupTick);
+    }
+    if (notify)
+    {
+        m_signal.notify_one();
+    }
+    return timerID;
+}
+
+bool TimerWheel::cancel(TimerID _timerID)
+{
+    std::lock_guard<std::mutex> l(x_wheel);
+    // Note: the id in the slot is dropped lazily when the slot is processed
+    return (m_timers.erase(_timerID) > 0);
+}
+
+void TimerWheel::stop()
+{
+    {
+        std::lock_guard<std::mutex> l(x_wheel);
+        if (!m_running)
+        {
+            return;
+        }
+        m_running = false;
+        m_timers.clear();
+    }
+    m_signal.notify_all();
+    m_worker->stop();
+}
+
+void TimerWheel::insert(TimerID _timerID, uint64_t _expiredTick)
+{
+    // the cascaded timer expires at the current tick is triggered right after the cascade
+    auto expiredTick = std::max(_expiredTick, m_tick);
+    auto delta = expiredTick - m_tick;
+    for (size_t level = 0; level < c_levels; level++)
+    {
+        auto levelSpan = ((uint64_t)1 << (c_slotBits * (level + 1)));
+        if (delta >= levelSpan && level < c_levels - 1)
+        {
+            continue;
+        }
+        // the timers beyond the wheel are cascaded again when reaching the last slot
+        if (delta >= levelSpan)
+        {
+            expiredTick = m_tick + levelSpan - 1;
+        }
+        auto slot = (expiredTick >> (c_slotBits * level)) & c_slotMask;
+        m_slots[level][slot].emplace_back(_timerID);
+        return;
+    }
+}
+
+void TimerWheel::cascade(size_t _level)
+{
+    auto slot = (m_tick >> (c_slotBits * _level)) & c_slotMask;
+    std::vector<TimerID> timerIDs;
+    timerIDs.swap(m_slots[_level][slot]);
+    for (auto const& timerID : timerIDs)
+    {
+        auto it = m_timers.find(timerID);
+        if (it == m_timers.end())
+        {
+            continue;
+        }
+        insert(timerID, it->second.expiredTick);
+    }
+}
+
+void TimerWheel::tick(std::vector<std::function<void()>>& _expiredHandlers)
+{
+    m_tick++;
+    for (size_t level = 1; level < c_levels; level++)
+    {
+        if (((m_tick >> (c_slotBits * (level - 1))) & c_slotMask) != 0)
+        {
+            break;
+        }
+        cascade(level);
+    }
+    std::vector<TimerID> timerIDs;
+    timerIDs.swap(m_slots[0][m_tick & c_slotMask]);
+    for (auto const& timerID : timerIDs)
+    {
+        auto it = m_timers.find(timerID);
+        if (it == m_timers.end())
+        {
+            continue;
+        }
+        _expiredHandlers.emplace_back(std::move(it->second.handler));
+        m_timers.erase(it);
+    }
+}
+
+void TimerWheel::advanceTo(uint64_t _tick, std::vector<std::function<void()>>& _expiredHandlers)
+{
+    while (m_tick < _tick && !m_timers.empty())
+    {
+        tick(_expiredHandlers);
+    }
+    m_tick = std::max(m_tick, _tick);
+}
+
+uint64_t TimerWheel::nextWakeupTick() const
+{
+    for (uint64_t tick = m_tick + 1;; tick++)
+    {
+        // wake up at the boundary of the level to cascade the timers of the upper levels
+        if ((tick & c_slotMask) == 0 || !m_slots[0][tick & c_slotMask].empty())
+        {
+            return tick;
+        }
+    }
+}
+
+void TimerWheel::run()
+{
+    std::unique_lock<std::mutex> l(x_wheel);
+    while (m_running)
+    {
+        if (m_timers.empty())
+        {
+            m_wakeupTick = UINT64_MAX;
+            m_signal.wait(l);
+            m_wakeups++;
+            continue;
+        }
+        m_wakeupTick = nextWakeupTick();
+        m_signal.wait_until(
+            l, m_startTime + std::chrono::milliseconds(m_wakeupTick * m_tickInterval));
+        m_wakeups++;
+        if (!m_running)
+        {
+            break;
+        }
+        std::vector<std::function<void()>> expiredHandlers;
+        advanceTo(currentTick(), expiredHandlers);
+        if (expiredHandlers.empty())
+        {
+            continue;
+        }
+        // trigger the handlers without the lock, the handlers may schedule new timers
+        m_wakeupTick = 0;
+        l.unlock();
+        for (auto const& handler : expiredHandlers)
+        {
+            try
+            {
+                handler();
+            }
+            catch (std::exception const& e)
+            {
+                PBFT_LOG(WARNING) << LOG_DESC("TimerWheel: trigger timer exception")
+                                  << LOG_KV("error", boost::diagnostic_information(e));
+            }
+        }
+        l.lock();
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief hierarchical timer wheel shared by all the PBFT timers
+ * @file TimerWheel.h
+ * @author: yujiechen
+ * @date 2021-06-24
+ */
+#pragma once
+#include <bcos-framework/libutilities/ThreadPool.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace bcos
+{
+namespace consensus
+{
+// Note: all the timers share one worker thread, scheduling and cancelling a timer only touch the
+// slots of the wheel, and the worker sleeps until the nearest non-empty slot instead of waking up
+// every tick
+class TimerWheel
+{
+public:
+    using Ptr = std::shared_ptr<TimerWheel>;
+    using TimerID = uint64_t;
+    // @param _tickInterval: the precision(in ms) of the timers
+    explicit TimerWheel(std::string const& _threadName, uint64_t _tickInterval = 10);
+    virtual ~TimerWheel() { stop(); }
+
+    // call the handler on the worker thread after _timeout ms, return the id to cancel the timer
+    virtual TimerID schedule(uint64_t _timeout, std::function<void()> _handler);
+    // return false when the timer has already been triggered or cancelled
+    virtual bool cancel(TimerID _timerID);
+    // drop all the pending timers and stop the worker
+    virtual void stop();
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> l(x_wheel);
+        return m_timers.size();
+    }
+    // the times the worker woke up, for the benchmark
+    uint64_t wakeups() const { return m_wakeups; }
+    uint64_t tickInterval() const { return m_tickInterval; }
+
+protected:
+    struct TimerEntry
+    {
+        uint64_t expiredTick;
+        std::function<void()> handler;
+    };
+    void run();
+    // move the wheel to the given tick, and collect the expired handlers
+    void advanceTo(uint64_t _tick, std::vector<std::function<void()>>& _expiredHandlers);
+    void tick(std::vector<std::function<void()>>& _expiredHandlers);
+    void cascade(size_t _level);
+    void insert(TimerID _timerID, uint64_t _expiredTick);
+    // the tick the worker should wake up at, the next non-empty slot or the next cascade
+    uint64_t nextWakeupTick() const;
+    uint64_t currentTick() const;
+
+private:
+    static const size_t c_slotBits = 6;
+    static const size_t c_slotSize = (1 << c_slotBits);
+    static const size_t c_slotMask = c_slotSize - 1;
+    static const size_t c_levels = 4;
+
+    uint64_t const m_tickInterval;
+    std::chrono::steady_clock::time_point const m_startTime;
+    // every slot records the ids of the timers, the cancelled ids are dropped lazily
+    std::array<std::array<std::vector<TimerID>, c_slotSize>, c_levels> m_slots;
+    std::unordered_map<TimerID, TimerEntry> m_timers;
+    // the ticks before m_tick have been processed
+    uint64_t m_tick = 0;
+    uint64_t m_wakeupTick = UINT64_MAX;
+    TimerID m_timerID = 0;
+
+    bool m_running = true;
+    std::atomic<uint64_t> m_wakeups = {0};
+    mutable std::mutex x_wheel;
+    std::condition_variable m_signal;
+    ThreadPool::Ptr m_worker;
+};
+}  // namespace consensus
+}  // namespace bcos
@@ -20,6 +20,7 @@
  */
 #pragma once
 #include "../utilities/Common.h"
+#include "ParsedPublicKeyInterface.h"
 #include <bcos-framework/interfaces/consensus/ConsensusTypeDef.h>
 #include <bcos-framework/interfaces/crypto/CommonType.h>
 #include <bcos-framework/interfaces/crypto/CryptoSuite.h>
@@ -67,6 +68,11 @@ public:
     virtual void setSignatureDataHash(bcos::crypto::HashType const& _hash) = 0;
     virtual bool verifySignature(
         bcos::crypto::CryptoSuite::Ptr _cryptoSuite, bcos::crypto::PublicPtr _pubKey) = 0;
+    // verify with the pre-parsed public key of the signer
+    virtual bool verifySignature(ParsedPublicKeyInterface::Ptr _parsedKey)
+    {
+        return _parsedKey->verify(signatureDataHash(), signatureData());
+    }
 
     virtual void setFrom(bcos::crypto::PublicPtr _from) = 0;
     virtual bcos::crypto::PublicPtr from() const = 0;
@@ -72,6 +72,24 @@ public:
         return pbftRequest;
     }
 
+    virtual PBFTRequestInterface::Ptr populateFrom(
+        PacketType _packetType, ProposalKeyList const& _proposalKeys)
+    {
+        auto pbftRequest = createPBFTRequest();
+        pbftRequest->setPacketType(_packetType);
+        // the first key is also set into the base message for the single-key handler
+        if (!_proposalKeys.empty())
+        {
+            pbftRequest->setIndex(_proposalKeys[0].first);
+            pbftRequest->setHash(_proposalKeys[0].second);
+        }
+        for (auto const& proposalKey : _proposalKeys)
+        {
+            pbftRequest->appendProposalKey(proposalKey.first, proposalKey.second);
+        }
+        return pbftRequest;
+    }
+
     virtual PBFTMessageInterface::Ptr populateFrom(PacketType _packetType, int32_t _version,
         ViewType _view, int64_t _timestamp, IndexType _generatedFrom,
         PBFTProposalInterface::Ptr _proposal, bcos::crypto::CryptoSuite::Ptr _cryptoSuite,
@@ -20,10 +20,14 @@
  */
 #pragma once
 #include "PBFTBaseMessageInterface.h"
+#include <bcos-framework/interfaces/protocol/ProtocolTypeDef.h>
 namespace bcos
 {
 namespace consensus
 {
+using ProposalKey = std::pair<bcos::protocol::BlockNumber, bcos::crypto::HashType>;
+using ProposalKeyList = std::vector<ProposalKey>;
+
 class PBFTRequestInterface : virtual public PBFTBaseMessageInterface
 {
 public:
@@ -33,6 +37,11 @@ public:
 
     virtual void setSize(int64_t _size) = 0;
     virtual int64_t size() const = 0;
+
+    // the (index, hash) of the proposals requested by the batch request
+    virtual void appendProposalKey(
+        bcos::protocol::BlockNumber _index, bcos::crypto::HashType const& _hash) = 0;
+    virtual ProposalKeyList proposalKeys() const = 0;
 };
 }  // namespace consensus
 }  // namespace bcos
\ No newline at end of file
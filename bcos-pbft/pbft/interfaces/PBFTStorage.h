@@ -25,6 +25,7 @@
 #include <bcos-framework/interfaces/protocol/Block.h>
 #include <bcos-framework/interfaces/protocol/BlockHeader.h>
 #include <bcos-framework/interfaces/protocol/ProtocolTypeDef.h>
+#include <bcos-framework/libutilities/Error.h>
 namespace bcos
 {
 namespace consensus
@@ -37,10 +38,18 @@ public:
     virtual ~PBFTStorage() {}
 
     virtual PBFTProposalListPtr loadState(bcos::protocol::BlockNumber _stabledIndex) = 0;
+    // recover the committed proposals after _stabledIndex without blocking the caller
+    virtual void asyncLoadState(bcos::protocol::BlockNumber _stabledIndex,
+        std::function<void(Error::Ptr, PBFTProposalListPtr)> _onLoaded) = 0;
     virtual int64_t maxCommittedProposalIndex() = 0;
     virtual void asyncCommitProposal(PBFTProposalInterface::Ptr _commitProposal) = 0;
+    // _onPersisted is called when the committed proposal is durable in the storage
+    virtual void asyncCommitProposal(PBFTProposalInterface::Ptr _commitProposal,
+        std::function<void(Error::Ptr)> _onPersisted) = 0;
     virtual void asyncCommitStableCheckPoint(PBFTProposalInterface::Ptr _stableProposal) = 0;
     virtual void asyncRemoveStabledCheckPoint(size_t _stabledCheckPointIndex) = 0;
+    // release the resources of the proposals no larger than the block synced from other nodes
+    virtual void onSyncedBlock(bcos::protocol::BlockNumber _syncedIndex) = 0;
 
     // get the latest committed proposal from the storage
     virtual void asyncGetCommittedProposals(bcos::protocol::BlockNumber _start, size_t _offset,
@@ -0,0 +1,51 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief interface for the public key parsed once and used to verify many signatures
+ * @file ParsedPublicKeyInterface.h
+ * @author: yujiechen
+ * @date 2021-06-18
+ */
+#pragma once
+#include <bcos-framework/interfaces/crypto/KeyInterface.h>
+#include <bcos-framework/libutilities/FixedBytes.h>
+
+namespace bcos
+{
+namespace consensus
+{
+class ParsedPublicKeyInterface
+{
+public:
+    using Ptr = std::shared_ptr<ParsedPublicKeyInterface const>;
+    ParsedPublicKeyInterface() = default;
+    virtual ~ParsedPublicKeyInterface() {}
+
+    virtual bcos::crypto::PublicPtr nodeID() const = 0;
+    virtual bool verify(bcos::crypto::HashType const& _hash, bytesConstRef _signature) const = 0;
+};
+
+class ParsedPublicKeyFactory
+{
+public:
+    using Ptr = std::shared_ptr<ParsedPublicKeyFactory>;
+    ParsedPublicKeyFactory() = default;
+    virtual ~ParsedPublicKeyFactory() {}
+
+    // parse the public key of the node
+    virtual ParsedPublicKeyInterface::Ptr createParsedPublicKey(bcos::crypto::PublicPtr _nodeID) = 0;
+};
+}  // namespace consensus
+}  // namespace bcos
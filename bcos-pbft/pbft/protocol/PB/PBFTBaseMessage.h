@@ -100,6 +100,7 @@ public:
         m_dataHash = _hash;
         m_baseMessage->set_signaturehash(_hash.data(), bcos::crypto::HashType::size);
     }
+    using PBFTBaseMessageInterface::verifySignature;
     bool verifySignature(
         bcos::crypto::CryptoSuite::Ptr _cryptoSuite, bcos::crypto::PublicPtr _pubKey) override
     {
@@ -74,6 +74,11 @@ PBFTBaseMessageInterface::Ptr PBFTCodec::decode(bytesConstRef _data) const
     case PacketType::CheckPoint:
     case PacketType::RecoverRequest:
     case PacketType::RecoverResponse:
+    case PacketType::PrePrepareBatchPacket:
+    case PacketType::PrepareBatchPacket:
+    case PacketType::CommitBatchPacket:
+    case PacketType::PrepareCertificatePacket:
+    case PacketType::CommitCertificatePacket:
         decodedMsg = m_pbftMessageFactory->createPBFTMsg(m_cryptoSuite, payLoadRefData);
         break;
     case PacketType::PreparedProposalResponse:
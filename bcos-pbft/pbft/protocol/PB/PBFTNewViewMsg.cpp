@@ -21,8 +21,10 @@
 
 #include "PBFTNewViewMsg.h"
 #include "PBFTMessage.h"
+#include "PBFTProposal.h"
 #include "PBFTViewChangeMsg.h"
 #include <bcos-framework/libprotocol/Common.h>
+#include <map>
 
 using namespace bcos;
 using namespace bcos::consensus;
@@ -30,7 +32,112 @@ using namespace bcos::protocol;
 using namespace bcos::crypto;
 bytesPointer PBFTNewViewMsg::encode(CryptoSuite::Ptr, KeyPairInterface::Ptr) const
 {
-    return encodePBObject(m_rawNewView);
+    // the nodes of the lower version can't decode the certificate table
+    bool withCertificateTable = (version() >= c_newViewCertificateTableVersion);
+    if (!withCertificateTable && !hasSharedCertificate())
+    {
+        return encodePBObject(m_rawNewView);
+    }
+    // Note: the viewChanges share the raw messages with the cache, so the signature proofs are
+    // moved into the table(or inlined for the lower version) on the copies of the viewChanges
+    auto rawNewView = std::make_shared<RawNewViewMessage>();
+    using CertificateKey = std::pair<std::string, std::vector<int64_t>>;
+    std::map<CertificateKey, int64_t> certificateRefs;
+    for (auto const& viewChange : *m_viewChangeList)
+    {
+        auto pbViewChange = std::dynamic_pointer_cast<PBFTViewChangeMsg>(viewChange);
+        auto rawViewChange = rawNewView->add_viewchangemsglist();
+        *rawViewChange = *(pbViewChange->rawViewChange());
+        auto const& preparedProposals = viewChange->preparedProposals();
+        for (int i = 0; i < rawViewChange->preparedproposals_size(); i++)
+        {
+            auto proposal = std::dynamic_pointer_cast<PBFTProposal>(
+                preparedProposals.at(i)->consensusProposal());
+            if (!proposal || proposal->signatureProofSize() == 0)
+            {
+                continue;
+            }
+            auto certificate = proposal->certificate();
+            auto rawProposal =
+                rawViewChange->mutable_preparedproposals(i)->mutable_consensusproposal();
+            if (!withCertificateTable)
+            {
+                // inline the proofs decoded from the certificate table of another NewView message
+                if (proposal->sharedCertificate())
+                {
+                    *rawProposal->mutable_nodelist() = certificate->nodelist();
+                    *rawProposal->mutable_signaturelist() = certificate->signaturelist();
+                    rawProposal->set_certificateref(0);
+                }
+                continue;
+            }
+            CertificateKey key(
+                std::to_string(rawProposal->proposal().index()) + rawProposal->proposal().hash(),
+                std::vector<int64_t>(
+                    certificate->nodelist().begin(), certificate->nodelist().end()));
+            auto it = certificateRefs.find(key);
+            if (it == certificateRefs.end())
+            {
+                auto tableEntry = rawNewView->add_certificates();
+                if (proposal->sharedCertificate())
+                {
+                    *tableEntry->mutable_nodelist() = certificate->nodelist();
+                    *tableEntry->mutable_signaturelist() = certificate->signaturelist();
+                }
+                else
+                {
+                    // the copied proofs are moved into the table
+                    tableEntry->mutable_nodelist()->Swap(rawProposal->mutable_nodelist());
+                    tableEntry->mutable_signaturelist()->Swap(rawProposal->mutable_signaturelist());
+                }
+                it = certificateRefs.emplace(key, rawNewView->certificates_size()).first;
+            }
+            rawProposal->clear_nodelist();
+            rawProposal->clear_signaturelist();
+            rawProposal->set_certificateref(it->second);
+        }
+    }
+    // the base message and the prePrepares are only read, borrow them instead of copying
+    rawNewView->unsafe_arena_set_allocated_message(m_rawNewView->mutable_message());
+    for (auto& prePrepare : *(m_rawNewView->mutable_prepreparelist()))
+    {
+        rawNewView->mutable_prepreparelist()->UnsafeArenaAddAllocated(&prePrepare);
+    }
+    auto giveBack = [&]() {
+        rawNewView->unsafe_arena_release_message();
+        auto prePrepareSize = rawNewView->prepreparelist_size();
+        for (auto i = 0; i < prePrepareSize; i++)
+        {
+            rawNewView->mutable_prepreparelist()->UnsafeArenaReleaseLast();
+        }
+    };
+    try
+    {
+        auto encodedData = encodePBObject(rawNewView);
+        giveBack();
+        return encodedData;
+    }
+    catch (...)
+    {
+        giveBack();
+        throw;
+    }
+}
+
+bool PBFTNewViewMsg::hasSharedCertificate() const
+{
+    for (auto const& viewChange : *m_viewChangeList)
+    {
+        for (auto const& precommit : viewChange->preparedProposals())
+        {
+            auto proposal = std::dynamic_pointer_cast<PBFTProposal>(precommit->consensusProposal());
+            if (proposal && proposal->sharedCertificate())
+            {
+                return true;
+            }
+        }
+    }
+    return false;
 }
 
 void PBFTNewViewMsg::decode(bytesConstRef _data)
@@ -43,12 +150,39 @@ void PBFTNewViewMsg::decode(bytesConstRef _data)
 void PBFTNewViewMsg::deserializeToObject()
 {
     PBFTBaseMessage::deserializeToObject();
+    // the certificates are owned by the proposals referencing them
+    std::vector<std::shared_ptr<PBFTRawProposal>> certificates;
+    // only the messages since the certificate table version reference the table
+    if (version() >= c_newViewCertificateTableVersion)
+    {
+        certificates.resize(m_rawNewView->certificates_size());
+        for (auto i = (int64_t)certificates.size() - 1; i >= 0; i--)
+        {
+            certificates[i].reset(m_rawNewView->mutable_certificates()->ReleaseLast());
+        }
+    }
     // decode into m_viewChangeList
     for (int i = 0; i < m_rawNewView->viewchangemsglist_size(); i++)
     {
         std::shared_ptr<RawViewChangeMessage> pbRawViewChange(
             m_rawNewView->mutable_viewchangemsglist(i));
-        m_viewChangeList->push_back(std::make_shared<PBFTViewChangeMsg>(pbRawViewChange));
+        auto viewChange = std::make_shared<PBFTViewChangeMsg>(pbRawViewChange);
+        // reference the signature proofs in the certificate table without copying
+        for (auto const& precommit : viewChange->preparedProposals())
+        {
+            auto proposal = std::dynamic_pointer_cast<PBFTProposal>(precommit->consensusProposal());
+            if (!proposal)
+            {
+                continue;
+            }
+            auto certificateRef = proposal->pbftRawProposal()->certificateref();
+            if (certificateRef <= 0 || certificateRef > (int64_t)certificates.size())
+            {
+                continue;
+            }
+            proposal->setCertificate(certificates[certificateRef - 1]);
+        }
+        m_viewChangeList->push_back(viewChange);
     }
     // decode into m_prePrepareList
     for (int i = 0; i < m_rawNewView->prepreparelist_size(); i++)
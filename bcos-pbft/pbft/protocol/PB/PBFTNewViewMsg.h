@@ -77,6 +77,8 @@ public:
 
 protected:
     void deserializeToObject() override;
+    // whether the prepared proposals reference the certificate table of the decoded message
+    bool hasSharedCertificate() const;
 
 private:
     std::shared_ptr<RawNewViewMessage> m_rawNewView;
@@ -49,24 +49,45 @@ public:
 
     std::shared_ptr<PBFTRawProposal> pbftRawProposal() { return m_pbftRawProposal; }
 
-    size_t signatureProofSize() const override { return m_pbftRawProposal->signaturelist_size(); }
+    // the signature proofs shared with the other proposals decoded from the same NewView message
+    void setCertificate(std::shared_ptr<PBFTRawProposal> _certificate)
+    {
+        m_certificate = _certificate;
+    }
+    // whether the signature proofs are shared with the certificate table of a NewView message
+    bool sharedCertificate() const { return m_certificate != nullptr; }
+    // the raw proposal holding the signature proofs
+    std::shared_ptr<PBFTRawProposal> certificate() const
+    {
+        if (m_certificate)
+        {
+            return m_certificate;
+        }
+        return m_pbftRawProposal;
+    }
+
+    size_t signatureProofSize() const override { return certificate()->signaturelist_size(); }
 
     std::pair<int64_t, bytesConstRef> signatureProof(size_t _index) const override
     {
-        auto const& signatureData = m_pbftRawProposal->signaturelist(_index);
+        auto const& proofs = m_certificate ? *m_certificate : *m_pbftRawProposal;
+        auto const& signatureData = proofs.signaturelist(_index);
         auto signatureDataRef =
             bytesConstRef((byte const*)signatureData.c_str(), signatureData.size());
-        return std::make_pair(m_pbftRawProposal->nodelist(_index), signatureDataRef);
+        return std::make_pair(proofs.nodelist(_index), signatureDataRef);
     }
 
     void appendSignatureProof(int64_t _nodeIdx, bytesConstRef _signatureData) override
     {
+        detachCertificate();
         m_pbftRawProposal->add_nodelist(_nodeIdx);
         m_pbftRawProposal->add_signaturelist(_signatureData.data(), _signatureData.size());
     }
 
     void clearSignatureProof() override
     {
+        m_certificate = nullptr;
+        m_pbftRawProposal->set_certificateref(0);
         m_pbftRawProposal->clear_nodelist();
         m_pbftRawProposal->clear_signaturelist();
     }
@@ -101,7 +122,16 @@ public:
 
     bytesPointer encode() const override
     {
-        return bcos::protocol::encodePBObject(m_pbftRawProposal);
+        if (!m_certificate)
+        {
+            return bcos::protocol::encodePBObject(m_pbftRawProposal);
+        }
+        // encode with the shared signature proofs
+        auto pbftRawProposal = std::make_shared<PBFTRawProposal>(*m_pbftRawProposal);
+        *pbftRawProposal->mutable_nodelist() = m_certificate->nodelist();
+        *pbftRawProposal->mutable_signaturelist() = m_certificate->signaturelist();
+        pbftRawProposal->set_certificateref(0);
+        return bcos::protocol::encodePBObject(pbftRawProposal);
     }
     void decode(bytesConstRef _data) override
     {
@@ -110,7 +140,21 @@ public:
     }
 
 private:
+    // copy the shared signature proofs before modifying them
+    void detachCertificate()
+    {
+        if (!m_certificate)
+        {
+            return;
+        }
+        *m_pbftRawProposal->mutable_nodelist() = m_certificate->nodelist();
+        *m_pbftRawProposal->mutable_signaturelist() = m_certificate->signaturelist();
+        m_pbftRawProposal->set_certificateref(0);
+        m_certificate = nullptr;
+    }
+
     std::shared_ptr<PBFTRawProposal> m_pbftRawProposal;
+    std::shared_ptr<PBFTRawProposal> m_certificate;
 };
 }  // namespace consensus
 }  // namespace bcos
\ No newline at end of file
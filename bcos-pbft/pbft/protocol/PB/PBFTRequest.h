@@ -47,6 +47,31 @@ public:
     void setSize(int64_t _size) override { m_pbRequest->set_size(_size); }
     int64_t size() const override { return m_pbRequest->size(); }
 
+    void appendProposalKey(
+        bcos::protocol::BlockNumber _index, bcos::crypto::HashType const& _hash) override
+    {
+        auto proposalKey = m_pbRequest->add_proposalkeys();
+        proposalKey->set_index(_index);
+        proposalKey->set_hash(_hash.data(), bcos::crypto::HashType::size);
+    }
+
+    ProposalKeyList proposalKeys() const override
+    {
+        ProposalKeyList proposalKeys;
+        for (auto const& proposalKey : m_pbRequest->proposalkeys())
+        {
+            auto const& hashData = proposalKey.hash();
+            if (hashData.size() < bcos::crypto::HashType::size)
+            {
+                continue;
+            }
+            proposalKeys.emplace_back(proposalKey.index(),
+                bcos::crypto::HashType(
+                    (byte const*)hashData.data(), bcos::crypto::HashType::size));
+        }
+        return proposalKeys;
+    }
+
     bytesPointer encode(
         bcos::crypto::CryptoSuite::Ptr, bcos::crypto::KeyPairInterface::Ptr) const override
     {
@@ -66,7 +91,7 @@ public:
         {
             return false;
         }
-        return _pbftRequest.size() == size();
+        return _pbftRequest.size() == size() && _pbftRequest.proposalKeys() == proposalKeys();
     }
 
 private:
@@ -23,6 +23,9 @@
 #include <bcos-framework/interfaces/protocol/CommonError.h>
 #include <bcos-framework/interfaces/protocol/ProtocolTypeDef.h>
 #include <bcos-framework/interfaces/storage/Table.h>
+#include <future>
+#include <mutex>
+#include <thread>
 
 using namespace bcos;
 using namespace bcos::consensus;
@@ -32,25 +35,77 @@ using namespace bcos::storage;
 
 PBFTProposalListPtr LedgerStorage::loadState(BlockNumber _stabledIndex)
 {
-    m_maxCommittedProposalIndexFetched = false;
-    asyncGetLatestCommittedProposalIndex();
-    auto startT = utcSteadyTime();
-    while (utcSteadyTime() - startT < m_timeout)
+    auto result = std::make_shared<std::promise<std::pair<Error::Ptr, PBFTProposalListPtr>>>();
+    auto future = result->get_future();
+    asyncLoadState(_stabledIndex, [result](Error::Ptr _error, PBFTProposalListPtr _proposals) {
+        result->set_value(std::make_pair(_error, _proposals));
+    });
+    if (future.wait_for(std::chrono::milliseconds(m_timeout)) != std::future_status::ready)
     {
-        if (m_maxCommittedProposalIndexFetched)
-        {
-            break;
-        }
-        boost::unique_lock<boost::mutex> l(x_signalled);
-        m_signalled.wait_for(l, boost::chrono::milliseconds(10));
+        PBFT_STORAGE_LOG(WARNING) << LOG_DESC("loadState failed for timeout");
+        BOOST_THROW_EXCEPTION(
+            InitPBFTException() << errinfo_comment("loadState failed for timeout"));
     }
-    if (!m_maxCommittedProposalIndexFetched)
+    auto ret = future.get();
+    if (ret.first)
     {
-        PBFT_STORAGE_LOG(WARNING) << LOG_DESC(
-            "loadState failed for fetch maxCommittedProposalIndex failed");
-        BOOST_THROW_EXCEPTION(InitPBFTException() << errinfo_comment(
-                                  "loadState failed for fetch maxCommittedProposalIndex failed"));
+        BOOST_THROW_EXCEPTION(
+            InitPBFTException() << errinfo_comment(
+                "loadState failed, code: " + std::to_string(ret.first->errorCode()) +
+                ", message:" + ret.first->errorMessage()));
     }
+    return ret.second;
+}
+
+Error::Ptr LedgerStorage::storageReleasedError()
+{
+    return std::make_shared<Error>(PBFTErrorCode::StorageReleased, "the storage is released");
+}
+
+Error::Ptr LedgerStorage::storageExceptionError(std::exception const& _e)
+{
+    return std::make_shared<Error>(
+        PBFTErrorCode::StorageException, boost::diagnostic_information(_e));
+}
+
+// Note: _onLoaded is called exactly once on every path
+void LedgerStorage::asyncLoadState(
+    BlockNumber _stabledIndex, std::function<void(Error::Ptr, PBFTProposalListPtr)> _onLoaded)
+{
+    auto self = std::weak_ptr<LedgerStorage>(shared_from_this());
+    asyncCreateKVTable(m_pbftCommitDB, [self, _stabledIndex, _onLoaded](Error::Ptr _error) {
+        if (_error)
+        {
+            _onLoaded(_error, nullptr);
+            return;
+        }
+        auto storage = self.lock();
+        if (!storage)
+        {
+            _onLoaded(storageReleasedError(), nullptr);
+            return;
+        }
+        storage->asyncGetLatestCommittedProposalIndex(
+            [self, _stabledIndex, _onLoaded](Error::Ptr _error) {
+                if (_error)
+                {
+                    _onLoaded(_error, nullptr);
+                    return;
+                }
+                auto storage = self.lock();
+                if (!storage)
+                {
+                    _onLoaded(storageReleasedError(), nullptr);
+                    return;
+                }
+                storage->onLatestCommittedProposalIndexFetched(_stabledIndex, _onLoaded);
+            });
+    });
+}
+
+void LedgerStorage::onLatestCommittedProposalIndexFetched(
+    BlockNumber _stabledIndex, std::function<void(Error::Ptr, PBFTProposalListPtr)> _onLoaded)
+{
     // fetch the committed proposals
     if (m_maxCommittedProposalIndex <= _stabledIndex)
     {
@@ -58,86 +113,126 @@ PBFTProposalListPtr LedgerStorage::loadState(BlockNumber _stabledIndex)
                                << LOG_KV("maxCommittedProposal", m_maxCommittedProposalIndex)
                                << LOG_KV("stableCheckPoint", _stabledIndex);
         m_maxCommittedProposalIndex = _stabledIndex;
-        return nullptr;
+        m_maxPersistedProposalIndex = _stabledIndex;
+        _onLoaded(nullptr, nullptr);
+        return;
     }
-    auto offset = (m_maxCommittedProposalIndex - _stabledIndex);
     PBFT_STORAGE_LOG(INFO) << LOG_DESC("recover committed proposal from the storage")
                            << LOG_KV("start", _stabledIndex + 1)
-                           << LOG_KV("end", m_maxCommittedProposalIndex) << LOG_KV("size", offset);
-
-    m_stateFetched = false;
+                           << LOG_KV("end", m_maxCommittedProposalIndex)
+                           << LOG_KV("size", (m_maxCommittedProposalIndex - _stabledIndex));
     auto self = std::weak_ptr<LedgerStorage>(shared_from_this());
-    asyncGetCommittedProposals(
-        _stabledIndex + 1, offset, [self](PBFTProposalListPtr _proposalList) {
-            try
+    asyncFetchCommittedProposals(_stabledIndex + 1, m_maxCommittedProposalIndex,
+        [self, _stabledIndex, _onLoaded](Error::Ptr _error, PBFTProposalListPtr _proposals) {
+            if (_error)
             {
-                auto storage = self.lock();
-                if (!storage)
-                {
-                    return;
-                }
-                if (_proposalList)
-                {
-                    storage->m_stateProposals = _proposalList;
-                }
-                storage->m_stateFetched = true;
-                storage->m_signalled.notify_all();
+                _onLoaded(_error, nullptr);
+                return;
             }
-            catch (std::exception const& e)
+            auto storage = self.lock();
+            if (!storage)
             {
-                PBFT_STORAGE_LOG(WARNING)
-                    << LOG_DESC(
-                           "The committedProposals have been received, but the "
-                           "callback is called exception")
-                    << LOG_KV("error", boost::diagnostic_information(e));
+                _onLoaded(storageReleasedError(), nullptr);
+                return;
             }
+            if (!_proposals || _proposals->size() == 0)
+            {
+                storage->m_maxCommittedProposalIndex = _stabledIndex;
+                storage->m_maxPersistedProposalIndex = _stabledIndex;
+            }
+            _onLoaded(nullptr, _proposals);
         });
-    startT = utcSteadyTime();
-    while (utcSteadyTime() - startT < m_timeout)
-    {
-        if (m_stateFetched)
-        {
-            break;
-        }
-        boost::unique_lock<boost::mutex> l(x_signalled);
-        m_signalled.wait_for(l, boost::chrono::milliseconds(10));
-    }
-    if (!m_stateFetched)
+}
+
+void LedgerStorage::asyncFetchCommittedProposals(BlockNumber _start, BlockNumber _end,
+    std::function<void(Error::Ptr, PBFTProposalListPtr)> _onFetched)
+{
+    struct FetchState
     {
-        PBFT_STORAGE_LOG(WARNING) << LOG_DESC(
-            "loadState failed for fetch committedProposal failed");
-        BOOST_THROW_EXCEPTION(InitPBFTException() << errinfo_comment(
-                                  "loadState failed for fetch committedProposal failed"));
-    }
-    if (!m_stateProposals || m_stateProposals->size() == 0)
+        std::vector<PBFTProposalListPtr> batches;
+        std::atomic<size_t> pendingBatches = {0};
+        Error::Ptr error = nullptr;
+        std::mutex mutex;
+    };
+    auto batchSize = c_loadStateBatchSize;
+    auto batchCount = (size_t)((_end - _start + batchSize) / batchSize);
+    auto state = std::make_shared<FetchState>();
+    state->batches.resize(batchCount);
+    state->pendingBatches = batchCount;
+    // issue all the batch reads at once, the last finished batch merges the proposals in order
+    for (size_t i = 0; i < batchCount; i++)
     {
-        m_maxCommittedProposalIndex = _stabledIndex;
+        auto batchStart = _start + (BlockNumber)i * batchSize;
+        auto batchEnd = std::min(_end, batchStart + batchSize - 1);
+        asyncGetProposalBatch(batchStart, batchEnd,
+            [state, i, _onFetched](Error::Ptr _error, PBFTProposalListPtr _proposals) {
+                if (_error)
+                {
+                    std::lock_guard<std::mutex> l(state->mutex);
+                    state->error = _error;
+                }
+                state->batches[i] = _proposals;
+                if (--state->pendingBatches > 0)
+                {
+                    return;
+                }
+                if (state->error)
+                {
+                    _onFetched(state->error, nullptr);
+                    return;
+                }
+                auto proposalList = std::make_shared<PBFTProposalList>();
+                for (auto const& batch : state->batches)
+                {
+                    // some committed proposals are missing
+                    if (!batch)
+                    {
+                        _onFetched(nullptr, nullptr);
+                        return;
+                    }
+                    proposalList->insert(proposalList->end(), batch->begin(), batch->end());
+                }
+                _onFetched(nullptr, proposalList);
+            });
     }
-    return m_stateProposals;
 }
 
 void LedgerStorage::asyncGetCommittedProposals(
     BlockNumber _start, size_t _offset, std::function<void(PBFTProposalListPtr)> _onSuccess)
 {
     // Note: The called program must effectively handle exceptions
-    if (_start > m_maxCommittedProposalIndex)
+    // Note: the queued proposals are not readable until flushed
+    if (_start > m_maxPersistedProposalIndex)
     {
         PBFT_STORAGE_LOG(WARNING) << LOG_DESC("asyncGetCommittedProposals failed")
                                   << LOG_KV(
-                                         "maxCommittedProposalIndex", m_maxCommittedProposalIndex)
+                                         "maxPersistedProposalIndex", m_maxPersistedProposalIndex)
                                   << LOG_KV("requestedMinIndex", _start);
         return;
     }
-    auto keys = std::make_shared<std::vector<std::string>>();
     auto endIndex =
-        std::min((int64_t)(_start + _offset - 1), (int64_t)m_maxCommittedProposalIndex.load());
-    for (int64_t i = _start; i <= endIndex; i++)
+        std::min((int64_t)(_start + _offset - 1), (int64_t)m_maxPersistedProposalIndex.load());
+    asyncGetProposalBatch(
+        _start, endIndex, [_onSuccess](Error::Ptr _error, PBFTProposalListPtr _proposals) {
+            if (_error)
+            {
+                return;
+            }
+            _onSuccess(_proposals);
+        });
+}
+
+void LedgerStorage::asyncGetProposalBatch(BlockNumber _start, BlockNumber _end,
+    std::function<void(Error::Ptr, PBFTProposalListPtr)> _onFetched)
+{
+    auto keys = std::make_shared<std::vector<std::string>>();
+    for (int64_t i = _start; i <= _end; i++)
     {
-        keys->push_back(boost::lexical_cast<std::string>(i));
+        keys->push_back(proposalKey(i));
     }
     auto self = std::weak_ptr<LedgerStorage>(shared_from_this());
     m_storage->asyncGetBatch(m_pbftCommitDB, keys,
-        [self, _onSuccess](
+        [self, _onFetched](
             Error::UniquePtr&& _error, std::shared_ptr<std::vector<std::string>>&& _values) {
             if (_error != nullptr)
             {
@@ -145,16 +240,20 @@ void LedgerStorage::asyncGetCommittedProposals(
                     << LOG_DESC("asyncGetCommittedProposals: get proposals failed")
                     << LOG_KV("error", _error->errorCode())
                     << LOG_KV("errorMessage", _error->errorMessage());
+                _onFetched(std::move(_error), nullptr);
                 return;
             }
+            auto storage = self.lock();
+            if (!storage)
+            {
+                _onFetched(storageReleasedError(), nullptr);
+                return;
+            }
+            // Note: _onFetched is called outside the try-block to be called exactly once
+            Error::Ptr error = nullptr;
+            auto proposalList = std::make_shared<PBFTProposalList>();
             try
             {
-                auto storage = self.lock();
-                if (!storage)
-                {
-                    return;
-                }
-                auto proposalList = std::make_shared<PBFTProposalList>();
                 for (auto const& value : *_values)
                 {
                     if (value.empty())
@@ -162,60 +261,62 @@ void LedgerStorage::asyncGetCommittedProposals(
                         PBFT_STORAGE_LOG(INFO)
                             << LOG_DESC("asyncGetCommittedProposals: empty committed proposal")
                             << LOG_KV("valuesSize", _values->size());
-                        _onSuccess(nullptr);
-                        return;
+                        proposalList = nullptr;
+                        break;
                     }
                     auto proposalData = bytesConstRef((byte const*)value.data(), value.size());
                     proposalList->push_back(
                         storage->m_messageFactory->createPBFTProposal(proposalData));
                 }
-                _onSuccess(proposalList);
-                PBFT_STORAGE_LOG(INFO) << LOG_DESC("asyncGetCommittedProposals success")
-                                       << LOG_KV("proposals", proposalList->size());
             }
             catch (std::exception const& e)
             {
                 PBFT_STORAGE_LOG(WARNING) << LOG_DESC("asyncGetCommittedProposals exception")
                                           << LOG_KV("error", boost::diagnostic_information(e));
+                error = storageExceptionError(e);
+                proposalList = nullptr;
+            }
+            if (proposalList)
+            {
+                PBFT_STORAGE_LOG(INFO) << LOG_DESC("asyncGetCommittedProposals success")
+                                       << LOG_KV("proposals", proposalList->size());
             }
+            _onFetched(error, proposalList);
         });
 }
 
-void LedgerStorage::asyncGetLatestCommittedProposalIndex()
+void LedgerStorage::asyncGetLatestCommittedProposalIndex(std::function<void(Error::Ptr)> _onFetched)
 {
     auto self = std::weak_ptr<LedgerStorage>(shared_from_this());
     m_storage->asyncGet(m_pbftCommitDB, m_maxCommittedProposalKey,
-        [self](Error::UniquePtr&& _error, std::string_view&& _value) {
+        [self, _onFetched](Error::UniquePtr&& _error, std::string_view&& _value) {
+            if (_error != nullptr)
+            {
+                PBFT_STORAGE_LOG(WARNING) << LOG_DESC("asyncGetLatestCommittedProposalIndex failed")
+                                          << LOG_KV("errorCode", _error->errorCode())
+                                          << LOG_KV("errorMessage", _error->errorMessage());
+                _onFetched(std::move(_error));
+                return;
+            }
+            auto storage = self.lock();
+            if (!storage)
+            {
+                _onFetched(storageReleasedError());
+                return;
+            }
+            // Note: _onFetched is called outside the try-block to be called exactly once
+            Error::Ptr error = nullptr;
             try
             {
-                auto storage = self.lock();
-                if (!storage)
+                if (_value.size() > 0)
                 {
-                    storage->m_signalled.notify_all();
-                    return;
-                }
-                if (_value.size() == 0)
-                {
-                    storage->m_maxCommittedProposalIndexFetched = true;
-                    storage->m_signalled.notify_all();
-                    return;
-                }
-                if (_error != nullptr)
-                {
-                    PBFT_STORAGE_LOG(WARNING)
-                        << LOG_DESC("asyncGetLatestCommittedProposalIndex failed")
-                        << LOG_KV("errorCode", _error->errorCode())
-                        << LOG_KV("errorMessage", _error->errorMessage());
-                    storage->m_signalled.notify_all();
-                    return;
-                }
-                auto latestCommittedProposalIndex = boost::lexical_cast<int64_t>(_value);
-                if (storage->m_maxCommittedProposalIndex < latestCommittedProposalIndex)
-                {
-                    storage->m_maxCommittedProposalIndex = latestCommittedProposalIndex;
+                    auto latestCommittedProposalIndex = boost::lexical_cast<int64_t>(_value);
+                    if (storage->m_maxCommittedProposalIndex < latestCommittedProposalIndex)
+                    {
+                        storage->m_maxCommittedProposalIndex = latestCommittedProposalIndex;
+                        storage->m_maxPersistedProposalIndex = latestCommittedProposalIndex;
+                    }
                 }
-                storage->m_maxCommittedProposalIndexFetched = true;
-                storage->m_signalled.notify_all();
                 PBFT_STORAGE_LOG(INFO)
                     << LOG_DESC("asyncGetLatestCommittedProposalIndex")
                     << LOG_KV("latestCommittedProposalIndex", storage->m_maxCommittedProposalIndex);
@@ -225,42 +326,247 @@ void LedgerStorage::asyncGetLatestCommittedProposalIndex()
                 PBFT_STORAGE_LOG(WARNING)
                     << LOG_DESC("asyncGetLatestCommittedProposalIndex exception")
                     << LOG_KV("error", boost::diagnostic_information(e));
+                error = storageExceptionError(e);
             }
+            _onFetched(error);
         });
 }
 
 void LedgerStorage::asyncCommitProposal(PBFTProposalInterface::Ptr _committedProposal)
 {
+    asyncCommitProposal(_committedProposal, nullptr);
+}
+
+void LedgerStorage::asyncCommitProposal(
+    PBFTProposalInterface::Ptr _committedProposal, std::function<void(Error::Ptr)> _onPersisted)
+{
+    if (m_maxPersistedProposalIndex.load() >= _committedProposal->index())
+    {
+        if (_onPersisted)
+        {
+            _onPersisted(nullptr);
+        }
+        return;
+    }
+    // the proposal has been queued, notify after the flush in progress
     if (m_maxCommittedProposalIndex.load() >= _committedProposal->index())
     {
+        if (_onPersisted)
+        {
+            std::lock_guard<std::mutex> l(x_pendingWrites);
+            m_pendingWrites.onPersisted.push_back(_onPersisted);
+        }
+        tryToScheduleFlush();
         return;
     }
     m_maxCommittedProposalIndex.store(_committedProposal->index());
-    PBFT_STORAGE_LOG(INFO) << LOG_DESC("asyncCommitProposal: write the committed proposal into db")
+    PBFT_STORAGE_LOG(INFO) << LOG_DESC("asyncCommitProposal: queue the committed proposal")
                            << LOG_KV("index", _committedProposal->index());
-    // commit the max-index proposal information
-    auto maxIndexStr = boost::lexical_cast<std::string>(m_maxCommittedProposalIndex);
-    auto maxIndexBytes = std::make_shared<bytes>(maxIndexStr.begin(), maxIndexStr.end());
-    asyncPutProposal(
-        m_pbftCommitDB, m_maxCommittedProposalKey, maxIndexBytes, _committedProposal->index());
-
-    // commit the data
     auto encodedData = _committedProposal->encode();
-    asyncPutProposal(m_pbftCommitDB, boost::lexical_cast<std::string>(_committedProposal->index()),
-        encodedData, _committedProposal->index());
+    auto committedData =
+        std::make_shared<std::string>((const char*)encodedData->data(), encodedData->size());
+    {
+        std::lock_guard<std::mutex> l(x_pendingWrites);
+        m_pendingWrites.proposals[_committedProposal->index()] = committedData;
+        m_pendingWrites.maxCommittedIndex =
+            std::max(m_pendingWrites.maxCommittedIndex, _committedProposal->index());
+        if (_onPersisted)
+        {
+            m_pendingWrites.onPersisted.push_back(_onPersisted);
+        }
+    }
+    tryToScheduleFlush();
+}
+
+void LedgerStorage::tryToScheduleFlush()
+{
+    {
+        std::lock_guard<std::mutex> l(x_pendingWrites);
+        // Note: only one flush is in flight, the writes queued meanwhile join the next flush
+        if (m_flushScheduled)
+        {
+            return;
+        }
+        m_flushScheduled = true;
+    }
+    scheduleFlush(m_flushInterval);
+}
+
+void LedgerStorage::scheduleFlush(uint64_t _delay)
+{
+    auto self = std::weak_ptr<LedgerStorage>(shared_from_this());
+    m_flushWorker->enqueue([self, _delay]() {
+        try
+        {
+            auto storage = self.lock();
+            if (!storage)
+            {
+                return;
+            }
+            // collect the writes arrived in the flush interval
+            std::this_thread::sleep_for(std::chrono::milliseconds(_delay));
+            storage->flush();
+        }
+        catch (std::exception const& e)
+        {
+            PBFT_STORAGE_LOG(WARNING) << LOG_DESC("flush exception")
+                                      << LOG_KV("error", boost::diagnostic_information(e));
+        }
+    });
+}
+
+void LedgerStorage::flush()
+{
+    auto writes = std::make_shared<PendingWrites>();
+    {
+        std::lock_guard<std::mutex> l(x_pendingWrites);
+        std::swap(*writes, m_pendingWrites);
+    }
+    PBFT_STORAGE_LOG(INFO) << LOG_DESC("flush the commit table")
+                           << LOG_KV("proposals", writes->proposals.size())
+                           << LOG_KV("maxCommittedIndex", writes->maxCommittedIndex)
+                           << LOG_KV("removed", writes->removedIndexes.size())
+                           << LOG_KV("retryTime", m_flushRetryTime);
+    for (auto const& index : writes->removedIndexes)
+    {
+        asyncRemove(m_pbftCommitDB, proposalKey(index));
+    }
+    writes->removedIndexes.clear();
+    if (writes->proposals.empty())
+    {
+        onFlushFinished(writes, nullptr);
+        return;
+    }
+    // Note: the max committed proposal index is written after all the proposals are durable, so
+    // that the recovered index never points to a missing proposal
+    auto pendingPuts = std::make_shared<std::atomic<size_t>>(writes->proposals.size());
+    auto putError = std::make_shared<Error::Ptr>(nullptr);
+    auto putErrorMutex = std::make_shared<std::mutex>();
+    auto self = std::weak_ptr<LedgerStorage>(shared_from_this());
+    auto onProposalPut = [self, writes, pendingPuts, putError, putErrorMutex](Error::Ptr _error) {
+        if (_error)
+        {
+            std::lock_guard<std::mutex> l(*putErrorMutex);
+            *putError = _error;
+        }
+        if (--(*pendingPuts) > 0)
+        {
+            return;
+        }
+        auto storage = self.lock();
+        if (!storage)
+        {
+            onStorageReleased(writes);
+            return;
+        }
+        if (*putError)
+        {
+            storage->onFlushFailed(writes, *putError);
+            return;
+        }
+        auto maxIndexData = std::make_shared<std::string>(
+            boost::lexical_cast<std::string>(writes->maxCommittedIndex));
+        storage->asyncPutProposal(storage->m_pbftCommitDB, storage->m_maxCommittedProposalKey,
+            maxIndexData, writes->maxCommittedIndex, [self, writes](Error::Ptr _error) {
+                auto storage = self.lock();
+                if (!storage)
+                {
+                    onStorageReleased(writes);
+                    return;
+                }
+                if (_error)
+                {
+                    storage->onFlushFailed(writes, _error);
+                    return;
+                }
+                storage->onFlushFinished(writes, nullptr);
+            });
+    };
+    for (auto const& it : writes->proposals)
+    {
+        asyncPutProposal(m_pbftCommitDB, proposalKey(it.first), it.second, it.first, onProposalPut);
+    }
+}
+
+void LedgerStorage::onFlushFinished(std::shared_ptr<PendingWrites> _writes, Error::Ptr _error)
+{
+    if (!_error && m_maxPersistedProposalIndex < _writes->maxCommittedIndex)
+    {
+        m_maxPersistedProposalIndex = _writes->maxCommittedIndex;
+    }
+    bool pending = false;
+    {
+        std::lock_guard<std::mutex> l(x_pendingWrites);
+        m_flushRetryTime = 0;
+        pending = !m_pendingWrites.proposals.empty() || !m_pendingWrites.removedIndexes.empty() ||
+                  !m_pendingWrites.onPersisted.empty();
+        // keep the flush scheduled to serialize the flushes
+        m_flushScheduled = pending;
+    }
+    // the committed proposals are durable now, notify in the committed order
+    for (auto const& callback : _writes->onPersisted)
+    {
+        callback(_error);
+    }
+    if (pending)
+    {
+        scheduleFlush(m_flushInterval);
+    }
+}
+
+void LedgerStorage::onFlushFailed(std::shared_ptr<PendingWrites> _writes, Error::Ptr _error)
+{
+    size_t retryTime = 0;
+    {
+        // requeue the failed writes before the writes queued meanwhile
+        std::lock_guard<std::mutex> l(x_pendingWrites);
+        for (auto const& it : _writes->proposals)
+        {
+            m_pendingWrites.proposals.insert(it);
+        }
+        m_pendingWrites.maxCommittedIndex =
+            std::max(m_pendingWrites.maxCommittedIndex, _writes->maxCommittedIndex);
+        m_pendingWrites.onPersisted.insert(m_pendingWrites.onPersisted.begin(),
+            _writes->onPersisted.begin(), _writes->onPersisted.end());
+        retryTime = m_flushRetryTime++;
+    }
+    auto backoff = m_flushRetryInterval.load() << std::min(retryTime, c_maxFlushBackoffShift);
+    // the checkpoints of the committed proposals are blocked until the storage recovered
+    if (retryTime >= c_flushRetryWarningTime)
+    {
+        PBFT_STORAGE_LOG(ERROR) << LOG_DESC("flush the commit table failed, retry")
+                                << LOG_KV("code", _error->errorCode())
+                                << LOG_KV("msg", _error->errorMessage())
+                                << LOG_KV("maxCommittedIndex", _writes->maxCommittedIndex)
+                                << LOG_KV("retryTime", retryTime) << LOG_KV("backoff", backoff);
+    }
+    else
+    {
+        PBFT_STORAGE_LOG(WARNING) << LOG_DESC("flush the commit table failed, retry")
+                                  << LOG_KV("code", _error->errorCode())
+                                  << LOG_KV("msg", _error->errorMessage())
+                                  << LOG_KV("maxCommittedIndex", _writes->maxCommittedIndex)
+                                  << LOG_KV("retryTime", retryTime) << LOG_KV("backoff", backoff);
+    }
+    scheduleFlush(backoff);
+}
+
+void LedgerStorage::onStorageReleased(std::shared_ptr<PendingWrites> _writes)
+{
+    for (auto const& callback : _writes->onPersisted)
+    {
+        callback(storageReleasedError());
+    }
 }
 
 void LedgerStorage::asyncPutProposal(std::string const& _dbName, std::string const& _key,
-    bytesPointer _committedData, BlockNumber _proposalIndex, size_t _retryTime)
+    std::shared_ptr<std::string> _committedData, BlockNumber _proposalIndex,
+    std::function<void(Error::Ptr)> _onPut, size_t _retryTime)
 {
     auto startT = utcTime();
     auto self = std::weak_ptr<LedgerStorage>(shared_from_this());
-    // TODO: optimize here to decrease copy overhead
-    // Note: asyncPut now is a sync implementation, but no need to async here since this
-    // timeout-head is only between 5-10ms
-    m_storage->asyncPut(_dbName, _key,
-        std::string((const char*)_committedData->data(), _committedData->size()),
-        [startT, _dbName, _committedData, _key, _proposalIndex, _retryTime, self](
+    m_storage->asyncPut(_dbName, _key, *_committedData,
+        [startT, _dbName, _committedData, _key, _proposalIndex, _onPut, _retryTime, self](
             Error::UniquePtr&& _error) {
             if (_error == nullptr)
             {
@@ -269,30 +575,34 @@ void LedgerStorage::asyncPutProposal(std::string const& _dbName, std::string con
                     << LOG_KV("key", _key) << LOG_KV("number", _proposalIndex)
                     << LOG_KV("timecost", (utcTime() - startT))
                     << LOG_KV("dataSize", _committedData->size());
+                _onPut(nullptr);
                 return;
             }
             PBFT_STORAGE_LOG(WARNING)
                 << LOG_DESC("asyncPutProposal failed") << LOG_KV("proposalIndex", _proposalIndex)
                 << LOG_KV("key", _key) << LOG_KV("dbName", _dbName)
                 << LOG_KV("code", _error->errorCode()) << LOG_KV("msg", _error->errorMessage());
+            auto ledgerStorage = self.lock();
+            if (!ledgerStorage)
+            {
+                _onPut(storageReleasedError());
+                return;
+            }
+            if (_retryTime >= 3)
+            {
+                _onPut(std::move(_error));
+                return;
+            }
             try
             {
-                auto ledgerStorage = self.lock();
-                if (!ledgerStorage)
-                {
-                    return;
-                }
-                if (_retryTime >= 3)
-                {
-                    return;
-                }
                 ledgerStorage->asyncPutProposal(
-                    _dbName, _key, _committedData, _proposalIndex, (_retryTime + 1));
+                    _dbName, _key, _committedData, _proposalIndex, _onPut, (_retryTime + 1));
             }
             catch (std::exception const& e)
             {
                 PBFT_STORAGE_LOG(WARNING) << LOG_DESC("asyncPutProposal exception")
                                           << LOG_KV("error", boost::diagnostic_information(e));
+                _onPut(storageExceptionError(e));
             }
         });
 }
@@ -320,8 +630,12 @@ void LedgerStorage::asyncCommitStableCheckPoint(PBFTProposalInterface::Ptr _stab
                    << LOG_KV("blockProofSize", blockSignatureList.size());
     // Note: enqueue here to increase the performance since commitBlock is a sync implementation
     m_commitBlockWorker->enqueue([this, blockHeader, _stableProposal]() {
-        // get the transactions list
-        auto txsInfo = m_blockFactory->createBlock(_stableProposal->extraData());
+        // get the transactions list, decoded by the StateMachine in most cases
+        auto txsInfo = m_blockCache->block(_stableProposal->hash());
+        if (!txsInfo)
+        {
+            txsInfo = m_blockFactory->createBlock(_stableProposal->extraData());
+        }
         this->commitStableCheckPoint(blockHeader, txsInfo);
     });
 }
@@ -354,6 +668,8 @@ void LedgerStorage::commitStableCheckPoint(BlockHeader::Ptr _blockHeader, Block:
                                        << LOG_KV("hash", _ledgerConfig->hash().abridged())
                                        << LOG_KV("txs", _blockInfo->transactionsHashSize())
                                        << LOG_KV("timeCost", utcTime() - startT);
+                // the checkpoint is stable, release the decoded blocks
+                ledgerStorage->m_blockCache->evict(_blockHeader->number());
                 _ledgerConfig->setSealerId(_blockHeader->sealer());
                 _ledgerConfig->setTxsSize(_blockInfo->transactionsHashSize());
                 // finalize consensus
@@ -366,7 +682,7 @@ void LedgerStorage::commitStableCheckPoint(BlockHeader::Ptr _blockHeader, Block:
                 // requester
                 if (_blockHeader->number() > ledgerStorage->c_reservedCheckPointSize)
                 {
-                    ledgerStorage->asyncRemoveStabledCheckPoint(
+                    ledgerStorage->asyncCompactCommittedProposals(
                         _blockHeader->number() - ledgerStorage->c_reservedCheckPointSize);
                 }
             }
@@ -382,48 +698,215 @@ void LedgerStorage::asyncRemoveStabledCheckPoint(size_t _stabledCheckPointIndex)
 {
     PBFT_STORAGE_LOG(INFO) << LOG_DESC("asyncRemoveStabledCheckPoint")
                            << LOG_KV("index", _stabledCheckPointIndex);
-    asyncRemove(m_pbftCommitDB, boost::lexical_cast<std::string>(_stabledCheckPointIndex));
+    {
+        std::lock_guard<std::mutex> l(x_pendingWrites);
+        m_pendingWrites.removedIndexes.insert(_stabledCheckPointIndex);
+    }
+    tryToScheduleFlush();
 }
 
-void LedgerStorage::asyncRemove(std::string const& _dbName, std::string const& _key)
+void LedgerStorage::asyncRemove(std::string const& _dbName, std::string const& _key,
+    std::function<void(Error::Ptr)> _onRemoved)
 {
-    m_storage->asyncRemove(_dbName, _key, [_dbName, _key](const Error::Ptr& _error) {
+    m_storage->asyncRemove(_dbName, _key, [_dbName, _key, _onRemoved](const Error::Ptr& _error) {
+        if (_onRemoved)
+        {
+            _onRemoved(_error);
+        }
         if (_error == nullptr)
         {
-            PBFT_STORAGE_LOG(INFO) << LOG_DESC("asyncRemove success") << LOG_KV("dbName", _dbName)
-                                   << LOG_KV("key", _key);
+            PBFT_STORAGE_LOG(TRACE) << LOG_DESC("asyncRemove success")
+                                    << LOG_KV("dbName", _dbName) << LOG_KV("key", _key);
             return;
         }
-        // TODO: remove failed
+        // Note: the entries failed to remove are reclaimed by the compaction
         PBFT_STORAGE_LOG(WARNING) << LOG_DESC("asyncRemove failed") << LOG_KV("dbName", _dbName)
                                   << LOG_KV("key", _key);
     });
 }
 
-void LedgerStorage::createKVTable(std::string const& _dbName)
+std::string LedgerStorage::proposalKey(BlockNumber _index)
+{
+    return boost::lexical_cast<std::string>(_index);
+}
+
+void LedgerStorage::asyncCompactCommittedProposals(BlockNumber _lowWatermark)
+{
+    // only raise the target, the running compaction picks up the new target
+    auto target = m_compactTarget.load();
+    while (target < _lowWatermark && !m_compactTarget.compare_exchange_weak(target, _lowWatermark))
+    {
+    }
+    if (m_compacting.exchange(true))
+    {
+        return;
+    }
+    auto self = std::weak_ptr<LedgerStorage>(shared_from_this());
+    m_compactWorker->enqueue([self]() {
+        auto storage = self.lock();
+        if (!storage)
+        {
+            return;
+        }
+        try
+        {
+            storage->compact();
+        }
+        catch (std::exception const& e)
+        {
+            PBFT_STORAGE_LOG(WARNING) << LOG_DESC("compact exception")
+                                      << LOG_KV("error", boost::diagnostic_information(e));
+        }
+        storage->m_compacting = false;
+    });
+}
+
+void LedgerStorage::compact()
+{
+    if (m_compactedProposalIndex < 0 && !fetchCompactedProposalIndex())
+    {
+        return;
+    }
+    auto startT = utcTime();
+    auto startIndex = m_compactedProposalIndex.load();
+    // bounded batches, the new targets are compacted by the same round
+    while (m_compactedProposalIndex < m_compactTarget)
+    {
+        auto start = m_compactedProposalIndex + 1;
+        auto end = std::min(m_compactTarget.load(), start + c_compactBatchSize - 1);
+        // retry in the next round
+        if (!removeCommittedProposals(start, end) || !putCompactedProposalIndex(end))
+        {
+            break;
+        }
+        m_compactedProposalIndex = end;
+    }
+    PBFT_STORAGE_LOG(INFO) << LOG_DESC("compact the commit table")
+                           << LOG_KV("start", startIndex + 1)
+                           << LOG_KV("compactedIndex", m_compactedProposalIndex)
+                           << LOG_KV("target", m_compactTarget)
+                           << LOG_KV("tableSize", committedTableSize())
+                           << LOG_KV("timeCost", utcTime() - startT);
+}
+
+bool LedgerStorage::removeCommittedProposals(BlockNumber _start, BlockNumber _end)
+{
+    struct RemoveState
+    {
+        std::atomic<int64_t> pendingRemoves = {0};
+        std::atomic_bool failed = {false};
+        std::promise<void> finished;
+    };
+    auto state = std::make_shared<RemoveState>();
+    state->pendingRemoves = _end - _start + 1;
+    auto future = state->finished.get_future();
+    for (auto i = _start; i <= _end; i++)
+    {
+        asyncRemove(m_pbftCommitDB, proposalKey(i), [state](Error::Ptr _error) {
+            if (_error)
+            {
+                state->failed = true;
+            }
+            if (--state->pendingRemoves == 0)
+            {
+                state->finished.set_value();
+            }
+        });
+    }
+    if (future.wait_for(std::chrono::milliseconds(m_timeout)) != std::future_status::ready)
+    {
+        PBFT_STORAGE_LOG(WARNING) << LOG_DESC("removeCommittedProposals timeout")
+                                  << LOG_KV("start", _start) << LOG_KV("end", _end);
+        return false;
+    }
+    return !state->failed;
+}
+
+bool LedgerStorage::putCompactedProposalIndex(BlockNumber _compactedIndex)
+{
+    auto finished = std::make_shared<std::promise<Error::Ptr>>();
+    auto future = finished->get_future();
+    auto data = std::make_shared<std::string>(boost::lexical_cast<std::string>(_compactedIndex));
+    asyncPutProposal(m_pbftCommitDB, m_compactedProposalKey, data, _compactedIndex,
+        [finished](Error::Ptr _error) { finished->set_value(_error); });
+    if (future.wait_for(std::chrono::milliseconds(m_timeout)) != std::future_status::ready)
+    {
+        PBFT_STORAGE_LOG(WARNING) << LOG_DESC("putCompactedProposalIndex timeout")
+                                  << LOG_KV("compactedIndex", _compactedIndex);
+        return false;
+    }
+    return future.get() == nullptr;
+}
+
+bool LedgerStorage::fetchCompactedProposalIndex()
+{
+    auto result = std::make_shared<std::promise<int64_t>>();
+    auto future = result->get_future();
+    m_storage->asyncGet(m_pbftCommitDB, m_compactedProposalKey,
+        [result](Error::UniquePtr&& _error, std::string_view&& _value) {
+            if (_error != nullptr)
+            {
+                PBFT_STORAGE_LOG(WARNING)
+                    << LOG_DESC("fetchCompactedProposalIndex failed")
+                    << LOG_KV("errorCode", _error->errorCode())
+                    << LOG_KV("errorMessage", _error->errorMessage());
+                result->set_value(-1);
+                return;
+            }
+            try
+            {
+                // nothing has been compacted, distinguished from the failures
+                if (_value.size() == 0)
+                {
+                    result->set_value(-2);
+                    return;
+                }
+                result->set_value(boost::lexical_cast<int64_t>(_value));
+            }
+            catch (std::exception const& e)
+            {
+                PBFT_STORAGE_LOG(WARNING) << LOG_DESC("fetchCompactedProposalIndex exception")
+                                          << LOG_KV("error", boost::diagnostic_information(e));
+                result->set_value(-1);
+            }
+        });
+    if (future.wait_for(std::chrono::milliseconds(m_timeout)) != std::future_status::ready)
+    {
+        PBFT_STORAGE_LOG(WARNING) << LOG_DESC("fetchCompactedProposalIndex timeout");
+        return false;
+    }
+    auto compactedIndex = future.get();
+    if (compactedIndex == -2)
+    {
+        // Note: the tables without the compacted index removed the stale entry of every stable
+        // checkpoint, only reclaim the latest batch rather than sweeping from the genesis
+        compactedIndex = std::max((int64_t)0, m_compactTarget.load() - c_compactBatchSize);
+    }
+    if (compactedIndex < 0)
+    {
+        return false;
+    }
+    m_compactedProposalIndex = compactedIndex;
+    PBFT_STORAGE_LOG(INFO) << LOG_DESC("fetchCompactedProposalIndex")
+                           << LOG_KV("compactedIndex", compactedIndex);
+    return true;
+}
+
+void LedgerStorage::asyncCreateKVTable(
+    std::string const& _dbName, std::function<void(Error::Ptr)> _onCreated)
 {
-    auto ret = std::make_shared<std::promise<Error::Ptr>>();
-    auto future = ret->get_future();
     std::string valueFields = "value";
-    m_storage->storage()->asyncCreateTable(
-        _dbName, valueFields, [_dbName, ret](Error::UniquePtr&& _error, std::optional<Table>&&) {
+    m_storage->storage()->asyncCreateTable(_dbName, valueFields,
+        [_dbName, _onCreated](Error::UniquePtr&& _error, std::optional<Table>&&) {
             if (_error && _error->errorCode() != bcos::storage::StorageError::TableExists)
             {
                 PBFT_STORAGE_LOG(WARNING)
                     << LOG_DESC("createKVTable error") << LOG_KV("table", _dbName)
                     << LOG_KV("code", _error->errorCode()) << LOG_KV("msg", _error->errorMessage());
-                ret->set_value(std::move(_error));
+                _onCreated(std::move(_error));
                 return;
             }
-            ret->set_value(nullptr);
             PBFT_STORAGE_LOG(INFO) << LOG_DESC("createKVTable success") << LOG_KV("table", _dbName);
+            _onCreated(nullptr);
         });
-    auto error = future.get();
-    if (error)
-    {
-        BOOST_THROW_EXCEPTION(
-            InitPBFTException() << errinfo_comment(
-                "Create PBFT backup DB failed, code: " + std::to_string(error->errorCode()) +
-                ", message:" + error->errorMessage()));
-    }
 }
@@ -21,10 +21,14 @@
 #pragma once
 #include "../interfaces/PBFTMessageFactory.h"
 #include "../interfaces/PBFTStorage.h"
+#include "bcos-pbft/core/DecodedBlockCache.h"
 #include <bcos-framework/interfaces/dispatcher/SchedulerInterface.h>
 #include <bcos-framework/interfaces/protocol/BlockFactory.h>
 #include <bcos-framework/libutilities/KVStorageHelper.h>
 #include <bcos-framework/libutilities/ThreadPool.h>
+#include <map>
+#include <mutex>
+#include <set>
 
 namespace bcos
 {
@@ -36,21 +40,32 @@ public:
     using Ptr = std::shared_ptr<LedgerStorage>;
     LedgerStorage(bcos::scheduler::SchedulerInterface::Ptr _scheduler,
         std::shared_ptr<bcos::storage::KVStorageHelper> _storage,
-        bcos::protocol::BlockFactory::Ptr _blockFactory, PBFTMessageFactory::Ptr _messageFactory)
+        bcos::protocol::BlockFactory::Ptr _blockFactory, PBFTMessageFactory::Ptr _messageFactory,
+        DecodedBlockCache::Ptr _blockCache = nullptr)
       : m_scheduler(_scheduler),
         m_storage(_storage),
         m_blockFactory(_blockFactory),
-        m_messageFactory(_messageFactory)
+        m_messageFactory(_messageFactory),
+        m_blockCache(_blockCache)
     {
-        createKVTable(m_pbftCommitDB);
         m_commitBlockWorker = std::make_shared<ThreadPool>("blockSubmit", 1);
+        m_flushWorker = std::make_shared<ThreadPool>("pbftFlush", 1);
+        m_compactWorker = std::make_shared<ThreadPool>("pbftCompact", 1);
+        if (!m_blockCache)
+        {
+            m_blockCache = std::make_shared<DecodedBlockCache>();
+        }
     }
 
-    void createKVTable(std::string const& _dbName);
+    // Note: the kv-table is created by loadState/asyncLoadState
     PBFTProposalListPtr loadState(bcos::protocol::BlockNumber _stabledIndex) override;
+    void asyncLoadState(bcos::protocol::BlockNumber _stabledIndex,
+        std::function<void(Error::Ptr, PBFTProposalListPtr)> _onLoaded) override;
 
     // commit the committed proposal into the kv-storage
     void asyncCommitProposal(PBFTProposalInterface::Ptr _proposal) override;
+    void asyncCommitProposal(PBFTProposalInterface::Ptr _proposal,
+        std::function<void(Error::Ptr)> _onPersisted) override;
     // commit the executed-block into the blockchain
     void asyncCommitStableCheckPoint(PBFTProposalInterface::Ptr _stableProposal) override;
     void registerFinalizeHandler(
@@ -65,41 +80,135 @@ public:
     int64_t maxCommittedProposalIndex() override { return m_maxCommittedProposalIndex; }
 
     void asyncRemoveStabledCheckPoint(size_t _stabledCheckPointIndex) override;
+    // the synced blocks are committed without the stable checkpoints, evict the decoded blocks
+    void onSyncedBlock(bcos::protocol::BlockNumber _syncedIndex) override
+    {
+        m_blockCache->evict(_syncedIndex);
+    }
+
+    // the writes queued in one flush interval(in ms) are flushed together
+    void setFlushInterval(uint64_t _flushInterval) { m_flushInterval = _flushInterval; }
+    uint64_t flushInterval() const { return m_flushInterval; }
+    void setFlushRetryInterval(uint64_t _retryInterval) { m_flushRetryInterval = _retryInterval; }
+    // the committed proposals no larger than the index are durable
+    int64_t maxPersistedProposalIndex() const { return m_maxPersistedProposalIndex; }
+
+    // remove all the committed proposals no larger than _lowWatermark in the background,
+    // including the leftovers of the crashed nodes
+    virtual void asyncCompactCommittedProposals(bcos::protocol::BlockNumber _lowWatermark);
+    // the number of the committed proposals retained in the commit table
+    int64_t committedTableSize() const
+    {
+        auto compactedIndex = std::max((int64_t)0, m_compactedProposalIndex.load());
+        return std::max((int64_t)0, m_maxPersistedProposalIndex - compactedIndex);
+    }
+    bcos::protocol::BlockNumber compactedProposalIndex() const { return m_compactedProposalIndex; }
+
+    // the key of the committed proposal, the compacted range is tracked by the compacted index
+    // rather than by the order of the keys
+    static std::string proposalKey(bcos::protocol::BlockNumber _index);
 
 protected:
+    static Error::Ptr storageReleasedError();
+    static Error::Ptr storageExceptionError(std::exception const& _e);
+
     virtual void asyncPutProposal(std::string const& _dbName, std::string const& _key,
-        bytesPointer _committedData, bcos::protocol::BlockNumber _proposalIndex,
-        size_t _retryTime = 0);
+        std::shared_ptr<std::string> _committedData, bcos::protocol::BlockNumber _proposalIndex,
+        std::function<void(Error::Ptr)> _onPut, size_t _retryTime = 0);
+    struct PendingWrites;
+    virtual void tryToScheduleFlush();
+    virtual void scheduleFlush(uint64_t _delay);
+    // write the queued proposals, the max committed proposal index and the stale-entry
+    // deletions in one flush
+    virtual void flush();
+    virtual void onFlushFinished(std::shared_ptr<PendingWrites> _writes, Error::Ptr _error);
+    // requeue the failed writes and retry with backoff
+    virtual void onFlushFailed(std::shared_ptr<PendingWrites> _writes, Error::Ptr _error);
+    static void onStorageReleased(std::shared_ptr<PendingWrites> _writes);
+
+    virtual void asyncRemove(std::string const& _dbName, std::string const& _key,
+        std::function<void(Error::Ptr)> _onRemoved = nullptr);
 
-    virtual void asyncRemove(std::string const& _dbName, std::string const& _key);
+    virtual void compact();
+    // remove the committed proposals in [_start, _end] and wait for the result
+    virtual bool removeCommittedProposals(
+        bcos::protocol::BlockNumber _start, bcos::protocol::BlockNumber _end);
+    virtual bool putCompactedProposalIndex(bcos::protocol::BlockNumber _compactedIndex);
+    virtual bool fetchCompactedProposalIndex();
 
     virtual void commitStableCheckPoint(
         bcos::protocol::BlockHeader::Ptr _blockHeader, bcos::protocol::Block::Ptr _blockInfo);
-    virtual void asyncGetLatestCommittedProposalIndex();
+    virtual void asyncCreateKVTable(
+        std::string const& _dbName, std::function<void(Error::Ptr)> _onCreated);
+    virtual void asyncGetLatestCommittedProposalIndex(std::function<void(Error::Ptr)> _onFetched);
+    virtual void onLatestCommittedProposalIndexFetched(bcos::protocol::BlockNumber _stabledIndex,
+        std::function<void(Error::Ptr, PBFTProposalListPtr)> _onLoaded);
+    // fetch the committed proposals in [_start, _end] with several concurrent batch reads
+    virtual void asyncFetchCommittedProposals(bcos::protocol::BlockNumber _start,
+        bcos::protocol::BlockNumber _end,
+        std::function<void(Error::Ptr, PBFTProposalListPtr)> _onFetched);
+    // the proposal list is nullptr when some proposals in [_start, _end] are missing
+    virtual void asyncGetProposalBatch(bcos::protocol::BlockNumber _start,
+        bcos::protocol::BlockNumber _end,
+        std::function<void(Error::Ptr, PBFTProposalListPtr)> _onFetched);
 
 protected:
     bcos::scheduler::SchedulerInterface::Ptr m_scheduler;
     std::shared_ptr<bcos::storage::KVStorageHelper> m_storage;
     bcos::protocol::BlockFactory::Ptr m_blockFactory;
     PBFTMessageFactory::Ptr m_messageFactory;
+    // the blocks decoded by the StateMachine, evicted when the checkpoint becomes stable
+    DecodedBlockCache::Ptr m_blockCache;
 
     std::string m_maxCommittedProposalKey = "max_committed_proposal";
+    std::string m_compactedProposalKey = "compacted_proposal_index";
     std::string m_pbftCommitDB = "pbftCommitDB";
 
 
     std::atomic<int64_t> m_maxCommittedProposalIndex = {0};
-    std::atomic_bool m_maxCommittedProposalIndexFetched = {false};
 
-    PBFTProposalListPtr m_stateProposals = nullptr;
-    std::atomic_bool m_stateFetched = {false};
     size_t m_timeout = 10000;
     bcos::protocol::BlockNumber c_reservedCheckPointSize = 5;
+    // the proposals fetched by one batch read when loading the state
+    const int64_t c_loadStateBatchSize = 32;
 
-    boost::condition_variable m_signalled;
-    boost::mutex x_signalled;
     std::function<void(bcos::ledger::LedgerConfig::Ptr, bool _syncBlock)> m_finalizeHandler;
 
     std::shared_ptr<ThreadPool> m_commitBlockWorker;
+
+    // the writes waiting to be flushed into the commit table
+    struct PendingWrites
+    {
+        std::map<bcos::protocol::BlockNumber, std::shared_ptr<std::string>> proposals;
+        bcos::protocol::BlockNumber maxCommittedIndex = 0;
+        std::set<bcos::protocol::BlockNumber> removedIndexes;
+        std::vector<std::function<void(Error::Ptr)>> onPersisted;
+    };
+    PendingWrites m_pendingWrites;
+    // true from the flush scheduled until the flush finished
+    bool m_flushScheduled = false;
+    // the failed flushes in succession
+    size_t m_flushRetryTime = 0;
+    // the backoff(in ms) before the first retry of the failed flush, doubled for every retry
+    std::atomic<uint64_t> m_flushRetryInterval = {100};
+    const size_t c_maxFlushBackoffShift = 6;
+    const size_t c_flushRetryWarningTime = 3;
+    std::mutex x_pendingWrites;
+    std::shared_ptr<ThreadPool> m_flushWorker;
+    std::atomic<uint64_t> m_flushInterval = {5};
+    // the proposals before m_maxPersistedProposalIndex can be read from the storage
+    std::atomic<int64_t> m_maxPersistedProposalIndex = {0};
+
+    // the compaction of the commit table
+    std::shared_ptr<ThreadPool> m_compactWorker;
+    std::atomic_bool m_compacting = {false};
+    // the low watermark requested by the latest stable checkpoint
+    std::atomic<int64_t> m_compactTarget = {0};
+    // all the proposals no larger than m_compactedProposalIndex have been removed,
+    // -1 means not fetched from the storage yet
+    std::atomic<int64_t> m_compactedProposalIndex = {-1};
+    // the proposals removed by one batch
+    const int64_t c_compactBatchSize = 128;
 };
 }  // namespace consensus
 }  // namespace bcos
\ No newline at end of file
@@ -21,6 +21,7 @@
 #include <bcos-framework/libutilities/Exceptions.h>
 #include <bcos-framework/libutilities/Log.h>
 #include <stdint.h>
+#include <string>
 
 #define PBFT_LOG(LEVEL) BCOS_LOG(LEVEL) << LOG_BADGE("CONSENSUS") << LOG_BADGE("PBFT")
 #define PBFT_STORAGE_LOG(LEVEL) \
@@ -44,7 +45,86 @@ enum PacketType : uint32_t
     CheckPoint = 0x9,
     RecoverRequest = 0xa,
     RecoverResponse = 0xb,
+    // batched consensus messages covering several consecutive proposals
+    PrePrepareBatchPacket = 0xc,
+    PrepareBatchPacket = 0xd,
+    CommitBatchPacket = 0xe,
+    // the quorum certificates broadcasted by the collector in linear-communication mode
+    PrepareCertificatePacket = 0xf,
+    CommitCertificatePacket = 0x10,
 };
+
+// the packet type of the entries carried by the batched consensus message
+inline PacketType unbatchedPacketType(PacketType _batchPacketType)
+{
+    switch (_batchPacketType)
+    {
+    case PacketType::PrePrepareBatchPacket:
+        return PacketType::PrePreparePacket;
+    case PacketType::PrepareBatchPacket:
+        return PacketType::PreparePacket;
+    case PacketType::CommitBatchPacket:
+        return PacketType::CommitPacket;
+    default:
+        return _batchPacketType;
+    }
+}
+
+inline PacketType batchedPacketType(PacketType _packetType)
+{
+    switch (_packetType)
+    {
+    case PacketType::PrePreparePacket:
+        return PacketType::PrePrepareBatchPacket;
+    case PacketType::PreparePacket:
+        return PacketType::PrepareBatchPacket;
+    case PacketType::CommitPacket:
+        return PacketType::CommitBatchPacket;
+    default:
+        return _packetType;
+    }
+}
+
+// the NewView messages since this version encode the distinct signature proofs of the prepared
+// proposals once into the certificate table
+const int32_t c_newViewCertificateTableVersion = 1;
+// the commit votes since this version sign the digest of the phase, view, index and hash instead of
+// the proposal hash
+const int32_t c_commitVoteDigestVersion = 1;
+
+// the reason why the leader stops notifying the sealer to seal new proposals
+enum SealStallReason : int32_t
+{
+    NoStall = 0,
+    // too many committed proposals are waiting for execution
+    ExecutionBacklog = 1,
+    // too many executed proposals are waiting to be committed to the ledger
+    CommitBacklog = 2,
+};
+
+inline std::string sealStallReasonDesc(SealStallReason _reason)
+{
+    switch (_reason)
+    {
+    case SealStallReason::ExecutionBacklog:
+        return "executionBacklog";
+    case SealStallReason::CommitBacklog:
+        return "commitBacklog";
+    default:
+        return "none";
+    }
+}
+// the error codes reported by the PBFT module
+enum PBFTErrorCode : int32_t
+{
+    // the storage is released before the request finished
+    StorageReleased = 10001,
+    // exception raised when handling the result of the storage
+    StorageException = 10002,
+    // the state is not recovered from the storage in time
+    RecoverStateTimeout = 10003,
+};
+
 DERIVE_BCOS_EXCEPTION(UnknownPBFTMsgType);
 DERIVE_BCOS_EXCEPTION(InitPBFTException);
 }  // namespace consensus
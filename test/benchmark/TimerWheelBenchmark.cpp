@@ -0,0 +1,90 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief compare the scheduling cost and the wakeups of the asio timers with the timer wheel
+ * @file TimerWheelBenchmark.cpp
+ * @author: yujiechen
+ * @date 2021-06-18
+ */
+#include "bcos-pbft/pbft/engine/PBFTTimer.h"
+#include <bcos-framework/libutilities/Timer.h>
+#include <iostream>
+
+using namespace bcos;
+using namespace bcos::consensus;
+
+class BenchTimer : public Timer
+{
+public:
+    explicit BenchTimer(uint64_t _timeout) : Timer(_timeout) {}
+    ~BenchTimer() override {}
+    void registerTimeoutHandler(std::function<void()>) override {}
+
+protected:
+    void run() override {}
+};
+
+// usage: bench-timer-wheel [timerSize] [restartTimes]
+int main(int argc, char* argv[])
+{
+    size_t timerSize = (argc > 1) ? std::stoul(argv[1]) : 100;
+    size_t restartTimes = (argc > 2) ? std::stoul(argv[2]) : 100;
+    uint64_t timeoutInterval = 1000;
+
+    auto startT = utcTime();
+    std::vector<std::shared_ptr<BenchTimer>> timers;
+    for (size_t i = 0; i < timerSize; i++)
+    {
+        timers.emplace_back(std::make_shared<BenchTimer>(timeoutInterval));
+    }
+    for (size_t j = 0; j < restartTimes; j++)
+    {
+        for (auto& timer : timers)
+        {
+            timer->restart();
+        }
+    }
+    auto asioTimerCost = utcTime() - startT;
+    for (auto& timer : timers)
+    {
+        timer->destroy();
+    }
+    timers.clear();
+
+    startT = utcTime();
+    auto timerWheel = std::make_shared<TimerWheel>("benchTimer");
+    std::vector<PBFTTimer::Ptr> wheelTimers;
+    for (size_t i = 0; i < timerSize; i++)
+    {
+        wheelTimers.emplace_back(std::make_shared<PBFTTimer>(timerWheel, timeoutInterval));
+    }
+    for (size_t j = 0; j < restartTimes; j++)
+    {
+        for (auto& timer : wheelTimers)
+        {
+            timer->restart();
+        }
+    }
+    auto timerWheelCost = utcTime() - startT;
+    auto wakeups = timerWheel->wakeups();
+    wheelTimers.clear();
+    timerWheel->stop();
+
+    std::cout << "timers: " << timerSize << ", restart times: " << restartTimes << std::endl;
+    std::cout << "asio timers: " << asioTimerCost << "ms, threads: " << timerSize << std::endl;
+    std::cout << "timer wheel: " << timerWheelCost << "ms, threads: 1, wakeups: " << wakeups
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,135 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief unit tests for the DecodedBlockCache
+ * @file DecodedBlockCacheTest.cpp
+ * @author: yujiechen
+ * @date 2021-06-22
+ */
+#include "bcos-pbft/core/DecodedBlockCache.h"
+#include "test/unittests/pbft/PBFTFixture.h"
+#include <bcos-framework/interfaces/crypto/CryptoSuite.h>
+#include <bcos-framework/testutils/TestPromptFixture.h>
+#include <bcos-framework/testutils/crypto/HashImpl.h>
+#include <bcos-framework/testutils/crypto/SignatureImpl.h>
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+using namespace bcos;
+using namespace bcos::consensus;
+using namespace bcos::crypto;
+using namespace bcos::protocol;
+
+namespace bcos
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(DecodedBlockCacheTest, TestPromptFixture)
+
+BOOST_AUTO_TEST_CASE(testCacheEviction)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto faker = createPBFTFixture(cryptoSuite);
+    auto blockCache = std::make_shared<DecodedBlockCache>(4);
+
+    std::vector<HashType> hashes;
+    for (BlockNumber i = 1; i <= 6; i++)
+    {
+        hashes.push_back(hashImpl->hash(std::to_string(i)));
+        blockCache->insert(hashes.back(), i, fakeBlock(cryptoSuite, faker, i, 2));
+    }
+    // the blocks of the smallest indexes are evicted when exceeding the capacity
+    BOOST_CHECK(blockCache->size() == blockCache->capacity());
+    BOOST_CHECK(blockCache->block(hashes[0]) == nullptr);
+    BOOST_CHECK(blockCache->block(hashes[1]) == nullptr);
+    BOOST_CHECK(blockCache->block(hashes[5]) != nullptr);
+    // the blocks with the same index
+    auto otherHash = hashImpl->hash(std::string("otherBlock"));
+    blockCache->insert(otherHash, 6, fakeBlock(cryptoSuite, faker, 6, 2));
+    BOOST_CHECK(blockCache->size() == 5);
+
+    // evicted by the stable checkpoint
+    blockCache->evict(4);
+    BOOST_CHECK(blockCache->size() == 3);
+    BOOST_CHECK(blockCache->block(hashes[3]) == nullptr);
+    BOOST_CHECK(blockCache->block(hashes[4]) != nullptr);
+
+    // evicted by the synced block
+    auto storage = std::make_shared<LedgerStorage>(faker->scheduler(), faker->storage(),
+        faker->blockFactory(), faker->pbftConfig()->pbftMessageFactory(), blockCache);
+    storage->onSyncedBlock(6);
+    BOOST_CHECK(blockCache->size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testConcurrentReaders)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto faker = createPBFTFixture(cryptoSuite);
+    auto blockCache = std::make_shared<DecodedBlockCache>(4);
+
+    // the executed block read by the storage workers concurrently
+    size_t txsSize = 10;
+    auto executedBlock = fakeBlock(cryptoSuite, faker, 1, txsSize);
+    HashList txsHash;
+    for (size_t i = 0; i < txsSize; i++)
+    {
+        txsHash.push_back(executedBlock->transactionHash(i));
+    }
+    auto hash = hashImpl->hash(std::string("executedBlock"));
+    // the shared block is not evicted by the blocks of the smaller indexes
+    blockCache->insert(hash, 1000, executedBlock);
+
+    std::atomic<size_t> mismatched = {0};
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < 4; i++)
+    {
+        readers.emplace_back([&]() {
+            for (size_t j = 0; j < 1000; j++)
+            {
+                auto block = blockCache->block(hash);
+                if (!block || block->transactionsHashSize() != txsSize)
+                {
+                    mismatched++;
+                    continue;
+                }
+                for (size_t k = 0; k < txsSize; k++)
+                {
+                    if (block->transactionHash(k) != txsHash[k])
+                    {
+                        mismatched++;
+                    }
+                }
+            }
+        });
+    }
+    // insert and evict the blocks of other indexes meanwhile
+    for (BlockNumber i = 2; i < 100; i++)
+    {
+        blockCache->insert(hashImpl->hash(std::to_string(i)), i, executedBlock);
+        blockCache->evict(i - 1);
+    }
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+    BOOST_CHECK(mismatched == 0);
+}
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
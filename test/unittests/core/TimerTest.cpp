@@ -23,6 +23,8 @@
 #include <bcos-framework/testutils/TestPromptFixture.h>
 #include <boost/test/unit_test.hpp>
 #include <chrono>
+#include <functional>
+#include <mutex>
 #include <thread>
 
 using namespace bcos;
@@ -31,25 +33,60 @@ namespace bcos
 {
 namespace test
 {
+// milliseconds elapsed since _startT
+inline uint64_t elapsedMs(std::chrono::steady_clock::time_point const& _startT)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - _startT)
+        .count();
+}
+
+// wait until _condition holds or _timeout(ms) passed
+inline bool waitUntil(std::function<bool()> _condition, uint64_t _timeout = 3000)
+{
+    auto startT = std::chrono::steady_clock::now();
+    while (!_condition())
+    {
+        if (elapsedMs(startT) > _timeout)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
 class FakeTimer : public Timer
 {
 public:
     explicit FakeTimer(uint64_t _timeout) : Timer(_timeout) {}
     ~FakeTimer() override {}
-    void setTriggerTimeout(bool _triggerTimeout) { m_triggerTimeout = _triggerTimeout; }
-    bool triggerTimeout() { return m_triggerTimeout; }
+    // reset the trigger state and the time the timeout is measured from
+    void resetTrigger()
+    {
+        m_startT = std::chrono::steady_clock::now();
+        m_triggered = 0;
+        m_triggerElapsed = 0;
+    }
+    uint64_t triggered() const { return m_triggered; }
+    // the elapsed time(ms) of the first trigger since resetTrigger
+    uint64_t triggerElapsed() const { return m_triggerElapsed; }
     void registerTimeoutHandler(std::function<void()>) override {}
 
 protected:
     // invoked everytime when it reaches the timeout
     void run() override
     {
-        std::cout << "### run timeout handler now" << std::endl;
-        m_triggerTimeout = true;
+        if (m_triggered++ == 0)
+        {
+            m_triggerElapsed = elapsedMs(m_startT);
+        }
     }
 
 private:
-    std::atomic_bool m_triggerTimeout = false;
+    std::chrono::steady_clock::time_point m_startT = std::chrono::steady_clock::now();
+    std::atomic<uint64_t> m_triggered = {0};
+    std::atomic<uint64_t> m_triggerElapsed = {0};
 };
 
 BOOST_FIXTURE_TEST_SUITE(TimerTest, TestPromptFixture)
@@ -57,81 +94,131 @@ BOOST_AUTO_TEST_CASE(testTimer)
 {
     uint64_t timeoutInterval = 200;
     auto timer = std::make_shared<FakeTimer>(timeoutInterval);
-    auto startT = utcTime();
     for (size_t i = 0; i < 4; i++)
     {
-        timer->setTriggerTimeout(false);
-        // start the timer
+        timer->resetTrigger();
         timer->start();
-        // sleep
-        startT = utcTime();
-        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutInterval + 200));
-        std::cout << "#### sleep eclipse:" << utcTime() - startT;
-        // stop the timer
+        BOOST_CHECK(waitUntil([&]() { return timer->triggered() > 0; }));
         timer->stop();
-        // check the value
-        std::cout << "##### testTimer: index" << i << std::endl;
-        std::cout << std::endl;
-        auto eclipse = utcTime() - startT;
-        if (eclipse > timeoutInterval)
-        {
-            BOOST_CHECK(timer->triggerTimeout() == true);
-        }
+        // never triggered before the timeout
+        BOOST_CHECK(timer->triggerElapsed() >= timeoutInterval);
     }
 
-    std::cout << std::endl;
-    std::cout << "#### case1" << std::endl;
-    timer->setTriggerTimeout(false);
+    // the stopped timer is not triggered
+    timer->resetTrigger();
     timer->start();
-    startT = utcTime();
-    std::this_thread::sleep_for(std::chrono::milliseconds(timeoutInterval - 100));
-    std::cout << "#### sleep eclipse:" << utcTime() - startT;
-    auto eclipse = utcTime() - startT;
-    if (eclipse < timeoutInterval)
-    {
-        BOOST_CHECK(timer->triggerTimeout() == false);
-    }
     timer->stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeoutInterval + 100));
+    BOOST_CHECK(timer->triggered() == 0);
 
-    std::cout << std::endl;
-    std::cout << "#### case2" << std::endl;
-    // reset the timer
-    timer->setTriggerTimeout(false);
+    // reset the timeout
     timer->reset(60);
+    timer->resetTrigger();
     timer->start();
-    startT = utcTime();
-    std::this_thread::sleep_for(std::chrono::milliseconds(200));
-    std::cout << "#### sleep eclipse:" << utcTime() - startT;
-    BOOST_CHECK(timer->triggerTimeout() == true);
+    BOOST_CHECK(waitUntil([&]() { return timer->triggered() > 0; }));
     timer->stop();
+    BOOST_CHECK(timer->triggerElapsed() >= 60);
+    BOOST_CHECK(timer->triggerElapsed() < timeoutInterval);
 }
 
-BOOST_AUTO_TEST_CASE(testTimerWithoutWait)
+BOOST_AUTO_TEST_CASE(testTimerRestart)
 {
     uint64_t timeoutInterval = 200;
     auto timer = std::make_shared<FakeTimer>(timeoutInterval);
     timer->start();
-    BOOST_CHECK(timer->triggerTimeout() == false);
-    // sleep 80ms
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // the timeout is measured from the restart
+    timer->resetTrigger();
+    timer->restart();
+    BOOST_CHECK(waitUntil([&]() { return timer->triggered() > 0; }));
+    timer->stop();
+    BOOST_CHECK(timer->triggerElapsed() >= timeoutInterval);
+}
 
+BOOST_AUTO_TEST_CASE(testPBFTTimer)
+{
+    uint64_t timeoutInterval = 100;
+    auto timer = std::make_shared<PBFTTimer>(timeoutInterval);
+    timer->start();
+}
 
-    // test restart
-    timer->restart();
-    // sleep 20ms
-    auto startT = utcTime();
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    if (utcTime() - startT < timeoutInterval)
+BOOST_AUTO_TEST_CASE(testTimerWheel)
+{
+    auto timerWheel = std::make_shared<TimerWheel>("testTimer");
+    std::mutex mutex;
+    // the timeout and the trigger time of the fired timers, in the fire order
+    std::vector<std::pair<uint64_t, uint64_t>> fired;
+    auto startT = std::chrono::steady_clock::now();
+    auto scheduleTimer = [&](uint64_t _timeout) {
+        return timerWheel->schedule(_timeout, [&, _timeout]() {
+            std::lock_guard<std::mutex> l(mutex);
+            fired.emplace_back(_timeout, elapsedMs(startT));
+        });
+    };
+    // scheduled out of order, the last one beyond the first level of the wheel
+    scheduleTimer(90);
+    scheduleTimer(700);
+    scheduleTimer(30);
+    scheduleTimer(60);
+    auto cancelledTimer = scheduleTimer(50);
+    BOOST_CHECK(timerWheel->cancel(cancelledTimer) == true);
+    BOOST_CHECK(timerWheel->cancel(cancelledTimer) == false);
+    BOOST_CHECK(timerWheel->size() == 4);
+
+    BOOST_CHECK(waitUntil([&]() {
+        std::lock_guard<std::mutex> l(mutex);
+        return fired.size() == 4;
+    }));
+    std::vector<uint64_t> expectedOrder{30, 60, 90, 700};
+    std::lock_guard<std::mutex> l(mutex);
+    BOOST_REQUIRE(fired.size() == expectedOrder.size());
+    for (size_t i = 0; i < fired.size(); i++)
     {
-        BOOST_CHECK(timer->triggerTimeout() == false);
+        // fired in the order of the timeout, and never before the timeout
+        BOOST_CHECK(fired[i].first == expectedOrder[i]);
+        BOOST_CHECK(fired[i].second >= fired[i].first);
+        if (i > 0)
+        {
+            BOOST_CHECK(fired[i].second >= fired[i - 1].second);
+        }
     }
+    BOOST_CHECK(timerWheel->size() == 0);
+    timerWheel->stop();
 }
 
-BOOST_AUTO_TEST_CASE(testPBFTTimer)
+BOOST_AUTO_TEST_CASE(testPBFTTimerOnWheel)
 {
+    auto timerWheel = std::make_shared<TimerWheel>("testTimer");
     uint64_t timeoutInterval = 100;
-    auto timer = std::make_shared<PBFTTimer>(timeoutInterval);
+    std::atomic<uint64_t> triggered = {0};
+    std::atomic<uint64_t> triggerElapsed = {0};
+    auto startT = std::chrono::steady_clock::now();
+    auto timer = std::make_shared<PBFTTimer>(timerWheel, timeoutInterval);
+    timer->registerTimeoutHandler([&]() {
+        if (triggered++ == 0)
+        {
+            triggerElapsed = elapsedMs(startT);
+        }
+    });
     timer->start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    // the timer restarted before the timeout is measured from the restart
+    startT = std::chrono::steady_clock::now();
+    timer->restart();
+    BOOST_CHECK(waitUntil([&]() { return triggered > 0; }));
+    BOOST_CHECK(triggered == 1);
+    BOOST_CHECK(triggerElapsed >= timeoutInterval);
+    BOOST_CHECK(timer->running() == true);
+
+    // the timer stopped before the timeout is not triggered
+    timer->restart();
+    timer->stop();
+    BOOST_CHECK(timer->running() == false);
+    auto triggeredBeforeStop = triggered.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeoutInterval * 3));
+    BOOST_CHECK(triggered == triggeredBeforeStop);
+    BOOST_CHECK(timerWheel->size() == 0);
+    timerWheel->stop();
 }
 
 BOOST_AUTO_TEST_SUITE_END()
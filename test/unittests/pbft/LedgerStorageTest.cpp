@@ -0,0 +1,319 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief unit tests for the commit table of the LedgerStorage
+ * @file LedgerStorageTest.cpp
+ * @author: yujiechen
+ * @date 2021-06-11
+ */
+#include "test/unittests/pbft/PBFTFixture.h"
+#include <bcos-framework/interfaces/crypto/CryptoSuite.h>
+#include <bcos-framework/testutils/TestPromptFixture.h>
+#include <bcos-framework/testutils/crypto/HashImpl.h>
+#include <bcos-framework/testutils/crypto/SignatureImpl.h>
+#include <boost/test/unit_test.hpp>
+#include <future>
+#include <thread>
+
+using namespace bcos;
+using namespace bcos::consensus;
+using namespace bcos::crypto;
+using namespace bcos::protocol;
+
+namespace bcos
+{
+namespace test
+{
+// the storage fails the first _failedPuts puts and the removes set by setFailedRemoves, and records
+// the puts and the persisted callbacks
+class FakeFlushStorage : public LedgerStorage
+{
+public:
+    using Ptr = std::shared_ptr<FakeFlushStorage>;
+    FakeFlushStorage(PBFTFixture::Ptr _faker, size_t _failedPuts)
+      : LedgerStorage(_faker->scheduler(), _faker->storage(), _faker->blockFactory(),
+            _faker->pbftConfig()->pbftMessageFactory()),
+        m_failedPuts(_failedPuts)
+    {}
+    ~FakeFlushStorage() override {}
+
+    void asyncPutProposal(std::string const& _dbName, std::string const& _key,
+        std::shared_ptr<std::string> _committedData, BlockNumber _proposalIndex,
+        std::function<void(Error::Ptr)> _onPut, size_t _retryTime) override
+    {
+        bool failed = false;
+        {
+            std::lock_guard<std::mutex> l(m_mutex);
+            m_events.push_back("put:" + _key);
+            if (m_failedPuts > 0)
+            {
+                m_failedPuts--;
+                failed = true;
+            }
+        }
+        if (failed)
+        {
+            _onPut(std::make_shared<Error>(-1, "put failed"));
+            return;
+        }
+        LedgerStorage::asyncPutProposal(
+            _dbName, _key, _committedData, _proposalIndex, _onPut, _retryTime);
+    }
+
+    void asyncRemove(std::string const& _dbName, std::string const& _key,
+        std::function<void(Error::Ptr)> _onRemoved) override
+    {
+        if (m_failedRemoves > 0)
+        {
+            m_failedRemoves--;
+            if (_onRemoved)
+            {
+                _onRemoved(std::make_shared<Error>(-1, "remove failed"));
+            }
+            return;
+        }
+        LedgerStorage::asyncRemove(_dbName, _key, _onRemoved);
+    }
+    void setFailedRemoves(size_t _failedRemoves) { m_failedRemoves = _failedRemoves; }
+
+    void recordEvent(std::string const& _event)
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        m_events.push_back(_event);
+    }
+    std::vector<std::string> events()
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        return m_events;
+    }
+    std::string const& maxCommittedProposalKey() const { return m_maxCommittedProposalKey; }
+    std::string const& compactedProposalKey() const { return m_compactedProposalKey; }
+    std::string const& commitDB() const { return m_pbftCommitDB; }
+
+private:
+    size_t m_failedPuts;
+    std::atomic<size_t> m_failedRemoves = {0};
+    std::vector<std::string> m_events;
+    std::mutex m_mutex;
+};
+
+inline size_t eventPos(std::vector<std::string> const& _events, std::string const& _event)
+{
+    auto it = std::find(_events.begin(), _events.end(), _event);
+    BOOST_CHECK(it != _events.end());
+    return it - _events.begin();
+}
+
+// commit the proposals in [_start, _end], return the future of the last persisted callback
+inline std::future<Error::Ptr> commitProposals(PBFTFixture::Ptr _faker,
+    FakeFlushStorage::Ptr _storage, BlockNumber _start, BlockNumber _end)
+{
+    auto result = std::make_shared<std::promise<Error::Ptr>>();
+    auto future = result->get_future();
+    auto hashImpl = _faker->pbftConfig()->cryptoSuite()->hashImpl();
+    for (auto i = _start; i <= _end; i++)
+    {
+        auto proposal = _faker->pbftConfig()->pbftMessageFactory()->createPBFTProposal();
+        proposal->setIndex(i);
+        proposal->setHash(hashImpl->hash(std::to_string(i)));
+        _storage->asyncCommitProposal(proposal, [_storage, result, i, _end](Error::Ptr _error) {
+            _storage->recordEvent("persisted:" + std::to_string(i));
+            if (i == _end)
+            {
+                result->set_value(_error);
+            }
+        });
+    }
+    return future;
+}
+
+// the value of _key in the commit table, empty when missed
+inline std::string readKey(
+    PBFTFixture::Ptr _faker, FakeFlushStorage::Ptr _storage, std::string const& _key)
+{
+    auto result = std::make_shared<std::promise<std::string>>();
+    auto future = result->get_future();
+    _faker->storage()->asyncGet(_storage->commitDB(), _key,
+        [result](Error::UniquePtr&& _error, std::string_view&& _value) {
+            result->set_value(_error ? std::string() : std::string(_value));
+        });
+    BOOST_CHECK(future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    return future.get();
+}
+
+// wait until the commit table compacted to _compactedIndex
+inline bool waitForCompaction(FakeFlushStorage::Ptr _storage, BlockNumber _compactedIndex)
+{
+    auto startT = utcTime();
+    while (_storage->compactedProposalIndex() < _compactedIndex)
+    {
+        if (utcTime() - startT > 10000)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+BOOST_FIXTURE_TEST_SUITE(LedgerStorageTest, TestPromptFixture)
+
+BOOST_AUTO_TEST_CASE(testFlushOrder)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto faker = createPBFTFixture(cryptoSuite);
+    auto storage = std::make_shared<FakeFlushStorage>(faker, 0);
+    auto stabledIndex = faker->ledger()->blockNumber();
+    storage->loadState(stabledIndex);
+    // batch the committed proposals into one flush
+    storage->setFlushInterval(50);
+
+    auto future = commitProposals(faker, storage, stabledIndex + 1, stabledIndex + 3);
+    BOOST_CHECK(future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    BOOST_CHECK(future.get() == nullptr);
+    BOOST_CHECK(storage->maxPersistedProposalIndex() == stabledIndex + 3);
+
+    // the max committed proposal index is written after all the proposals, and the callbacks are
+    // called in the committed order after the max committed proposal index is durable
+    auto events = storage->events();
+    auto maxIndexPos = eventPos(events, "put:" + storage->maxCommittedProposalKey());
+    size_t lastPos = maxIndexPos;
+    for (auto i = stabledIndex + 1; i <= stabledIndex + 3; i++)
+    {
+        BOOST_CHECK(eventPos(events, "put:" + LedgerStorage::proposalKey(i)) < maxIndexPos);
+        auto persistedPos = eventPos(events, "persisted:" + std::to_string(i));
+        BOOST_CHECK(persistedPos > lastPos);
+        lastPos = persistedPos;
+    }
+
+    // the persisted proposal is notified immediately
+    future = commitProposals(faker, storage, stabledIndex + 3, stabledIndex + 3);
+    BOOST_CHECK(future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    BOOST_CHECK(future.get() == nullptr);
+
+    // the committed proposals can be loaded after restart
+    auto restartedStorage = std::make_shared<FakeFlushStorage>(faker, 0);
+    auto proposals = restartedStorage->loadState(stabledIndex);
+    BOOST_CHECK(proposals && proposals->size() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(testFlushFailed)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto faker = createPBFTFixture(cryptoSuite);
+    // the first two flushes fail
+    auto storage = std::make_shared<FakeFlushStorage>(faker, 2);
+    auto stabledIndex = faker->ledger()->blockNumber();
+    storage->loadState(stabledIndex);
+    storage->setFlushRetryInterval(10);
+
+    auto startT = utcTime();
+    auto future = commitProposals(faker, storage, stabledIndex + 1, stabledIndex + 1);
+    BOOST_CHECK(future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    // the callback is called once with success after the failed flushes retried with backoff
+    BOOST_CHECK(future.get() == nullptr);
+    BOOST_CHECK(utcTime() - startT >= 30);
+    BOOST_CHECK(storage->maxPersistedProposalIndex() == stabledIndex + 1);
+
+    auto events = storage->events();
+    auto proposalPut = "put:" + LedgerStorage::proposalKey(stabledIndex + 1);
+    auto maxIndexPut = "put:" + storage->maxCommittedProposalKey();
+    BOOST_CHECK(std::count(events.begin(), events.end(), proposalPut) == 3);
+    // the max committed proposal index is not written until the proposal is durable
+    BOOST_CHECK(std::count(events.begin(), events.end(), maxIndexPut) == 1);
+    BOOST_CHECK(events[events.size() - 3] == proposalPut);
+    BOOST_CHECK(events[events.size() - 2] == maxIndexPut);
+    BOOST_CHECK(events.back() == "persisted:" + std::to_string(stabledIndex + 1));
+}
+
+BOOST_AUTO_TEST_CASE(testCompaction)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto faker = createPBFTFixture(cryptoSuite);
+    auto storage = std::make_shared<FakeFlushStorage>(faker, 0);
+    auto stabledIndex = faker->ledger()->blockNumber();
+    storage->loadState(stabledIndex);
+    auto future = commitProposals(faker, storage, stabledIndex + 1, stabledIndex + 10);
+    BOOST_CHECK(future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+
+    // the proposals are stored with the decimal keys of the existing commit tables
+    BOOST_CHECK(LedgerStorage::proposalKey(stabledIndex + 1) == std::to_string(stabledIndex + 1));
+    BOOST_CHECK(!readKey(faker, storage, std::to_string(stabledIndex + 1)).empty());
+
+    // compact to the low watermark
+    storage->asyncCompactCommittedProposals(stabledIndex + 5);
+    BOOST_CHECK(waitForCompaction(storage, stabledIndex + 5));
+    BOOST_CHECK(storage->compactedProposalIndex() == stabledIndex + 5);
+    for (auto i = stabledIndex + 1; i <= stabledIndex + 10; i++)
+    {
+        auto value = readKey(faker, storage, LedgerStorage::proposalKey(i));
+        BOOST_CHECK(value.empty() == (i <= stabledIndex + 5));
+    }
+    BOOST_CHECK(storage->committedTableSize() == 5);
+    BOOST_CHECK(readKey(faker, storage, storage->compactedProposalKey()) ==
+                std::to_string(stabledIndex + 5));
+
+    // the watermark only rises
+    storage->asyncCompactCommittedProposals(stabledIndex + 3);
+    storage->asyncCompactCommittedProposals(stabledIndex + 7);
+    BOOST_CHECK(waitForCompaction(storage, stabledIndex + 7));
+    BOOST_CHECK(readKey(faker, storage, LedgerStorage::proposalKey(stabledIndex + 7)).empty());
+    BOOST_CHECK(!readKey(faker, storage, LedgerStorage::proposalKey(stabledIndex + 8)).empty());
+    BOOST_CHECK(storage->committedTableSize() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(testCompactionResume)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto faker = createPBFTFixture(cryptoSuite);
+    auto storage = std::make_shared<FakeFlushStorage>(faker, 0);
+    auto stabledIndex = faker->ledger()->blockNumber();
+    storage->loadState(stabledIndex);
+    auto future = commitProposals(faker, storage, stabledIndex + 1, stabledIndex + 10);
+    BOOST_CHECK(future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    storage->asyncCompactCommittedProposals(stabledIndex + 3);
+    BOOST_CHECK(waitForCompaction(storage, stabledIndex + 3));
+
+    // the batch failed to remove is not recorded as compacted
+    storage->setFailedRemoves(1);
+    storage->asyncCompactCommittedProposals(stabledIndex + 6);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    BOOST_CHECK(storage->compactedProposalIndex() == stabledIndex + 3);
+    BOOST_CHECK(readKey(faker, storage, storage->compactedProposalKey()) ==
+                std::to_string(stabledIndex + 3));
+
+    // the restarted node resumes from the persisted compacted index and reclaims the leftovers
+    auto restartedStorage = std::make_shared<FakeFlushStorage>(faker, 0);
+    restartedStorage->asyncCompactCommittedProposals(stabledIndex + 6);
+    BOOST_CHECK(waitForCompaction(restartedStorage, stabledIndex + 6));
+    for (auto i = stabledIndex + 1; i <= stabledIndex + 10; i++)
+    {
+        auto value = readKey(faker, restartedStorage, LedgerStorage::proposalKey(i));
+        BOOST_CHECK(value.empty() == (i <= stabledIndex + 6));
+    }
+    BOOST_CHECK(readKey(faker, restartedStorage, restartedStorage->compactedProposalKey()) ==
+                std::to_string(stabledIndex + 6));
+}
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
@@ -0,0 +1,195 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief unit tests for the batched consensus messages
+ * @file PBFTBatchMsgTest.cpp
+ * @author: yujiechen
+ * @date 2021-06-11
+ */
+#include "test/unittests/pbft/PBFTFixture.h"
+#include "test/unittests/protocol/FakePBFTMessage.h"
+#include <bcos-framework/interfaces/crypto/CryptoSuite.h>
+#include <bcos-framework/testutils/TestPromptFixture.h>
+#include <bcos-framework/testutils/crypto/HashImpl.h>
+#include <bcos-framework/testutils/crypto/SignatureImpl.h>
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+using namespace bcos;
+using namespace bcos::consensus;
+using namespace bcos::crypto;
+using namespace bcos::protocol;
+
+namespace bcos
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(PBFTBatchMsgTest, TestPromptFixture)
+
+// the vote of _voter signed with its proposal signature
+inline PBFTProposalInterface::Ptr fakeVoteEntry(CryptoSuite::Ptr _cryptoSuite,
+    PBFTFixture::Ptr _voter, PacketType _packetType, BlockNumber _index, HashType const& _hash)
+{
+    auto config = _voter->pbftConfig();
+    auto msgFixture = std::make_shared<PBFTMessageFixture>(_cryptoSuite, _voter->keyPair());
+    auto proposal = msgFixture->fakePBFTProposal(
+        _index, _hash, bytes(), std::vector<int64_t>(), std::vector<bytes>());
+    auto voteMsg = config->pbftMessageFactory()->populateFrom(_packetType,
+        config->pbftMsgDefaultVersion(), config->view(), utcTime(), config->nodeIndex(), proposal,
+        _cryptoSuite, _voter->keyPair(), true);
+    return voteMsg->consensusProposal();
+}
+
+// the batch signed by _signer on behalf of _generatedFrom, decoded by _receiver
+inline PBFTMessageInterface::Ptr fakeBatchMsg(PBFTFixture::Ptr _signer,
+    PBFTFixture::Ptr _receiver, PacketType _packetType, IndexType _generatedFrom,
+    PBFTProposalList const& _entries)
+{
+    auto config = _signer->pbftConfig();
+    auto batchMsg = config->pbftMessageFactory()->createPBFTMsg();
+    batchMsg->setPacketType(_packetType);
+    batchMsg->setVersion(config->pbftMsgDefaultVersion());
+    batchMsg->setView(config->view());
+    batchMsg->setTimestamp(utcTime());
+    batchMsg->setGeneratedFrom(_generatedFrom);
+    batchMsg->setIndex(_entries[0]->index());
+    batchMsg->setProposals(_entries);
+    batchMsg->setHash(_signer->pbftEngine()->cacheProcessor()->calculateBatchDigest(batchMsg));
+    auto encodedData = config->codec()->encode(batchMsg);
+    return std::dynamic_pointer_cast<PBFTMessageInterface>(
+        _receiver->pbftConfig()->codec()->decode(ref(*encodedData)));
+}
+
+BOOST_AUTO_TEST_CASE(testBatchMsgForgery)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto fakerMap = createFakers(cryptoSuite, 4, 10, 0);
+    auto receiver = fakerMap[0];
+    auto voter = fakerMap[1];
+    auto attacker = fakerMap[2];
+    auto engine = receiver->pbftEngine();
+    auto cacheProcessor = std::dynamic_pointer_cast<FakeCacheProcessor>(engine->cacheProcessor());
+    auto& caches = cacheProcessor->caches();
+
+    auto index = receiver->pbftConfig()->committedProposal()->index() + 1;
+    auto hash = hashImpl->hash(std::string("batchMsg"));
+    auto voterIndex = voter->pbftConfig()->nodeIndex();
+    auto prepareEntry = fakeVoteEntry(cryptoSuite, voter, PacketType::PreparePacket, index, hash);
+    auto entries = PBFTProposalList{prepareEntry};
+
+    // case1: the prepare entry relabelled into a CommitBatch signed by another node
+    auto forgedBatch = fakeBatchMsg(
+        attacker, receiver, PacketType::CommitBatchPacket, voterIndex, entries);
+    engine->handleBatchMsg(forgedBatch);
+    BOOST_CHECK(caches.count(index) == 0);
+
+    // case2: the PrepareBatch of the voter relabelled into a CommitBatch
+    auto relabelledBatch = fakeBatchMsg(
+        voter, receiver, PacketType::PrepareBatchPacket, voterIndex, entries);
+    relabelledBatch->setPacketType(PacketType::CommitBatchPacket);
+    engine->handleBatchMsg(relabelledBatch);
+    BOOST_CHECK(caches.count(index) == 0);
+
+    // case3: the entries replaced after signed
+    auto otherHash = hashImpl->hash(std::string("otherBatchMsg"));
+    auto otherEntry =
+        fakeVoteEntry(cryptoSuite, voter, PacketType::PreparePacket, index, otherHash);
+    auto replacedBatch = fakeBatchMsg(
+        voter, receiver, PacketType::PrepareBatchPacket, voterIndex, entries);
+    replacedBatch->setProposals(PBFTProposalList{otherEntry});
+    engine->handleBatchMsg(replacedBatch);
+    BOOST_CHECK(caches.count(index) == 0);
+
+    // case4: the batch signed by the voter is accepted as the votes of the signed packetType
+    auto validBatch = fakeBatchMsg(
+        voter, receiver, PacketType::PrepareBatchPacket, voterIndex, entries);
+    engine->handleBatchMsg(validBatch);
+    BOOST_CHECK(caches.count(index));
+    auto cache = std::dynamic_pointer_cast<FakePBFTCache>(caches[index]);
+    BOOST_CHECK(cache->prepareWeight(hash) > 0);
+    BOOST_CHECK(cache->commitWeight(hash) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testBatchedVotesToCollectors)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto fakerMap = createFakers(cryptoSuite, 4, 10, 4);
+    for (auto const& it : fakerMap)
+    {
+        auto config = it.second->pbftConfig();
+        config->setBatchConsensusMsg(true);
+        config->setCollectorMode(true);
+        config->setLeaderSwitchPeriod(1);
+    }
+    // the sender collects the votes of the first index, every index has a different collector
+    auto index = fakerMap[0]->pbftConfig()->committedProposal()->index() + 1;
+    auto sender = fakerMap[fakerMap[0]->pbftConfig()->leaderIndex(index)];
+    auto senderConfig = sender->pbftConfig();
+    auto hash = hashImpl->hash(std::string("batchedVotes"));
+    size_t voteSize = 3;
+    for (size_t i = 0; i < voteSize; i++)
+    {
+        auto voteIndex = index + i;
+        auto voteEntry =
+            fakeVoteEntry(cryptoSuite, sender, PacketType::PreparePacket, voteIndex, hash);
+        auto voteMsg = senderConfig->pbftMessageFactory()->populateFrom(PacketType::PreparePacket,
+            senderConfig->pbftMsgDefaultVersion(), senderConfig->view(), utcTime(),
+            senderConfig->nodeIndex(), voteEntry, cryptoSuite, sender->keyPair(), true);
+        BOOST_CHECK(sender->pbftEngine()->cacheProcessor()->tryToBatchConsensusMsg(voteMsg));
+    }
+    auto senderProcessor =
+        std::dynamic_pointer_cast<FakeCacheProcessor>(sender->pbftEngine()->cacheProcessor());
+    senderProcessor->flushBatchedConsensusMsg(true);
+    BOOST_CHECK(senderProcessor->batchedConsensusMsgSize() == 0);
+    // the sender waits for the certificate of every index collected by the others
+    auto const& collectorVoteTime = senderProcessor->collectorVoteTime();
+    BOOST_CHECK(collectorVoteTime.count(index) == 0);
+    for (size_t i = 1; i < voteSize; i++)
+    {
+        BOOST_CHECK(collectorVoteTime.count(index + i));
+    }
+
+    // every collector only receives the vote of the index it collects
+    for (size_t i = 1; i < voteSize; i++)
+    {
+        auto collector = fakerMap[senderConfig->leaderIndex(index + i)];
+        auto engine = collector->pbftEngine();
+        auto startT = utcTime();
+        while (engine->msgQueue()->empty() && (utcTime() - startT) <= 60 * 1000)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        engine->executeWorker();
+        auto& caches =
+            std::dynamic_pointer_cast<FakeCacheProcessor>(engine->cacheProcessor())->caches();
+        BOOST_CHECK(caches.size() == 1);
+        BOOST_CHECK(caches.count(index + i));
+        auto cache = std::dynamic_pointer_cast<FakePBFTCache>(caches[index + i]);
+        BOOST_CHECK(cache->prepareWeight(hash) > 0);
+    }
+    // the node that collects none of the indexes receives nothing
+    auto idleNode = fakerMap[senderConfig->leaderIndex(index + voteSize)];
+    auto idleProcessor =
+        std::dynamic_pointer_cast<FakeCacheProcessor>(idleNode->pbftEngine()->cacheProcessor());
+    idleNode->pbftEngine()->executeWorker();
+    BOOST_CHECK(idleProcessor->caches().empty());
+}
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
@@ -0,0 +1,155 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief unit tests for the certificates broadcasted by the collector
+ * @file PBFTCertificateTest.cpp
+ * @author: yujiechen
+ * @date 2021-06-11
+ */
+#include "test/unittests/pbft/PBFTFixture.h"
+#include <bcos-framework/interfaces/crypto/CryptoSuite.h>
+#include <bcos-framework/testutils/TestPromptFixture.h>
+#include <bcos-framework/testutils/crypto/HashImpl.h>
+#include <bcos-framework/testutils/crypto/SignatureImpl.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace bcos;
+using namespace bcos::consensus;
+using namespace bcos::crypto;
+using namespace bcos::protocol;
+
+namespace bcos
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(PBFTCertificateTest, TestPromptFixture)
+
+// the proposal with the _voteType votes of all the fakers
+inline PBFTProposalInterface::Ptr fakeCertificateProposal(CryptoSuite::Ptr _cryptoSuite,
+    std::map<IndexType, PBFTFixture::Ptr>& _fakerMap, PacketType _voteType, ViewType _view,
+    BlockNumber _index, HashType const& _hash)
+{
+    auto proposal = _fakerMap[0]->pbftConfig()->pbftMessageFactory()->createPBFTProposal();
+    proposal->setIndex(_index);
+    proposal->setHash(_hash);
+    for (auto const& it : _fakerMap)
+    {
+        auto config = it.second->pbftConfig();
+        auto signedHash = config->voteSignatureHash(
+            _voteType, _view, _index, _hash, config->voteMsgVersion());
+        auto signature = _cryptoSuite->signatureImpl()->sign(it.second->keyPair(), signedHash);
+        proposal->appendSignatureProof(it.first, ref(*signature));
+    }
+    return proposal;
+}
+
+// the certificate signed by _signer on behalf of _generatedFrom, decoded by _receiver
+inline PBFTMessageInterface::Ptr fakeCertificate(PBFTFixture::Ptr _signer,
+    PBFTFixture::Ptr _receiver, PacketType _packetType, IndexType _generatedFrom, ViewType _view,
+    PBFTProposalInterface::Ptr _proposal)
+{
+    auto config = _signer->pbftConfig();
+    auto certificate = config->pbftMessageFactory()->populateFrom(_packetType, _proposal,
+        config->voteMsgVersion(), _view, utcTime(), _generatedFrom);
+    auto encodedData = config->codec()->encode(certificate);
+    return std::dynamic_pointer_cast<PBFTMessageInterface>(
+        _receiver->pbftConfig()->codec()->decode(ref(*encodedData)));
+}
+
+BOOST_AUTO_TEST_CASE(testCertificateForgery)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    size_t consensusNodeSize = 4;
+    auto fakerMap = createFakers(cryptoSuite, consensusNodeSize, 10, 0);
+
+    auto config = fakerMap[0]->pbftConfig();
+    auto index = config->committedProposal()->index() + 1;
+    auto view = config->view();
+    // the commit votes sign the proposal hash by default to be verified by the older nodes
+    auto rawHash = hashImpl->hash(std::string("rawCommitVote"));
+    BOOST_CHECK(config->voteMsgVersion() == (int32_t)config->pbftMsgDefaultVersion());
+    BOOST_CHECK(config->voteSignatureHash(PacketType::CommitPacket, view, index, rawHash,
+                    config->voteMsgVersion()) == rawHash);
+    for (auto const& it : fakerMap)
+    {
+        it.second->pbftConfig()->setCommitVoteDigest(true);
+    }
+    BOOST_CHECK(config->voteSignatureHash(PacketType::CommitPacket, view, index, rawHash,
+                    config->voteMsgVersion()) != rawHash);
+    auto collectorIndex = config->leaderIndex(index);
+    auto collector = fakerMap[collectorIndex];
+    auto receiver = fakerMap[(collectorIndex + 1) % consensusNodeSize];
+    auto engine = receiver->pbftEngine();
+    auto cacheProcessor = std::dynamic_pointer_cast<FakeCacheProcessor>(engine->cacheProcessor());
+    auto& caches = cacheProcessor->caches();
+    auto hash = hashImpl->hash(std::string("certificate"));
+
+    auto prepareProof = fakeCertificateProposal(
+        cryptoSuite, fakerMap, PacketType::PreparePacket, view, index, hash);
+    auto commitProof = fakeCertificateProposal(
+        cryptoSuite, fakerMap, PacketType::CommitPacket, view, index, hash);
+    // the prepare votes and the commit votes sign different payloads
+    BOOST_CHECK(prepareProof->signatureProof(0).second.toBytes() !=
+                commitProof->signatureProof(0).second.toBytes());
+
+    // case1: the prepare certificate relabelled as the commit certificate
+    auto certificate = fakeCertificate(collector, receiver, PacketType::CommitCertificatePacket,
+        collectorIndex, view, prepareProof);
+    BOOST_CHECK(engine->handleCertificateMsg(certificate) == false);
+    // case2: the commit certificate relabelled as the prepare certificate
+    certificate = fakeCertificate(collector, receiver, PacketType::PrepareCertificatePacket,
+        collectorIndex, view, commitProof);
+    BOOST_CHECK(engine->handleCertificateMsg(certificate) == false);
+    BOOST_CHECK(caches.count(index) == 0);
+
+    // case3: the certificate signed by the node other than the collector
+    auto otherNode = fakerMap[(collectorIndex + 2) % consensusNodeSize];
+    certificate = fakeCertificate(otherNode, receiver, PacketType::CommitCertificatePacket,
+        collectorIndex, view, commitProof);
+    BOOST_CHECK(engine->handleCertificateMsg(certificate) == false);
+    // case4: the certificate generated by the node other than the collector
+    certificate = fakeCertificate(otherNode, receiver, PacketType::CommitCertificatePacket,
+        otherNode->pbftConfig()->nodeIndex(), view, commitProof);
+    BOOST_CHECK(engine->handleCertificateMsg(certificate) == false);
+
+    // case5: the commit votes of another view
+    auto nextViewProof = fakeCertificateProposal(
+        cryptoSuite, fakerMap, PacketType::CommitPacket, view + 1, index, hash);
+    certificate = fakeCertificate(collector, receiver, PacketType::CommitCertificatePacket,
+        collectorIndex, view, nextViewProof);
+    BOOST_CHECK(engine->handleCertificateMsg(certificate) == false);
+    // case6: the certificate of another view
+    certificate = fakeCertificate(collector, receiver, PacketType::CommitCertificatePacket,
+        collectorIndex, view + 1, nextViewProof);
+    BOOST_CHECK(engine->handleCertificateMsg(certificate) == false);
+    BOOST_CHECK(caches.count(index) == 0);
+
+    // case7: the valid certificates are expanded into the votes
+    certificate = fakeCertificate(collector, receiver, PacketType::PrepareCertificatePacket,
+        collectorIndex, view, prepareProof);
+    BOOST_CHECK(engine->handleCertificateMsg(certificate) == true);
+    certificate = fakeCertificate(collector, receiver, PacketType::CommitCertificatePacket,
+        collectorIndex, view, commitProof);
+    BOOST_CHECK(engine->handleCertificateMsg(certificate) == true);
+    BOOST_CHECK(caches.count(index));
+    auto cache = std::dynamic_pointer_cast<FakePBFTCache>(caches[index]);
+    BOOST_CHECK(cache->prepareWeight(hash) >= config->minRequiredQuorum());
+    BOOST_CHECK(cache->commitWeight(hash) >= config->minRequiredQuorum());
+}
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
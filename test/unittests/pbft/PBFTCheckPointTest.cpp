@@ -0,0 +1,201 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief unit tests for the range and piggybacked checkpoints
+ * @file PBFTCheckPointTest.cpp
+ * @author: yujiechen
+ * @date 2021-06-10
+ */
+#include "test/unittests/pbft/PBFTFixture.h"
+#include "test/unittests/protocol/FakePBFTMessage.h"
+#include <bcos-framework/interfaces/crypto/CryptoSuite.h>
+#include <bcos-framework/testutils/TestPromptFixture.h>
+#include <bcos-framework/testutils/crypto/HashImpl.h>
+#include <bcos-framework/testutils/crypto/SignatureImpl.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace bcos;
+using namespace bcos::consensus;
+using namespace bcos::crypto;
+using namespace bcos::protocol;
+
+namespace bcos
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(PBFTCheckPointTest, TestPromptFixture)
+
+inline PBFTMessageInterface::Ptr fakeCheckPointMsg(
+    PBFTFixture::Ptr _faker, CryptoSuite::Ptr _cryptoSuite, BlockNumber _index)
+{
+    auto config = _faker->pbftConfig();
+    auto msgFixture = std::make_shared<PBFTMessageFixture>(_cryptoSuite, _faker->keyPair());
+    auto hash = _cryptoSuite->hashImpl()->hash(std::to_string(_index));
+    auto proposal = msgFixture->fakePBFTProposal(
+        _index, hash, bytes(), std::vector<int64_t>(), std::vector<bytes>());
+    return config->pbftMessageFactory()->populateFrom(PacketType::CheckPoint,
+        config->pbftMsgDefaultVersion(), config->view(), utcTime(), config->nodeIndex(), proposal,
+        _cryptoSuite, _faker->keyPair(), true);
+}
+
+inline PBFTFixture::Ptr createSingleNodeFaker(CryptoSuite::Ptr _cryptoSuite)
+{
+    auto faker = createPBFTFixture(_cryptoSuite);
+    faker->appendConsensusNode(faker->nodeID());
+    faker->init();
+    return faker;
+}
+
+BOOST_AUTO_TEST_CASE(testRangeCheckPointFlush)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto faker = createSingleNodeFaker(cryptoSuite);
+    auto config = faker->pbftConfig();
+    auto engine = faker->pbftEngine();
+    auto cacheProcessor = engine->cacheProcessor();
+
+    config->setCheckPointInterval(3);
+    config->setMaxCheckPointDelay(100);
+    config->setExecutionBacklog(1);
+    // reset the flush time
+    cacheProcessor->fetchPendingCheckPoints();
+    auto index = config->committedProposal()->index() + 1;
+
+    // case1: reach the checkPointInterval
+    BOOST_CHECK(engine->collectCheckPointMsg(fakeCheckPointMsg(faker, cryptoSuite, index)) ==
+                nullptr);
+    BOOST_CHECK(engine->collectCheckPointMsg(fakeCheckPointMsg(faker, cryptoSuite, index + 1)) ==
+                nullptr);
+    BOOST_CHECK(cacheProcessor->pendingCheckPointSize() == 2);
+    auto rangeCheckPoint =
+        engine->collectCheckPointMsg(fakeCheckPointMsg(faker, cryptoSuite, index + 2));
+    BOOST_CHECK(rangeCheckPoint != nullptr);
+    BOOST_CHECK(rangeCheckPoint->index() == index + 2);
+    BOOST_CHECK(rangeCheckPoint->proposals().size() == 2);
+    BOOST_CHECK(rangeCheckPoint->proposals()[0]->index() == index);
+    BOOST_CHECK(rangeCheckPoint->proposals()[1]->index() == index + 1);
+    BOOST_CHECK(cacheProcessor->pendingCheckPointSize() == 0);
+
+    // case2: flushed by the timer when no more proposal executed
+    BOOST_CHECK(engine->collectCheckPointMsg(fakeCheckPointMsg(faker, cryptoSuite, index + 3)) ==
+                nullptr);
+    BOOST_CHECK(cacheProcessor->pendingCheckPointSize() == 1);
+    auto startT = utcTime();
+    while (cacheProcessor->pendingCheckPointSize() > 0 && (utcTime() - startT <= 10 * 1000))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    BOOST_CHECK(cacheProcessor->pendingCheckPointSize() == 0);
+    // not flushed before maxCheckPointDelay
+    BOOST_CHECK(utcTime() - startT >= 50);
+
+    // case3: broadcast at once when no proposal waiting for execution
+    config->setExecutionBacklog(0);
+    rangeCheckPoint =
+        engine->collectCheckPointMsg(fakeCheckPointMsg(faker, cryptoSuite, index + 4));
+    BOOST_CHECK(rangeCheckPoint != nullptr);
+    BOOST_CHECK(rangeCheckPoint->proposals().size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testHandleRangeCheckPoints)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto faker = createSingleNodeFaker(cryptoSuite);
+    auto config = faker->pbftConfig();
+    auto engine = faker->pbftEngine();
+    auto cacheProcessor = std::dynamic_pointer_cast<FakeCacheProcessor>(engine->cacheProcessor());
+
+    auto index = config->committedProposal()->index() + 1;
+    PBFTProposalList checkPoints;
+    for (BlockNumber i = index; i < index + 3; i++)
+    {
+        checkPoints.push_back(fakeCheckPointMsg(faker, cryptoSuite, i)->consensusProposal());
+    }
+    // the proposal with invalid signature
+    auto invalidCheckPoint = fakeCheckPointMsg(faker, cryptoSuite, index + 3)->consensusProposal();
+    invalidCheckPoint->setSignature(checkPoints[0]->signature().toBytes());
+    checkPoints.push_back(invalidCheckPoint);
+    // the proposal no smaller than the range checkpoint
+    checkPoints.push_back(fakeCheckPointMsg(faker, cryptoSuite, index + 10)->consensusProposal());
+
+    auto rangeCheckPoint = fakeCheckPointMsg(faker, cryptoSuite, index + 5);
+    rangeCheckPoint->setProposals(checkPoints);
+    engine->handleRangeCheckPoints(rangeCheckPoint);
+    auto& caches = cacheProcessor->caches();
+    for (BlockNumber i = index; i < index + 3; i++)
+    {
+        auto hash = cryptoSuite->hashImpl()->hash(std::to_string(i));
+        BOOST_CHECK(caches.count(i));
+        BOOST_CHECK(caches[i]->getCollectedCheckPointWeight(hash) == 1);
+    }
+    BOOST_CHECK(caches.count(index + 3) == 0);
+    BOOST_CHECK(caches.count(index + 10) == 0);
+}
+BOOST_AUTO_TEST_CASE(testPiggybackCheckPoints)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto faker = createSingleNodeFaker(cryptoSuite);
+    auto config = faker->pbftConfig();
+    auto engine = faker->pbftEngine();
+    auto cacheProcessor = std::dynamic_pointer_cast<FakeCacheProcessor>(engine->cacheProcessor());
+    config->setPiggybackCheckPoint(true);
+
+    auto index = config->committedProposal()->index() + 1;
+    for (BlockNumber i = index; i < index + 4; i++)
+    {
+        cacheProcessor->addPendingCheckPoint(
+            fakeCheckPointMsg(faker, cryptoSuite, i)->consensusProposal());
+    }
+    // case1: only the checkpoints lower than the carrier are piggybacked, the others are kept
+    auto carrier = fakeCheckPointMsg(faker, cryptoSuite, index + 2);
+    carrier->setPacketType(PacketType::CommitPacket);
+    cacheProcessor->piggybackCheckPoints(carrier);
+    BOOST_CHECK(carrier->proposals().size() == 2);
+    BOOST_CHECK(cacheProcessor->pendingCheckPointSize() == 2);
+    for (auto const& checkPoint : carrier->proposals())
+    {
+        BOOST_CHECK(checkPoint->index() < carrier->index());
+    }
+    // no checkpoint lower than the carrier
+    auto lowerCarrier = fakeCheckPointMsg(faker, cryptoSuite, index);
+    lowerCarrier->setPacketType(PacketType::CommitPacket);
+    cacheProcessor->piggybackCheckPoints(lowerCarrier);
+    BOOST_CHECK(lowerCarrier->proposals().empty());
+    BOOST_CHECK(cacheProcessor->pendingCheckPointSize() == 2);
+
+    // case2: the checkpoints carried by the unsigned message are rejected
+    auto& caches = cacheProcessor->caches();
+    engine->handlePiggybackedCheckPoints(carrier, false);
+    BOOST_CHECK(caches.count(index) == 0);
+    BOOST_CHECK(caches.count(index + 1) == 0);
+
+    // case3: the checkpoints carried by the validated message are accepted
+    engine->handlePiggybackedCheckPoints(carrier, true);
+    for (BlockNumber i = index; i < index + 2; i++)
+    {
+        auto hash = cryptoSuite->hashImpl()->hash(std::to_string(i));
+        BOOST_CHECK(caches.count(i));
+        BOOST_CHECK(caches[i]->getCollectedCheckPointWeight(hash) == 1);
+    }
+}
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
@@ -25,6 +25,7 @@
 #include <bcos-framework/testutils/crypto/HashImpl.h>
 #include <bcos-framework/testutils/crypto/SignatureImpl.h>
 #include <boost/test/unit_test.hpp>
+#include <thread>
 
 using namespace bcos;
 using namespace bcos::consensus;
@@ -100,7 +101,16 @@ BOOST_AUTO_TEST_CASE(testPBFTInit)
         auto node = pbftConfig->getConsensusNodeByIndex(nodeIndex);
         BOOST_CHECK(node->nodeID()->data() == faker->nodeID()->data());
     }
-    BOOST_CHECK(pbftConfig->consensusNodeList().size() == (consensusNodesSize + 1));
+    BOOST_CHECK(pbftConfig->consensusNodeList()->size() == (consensusNodesSize + 1));
+    // check the snapshot of the consensus node list
+    auto snapshot = pbftConfig->nodeSnapshot();
+    BOOST_CHECK(snapshot->size() == (consensusNodesSize + 1));
+    BOOST_CHECK(snapshot->nodeIndex(faker->nodeID()->data()) == pbftConfig->nodeIndex());
+    BOOST_CHECK(snapshot->nodeIDList(true).size() == consensusNodesSize);
+    BOOST_CHECK(snapshot->minRequiredQuorum() == pbftConfig->minRequiredQuorum());
+    // the snapshot is kept when the consensus node list not changed
+    faker->init();
+    BOOST_CHECK(pbftConfig->nodeEpoch() == snapshot->epoch());
     BOOST_CHECK(pbftConfig->nodeID()->data() == faker->nodeID()->data());
 
     // check params
@@ -144,6 +154,9 @@ BOOST_AUTO_TEST_CASE(testPBFTInit)
     // case5: with new committed index and valid data, collect enough checkpoint proposal and commit
     // it
     std::cout << "##### case5: with new committed index and valid data" << std::endl;
+    // the lists held by the readers are shared with the replaced snapshot
+    auto heldNodeList = pbftConfig->consensusNodeList();
+    auto heldNodeIDList = pbftConfig->consensusNodeIDList(false);
     faker->clearConsensusNodeList();
     faker->appendConsensusNode(faker->nodeID());
     auto blockHeader = block->blockHeader();
@@ -152,6 +165,10 @@ BOOST_AUTO_TEST_CASE(testPBFTInit)
     pbftConfig->storage()->asyncCommitProposal(fakedProposal);
     faker->init();
     BOOST_CHECK(pbftConfig->minRequiredQuorum() == 1);
+    BOOST_CHECK(heldNodeList->size() == (consensusNodesSize + 1));
+    BOOST_CHECK(heldNodeIDList->size() == (consensusNodesSize + 1));
+    BOOST_CHECK(pbftConfig->consensusNodeList()->size() == 1);
+    BOOST_CHECK(pbftConfig->consensusNodeList().get() != heldNodeList.get());
     auto startT = utcTime();
     while (pbftConfig->committedProposal()->index() != proposalIndex &&
            (utcTime() - startT <= 60 * 1000))
@@ -162,6 +179,130 @@ BOOST_AUTO_TEST_CASE(testPBFTInit)
     BOOST_CHECK(pbftConfig->progressedIndex() == proposalIndex + 1);
     BOOST_CHECK(cacheProcessor->committedQueueSize() == 0);
     BOOST_CHECK(cacheProcessor->stableCheckPointQueueSize() == 0);
+    // the backlog has been drained after the proposal committed
+    BOOST_CHECK(pbftConfig->commitBacklog() == 0);
+    BOOST_CHECK(pbftConfig->sealStallReason() == SealStallReason::NoStall);
+}
+BOOST_AUTO_TEST_CASE(testSealerBackPressure)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto faker = createPBFTFixture(cryptoSuite);
+    faker->appendConsensusNode(faker->nodeID());
+    faker->init();
+    auto pbftConfig = std::dynamic_pointer_cast<FakePBFTConfig>(faker->pbftConfig());
+    // disabled by default
+    BOOST_CHECK(pbftConfig->maxExecutionBacklog() == 0);
+    BOOST_CHECK(pbftConfig->maxCommitBacklog() == 0);
+    pbftConfig->setExecutionBacklog(100);
+    BOOST_CHECK(pbftConfig->sealingHeldBack() == false);
+
+    // case1: exceed the execution backlog
+    pbftConfig->setMaxExecutionBacklog(2);
+    pbftConfig->setMaxCommitBacklog(2);
+    pbftConfig->setExecutionBacklog(2);
+    BOOST_CHECK(pbftConfig->sealingHeldBack());
+    auto sealEndIndex = pbftConfig->sealEndIndex();
+    auto sealIndex = std::max(sealEndIndex + 1, pbftConfig->sealStartIndex());
+    pbftConfig->notifySealer(sealIndex);
+    BOOST_CHECK(pbftConfig->sealStallReason() == SealStallReason::ExecutionBacklog);
+    BOOST_CHECK(pbftConfig->sealEndIndex() == sealEndIndex);
+    // still stalled when the backlog is not drained
+    pbftConfig->setExecutionBacklog(3);
+    pbftConfig->tryToResumeSealing();
+    BOOST_CHECK(pbftConfig->sealStallReason() == SealStallReason::ExecutionBacklog);
+    BOOST_CHECK(pbftConfig->sealEndIndex() == sealEndIndex);
+    // resume from the deferred index
+    pbftConfig->setExecutionBacklog(1);
+    pbftConfig->tryToResumeSealing();
+    BOOST_CHECK(pbftConfig->sealStallReason() == SealStallReason::NoStall);
+    BOOST_CHECK(pbftConfig->sealEndIndex() >= sealIndex);
+
+    // case2: exceed the commit backlog
+    auto expectedCheckPoint = pbftConfig->expectedCheckPoint();
+    auto committedIndex = pbftConfig->committedProposal()->index();
+    pbftConfig->setExpectedCheckPoint(committedIndex + 3);
+    BOOST_CHECK(pbftConfig->commitBacklog() == 2);
+    sealEndIndex = pbftConfig->sealEndIndex();
+    sealIndex = sealEndIndex + 1;
+    pbftConfig->notifySealer(sealIndex);
+    BOOST_CHECK(pbftConfig->sealStallReason() == SealStallReason::CommitBacklog);
+    BOOST_CHECK(pbftConfig->sealEndIndex() == sealEndIndex);
+    BOOST_CHECK(pbftConfig->sealingHeldBack());
+    // the ledger committed the executed proposals
+    pbftConfig->setExpectedCheckPoint(expectedCheckPoint);
+    BOOST_CHECK(pbftConfig->commitBacklog() == 0);
+    pbftConfig->tryToResumeSealing();
+    BOOST_CHECK(pbftConfig->sealStallReason() == SealStallReason::NoStall);
+    BOOST_CHECK(pbftConfig->sealEndIndex() >= sealIndex);
+    BOOST_CHECK(pbftConfig->sealingHeldBack() == false);
+}
+BOOST_AUTO_TEST_CASE(testTimeoutEstimator)
+{
+    auto estimator = std::make_shared<TimeoutEstimator>(3000);
+    estimator->setMinTimeout(100);
+    // the configured timeout for the leader without latency
+    BOOST_CHECK(estimator->estimatedTimeout(0) == 3000);
+    for (size_t i = 0; i < 20; i++)
+    {
+        estimator->updateLatency(0, 100);
+    }
+    auto estimatedTimeout = estimator->estimatedTimeout(0);
+    BOOST_CHECK(estimatedTimeout >= 300 && estimatedTimeout < 3000);
+    // the jitter is drawn once, the timeout only changes with the estimate
+    auto timeout = estimator->timeout(0);
+    BOOST_CHECK(timeout <= estimatedTimeout && timeout >= estimatedTimeout * 0.9 - 1);
+    for (size_t i = 0; i < 20; i++)
+    {
+        BOOST_CHECK(estimator->timeout(0) == timeout);
+    }
+    // bounded by the configured timeout
+    estimator->updateLatency(1, 10000);
+    BOOST_CHECK(estimator->estimatedTimeout(1) == 3000);
+    estimator->setMaxTimeout(200);
+    BOOST_CHECK(estimator->estimatedTimeout(0) == 200);
+    estimator->reset();
+    BOOST_CHECK(estimator->estimatedTimeout(0) == 200);
+}
+
+BOOST_AUTO_TEST_CASE(testConsensusLatency)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto faker = createPBFTFixture(cryptoSuite);
+    faker->appendConsensusNode(faker->nodeID());
+    faker->init();
+    auto pbftConfig = faker->pbftConfig();
+    auto estimator = pbftConfig->timeoutEstimator();
+    estimator->setMaxTimeout(60 * 1000);
+    estimator->setMinTimeout(10);
+    auto leaderIndex = pbftConfig->getLeader();
+
+    // no sample before the first progress
+    pbftConfig->updateConsensusLatency(leaderIndex);
+    BOOST_CHECK(estimator->estimatedTimeout(leaderIndex) == 60 * 1000);
+
+    // the sample covers the sealing of the leader before the PrePrepare
+    uint64_t sealTime = 100;
+    pbftConfig->markConsensusProgress();
+    std::this_thread::sleep_for(std::chrono::milliseconds(sealTime));
+    // the proposal committed right after the PrePrepare received
+    pbftConfig->updateConsensusLatency(leaderIndex);
+    auto estimatedTimeout = estimator->estimatedTimeout(leaderIndex);
+    BOOST_CHECK(estimatedTimeout >= 3 * sealTime);
+    BOOST_CHECK(estimatedTimeout < 60 * 1000);
+
+    // the timer is only reset when the estimate changed
+    pbftConfig->updateConsensusTimeout();
+    auto timeout = pbftConfig->timer()->timeout();
+    BOOST_CHECK(timeout == estimator->timeout(leaderIndex));
+    for (size_t i = 0; i < 10; i++)
+    {
+        pbftConfig->freshTimer();
+        BOOST_CHECK(pbftConfig->timer()->timeout() == timeout);
+    }
 }
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
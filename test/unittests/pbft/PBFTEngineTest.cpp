@@ -264,6 +264,108 @@ BOOST_AUTO_TEST_CASE(testHandlePrePrepareMsg)
         leaderFaker->pbftEngine()->executeWorkerByRoundbin();
     }
 }
+BOOST_AUTO_TEST_CASE(testLocalInjection)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    size_t consensusNodeSize = 4;
+    auto fakerMap = createFakers(cryptoSuite, consensusNodeSize, 10, 0);
+
+    auto index = (fakerMap[0])->pbftConfig()->progressedIndex();
+    auto leaderIndex = (fakerMap[0])->pbftConfig()->leaderIndex(index);
+    auto leaderFaker = fakerMap[leaderIndex];
+    auto config = leaderFaker->pbftConfig();
+    auto engine = leaderFaker->pbftEngine();
+    auto cacheProcessor = std::dynamic_pointer_cast<FakeCacheProcessor>(engine->cacheProcessor());
+    auto& caches = cacheProcessor->caches();
+    auto startT = utcTime();
+    while (config->stateRecovering() && (utcTime() - startT <= 60 * 1000))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    auto block = fakeBlock(cryptoSuite, leaderFaker, index, 10);
+    auto blockData = std::make_shared<bytes>();
+    block->encode(*blockData);
+    auto hash = block->blockHeader()->hash();
+
+    // case1: the executing proposal resubmitted by the sealer is not proposed again
+    cacheProcessor->executingProposalMap()[hash] = index;
+    engine->onRecvProposal(false, ref(*blockData), index, hash);
+    BOOST_CHECK(caches.count(index) == 0);
+    cacheProcessor->executingProposalMap().erase(hash);
+
+    // case2: the prePrepare and the prepare of the leader are injected
+    engine->onRecvProposal(false, ref(*blockData), index, hash);
+    BOOST_CHECK(caches.count(index));
+    auto cache = std::dynamic_pointer_cast<FakePBFTCache>(caches[index]);
+    BOOST_CHECK(cache->localInjections() == 2);
+    BOOST_CHECK(cache->localReplacements() == 0);
+    auto weight = cache->prepareWeight(hash);
+    BOOST_CHECK(weight == config->nodeSnapshot()->weight(leaderIndex));
+
+    // case3: the duplicated proposal is rejected without injected again
+    engine->onRecvProposal(false, ref(*blockData), index, hash);
+    BOOST_CHECK(cache->localInjections() == 2);
+
+    // case4: the regenerated prepare replaces the old one without counted as an injection
+    auto prepareMsg = config->pbftMessageFactory()->populateFrom(PacketType::PreparePacket,
+        config->pbftMsgDefaultVersion(), config->view(), utcTime(), config->nodeIndex(),
+        cache->prePrepare()->consensusProposal(), cryptoSuite, leaderFaker->keyPair());
+    prepareMsg->setIndex(index);
+    cacheProcessor->addLocalPrepareCache(prepareMsg);
+    BOOST_CHECK(cache->localInjections() == 2);
+    BOOST_CHECK(cache->localReplacements() == 1);
+    BOOST_CHECK(cache->prepareWeight(hash) == weight);
+}
+
+BOOST_AUTO_TEST_CASE(testCommittedResponseSizeCap)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto faker = createPBFTFixture(cryptoSuite);
+    faker->appendConsensusNode(faker->nodeID());
+    faker->init();
+    auto config = faker->pbftConfig();
+    config->setMaxCommittedResponseSize(250);
+
+    auto fakeProposals = [&](size_t _size, size_t _dataSize) {
+        PBFTProposalList proposals;
+        for (size_t i = 0; i < _size; i++)
+        {
+            auto proposal = config->pbftMessageFactory()->createPBFTProposal();
+            proposal->setIndex(i + 1);
+            proposal->setHash(hashImpl->hash(std::to_string(i)));
+            proposal->setData(bytes(_dataSize, 'a'));
+            proposals.push_back(proposal);
+        }
+        return proposals;
+    };
+    auto respondedProposals = [&](PBFTProposalList const& _proposals) {
+        PBFTProposalList responded;
+        faker->pbftEngine()->sendCommittedProposalResponse(
+            _proposals, [&](bytesConstRef _respData) {
+                auto response = std::dynamic_pointer_cast<PBFTMessageInterface>(
+                    config->codec()->decode(_respData));
+                BOOST_CHECK(response->packetType() == PacketType::CommittedProposalResponse);
+                responded = response->proposals();
+            });
+        return responded;
+    };
+
+    // the response is truncated to the prefix within the size limit
+    auto responded = respondedProposals(fakeProposals(5, 100));
+    BOOST_CHECK(responded.size() == 2);
+    BOOST_CHECK(responded[0]->index() == 1);
+    BOOST_CHECK(responded[1]->index() == 2);
+    // the proposals within the size limit are responded entirely
+    BOOST_CHECK(respondedProposals(fakeProposals(2, 100)).size() == 2);
+    // the proposal exceeding the size limit is still responded to make progress
+    responded = respondedProposals(fakeProposals(3, 1000));
+    BOOST_CHECK(responded.size() == 1);
+    BOOST_CHECK(responded[0]->data().size() == 1000);
+}
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace bcos
\ No newline at end of file
@@ -72,6 +72,8 @@ public:
     ~FakePBFTConfig() override {}
 
     virtual void setMinRequiredQuorum(uint64_t _quorum) { m_minRequiredQuorum = _quorum; }
+    void setStorage(PBFTStorage::Ptr _storage) { m_storage = _storage; }
+    bcos::protocol::BlockNumber sealEndIndex() const { return m_sealEndIndex; }
 };
 class FakePBFTCache : public PBFTCache
 {
@@ -82,6 +84,14 @@ public:
 
     PBFTMessageInterface::Ptr prePrepare() { return m_prePrepare; }
     void intoPrecommit() override { PBFTCache::intoPrecommit(); }
+    uint64_t prepareWeight(bcos::crypto::HashType const& _hash)
+    {
+        return m_prepareReqWeight.count(_hash) ? m_prepareReqWeight[_hash] : 0;
+    }
+    uint64_t commitWeight(bcos::crypto::HashType const& _hash)
+    {
+        return m_commitReqWeight.count(_hash) ? m_commitReqWeight[_hash] : 0;
+    }
 };
 
 class FakePBFTCacheFactory : public PBFTCacheFactory
@@ -109,8 +119,20 @@ public:
     ~FakeCacheProcessor() override {}
 
     PBFTCachesType& caches() { return m_caches; }
+    std::map<bcos::crypto::HashType, bcos::protocol::BlockNumber>& executingProposalMap()
+    {
+        return m_executingProposals;
+    }
     size_t stableCheckPointQueueSize() const { return m_stableCheckPointQueue.size(); }
     size_t committedQueueSize() const { return m_committedQueue.size(); }
+    ViewChangeCacheType const& viewChangeCache() const { return m_viewChangeCache; }
+    std::map<ViewType, uint64_t> const& viewChangeWeight() const { return m_viewChangeWeight; }
+    std::map<ViewType, int64_t> const& maxCommittedIndex() const { return m_maxCommittedIndex; }
+    std::map<ViewType, int64_t> const& maxPrecommitIndex() const { return m_maxPrecommitIndex; }
+    std::map<bcos::protocol::BlockNumber, int64_t> const& collectorVoteTime() const
+    {
+        return m_collectorVoteTime;
+    }
     bool checkPrecommitWeight(PBFTMessageInterface::Ptr _precommitMsg) override
     {
         PBFTCacheProcessor::checkPrecommitWeight(_precommitMsg);
@@ -127,7 +149,7 @@ public:
     {
         auto cacheFactory = std::make_shared<FakePBFTCacheFactory>();
         m_cacheProcessor = std::make_shared<FakeCacheProcessor>(cacheFactory, _config);
-        m_logSync = std::make_shared<PBFTLogSync>(_config, m_cacheProcessor);
+        m_logSync = std::make_shared<PBFTLogSync>(_config, m_cacheProcessor, m_verifyPool);
         m_cacheProcessor->registerProposalAppliedHandler(
             boost::bind(&FakePBFTEngine::onProposalApplied, this, boost::placeholders::_1,
                 boost::placeholders::_2, boost::placeholders::_3));
@@ -170,6 +192,29 @@ public:
     }
 
     PBFTMsgQueuePtr msgQueue() { return m_msgQueue; }
+
+    PBFTMessageInterface::Ptr collectCheckPointMsg(
+        PBFTMessageInterface::Ptr _checkPointMsg) override
+    {
+        return PBFTEngine::collectCheckPointMsg(_checkPointMsg);
+    }
+    void handleRangeCheckPoints(PBFTMessageInterface::Ptr _checkPointMsg) override
+    {
+        PBFTEngine::handleRangeCheckPoints(_checkPointMsg);
+    }
+    void handlePiggybackedCheckPoints(PBFTMessageInterface::Ptr _pbftMsg, bool _validated) override
+    {
+        PBFTEngine::handlePiggybackedCheckPoints(_pbftMsg, _validated);
+    }
+    void handleBatchMsg(PBFTMessageInterface::Ptr _batchMsg) override
+    {
+        PBFTEngine::handleBatchMsg(_batchMsg);
+    }
+    bool handleCertificateMsg(PBFTMessageInterface::Ptr _certificate) override
+    {
+        return PBFTEngine::handleCertificateMsg(_certificate);
+    }
+    using PBFTEngine::sendCommittedProposalResponse;
 };
 
 class FakePBFTImpl : public PBFTImpl
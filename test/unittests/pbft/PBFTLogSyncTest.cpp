@@ -0,0 +1,529 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief unit tests for PBFTLogSync
+ * @file PBFTLogSyncTest.cpp
+ * @author: yujiechen
+ * @date 2021-06-11
+ */
+#include "test/unittests/pbft/PBFTFixture.h"
+#include <bcos-framework/interfaces/crypto/CryptoSuite.h>
+#include <bcos-framework/testutils/TestPromptFixture.h>
+#include <bcos-framework/testutils/crypto/HashImpl.h>
+#include <bcos-framework/testutils/crypto/SignatureImpl.h>
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+using namespace bcos;
+using namespace bcos::consensus;
+using namespace bcos::crypto;
+using namespace bcos::protocol;
+using namespace bcos::front;
+
+namespace bcos
+{
+namespace test
+{
+// record the proposals loaded into the cache and the indexes erased for re-requesting
+class FakeSyncCacheProcessor : public FakeCacheProcessor
+{
+public:
+    using Ptr = std::shared_ptr<FakeSyncCacheProcessor>;
+    explicit FakeSyncCacheProcessor(PBFTConfig::Ptr _config)
+      : FakeCacheProcessor(std::make_shared<FakePBFTCacheFactory>(), _config)
+    {}
+    ~FakeSyncCacheProcessor() override {}
+
+    void initState(PBFTProposalList const& _committedProposals, NodeIDPtr _fromNode) override
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        for (auto const& proposal : _committedProposals)
+        {
+            m_loaded.push_back(proposal->index());
+            m_sources.push_back(_fromNode);
+        }
+    }
+    void eraseCommittedProposalList(BlockNumber _index) override
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        m_erased.push_back(_index);
+    }
+    // the precommit message with the invalid data is rejected
+    bool checkPrecommitMsg(PBFTMessageInterface::Ptr _precommitMsg) override
+    {
+        return _precommitMsg->consensusProposal()->data().toBytes() != m_invalidPrecommitData;
+    }
+    void setInvalidPrecommitData(bytes const& _data) { m_invalidPrecommitData = _data; }
+
+    std::vector<BlockNumber> loaded()
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        return m_loaded;
+    }
+    std::vector<NodeIDPtr> sources()
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        return m_sources;
+    }
+    std::vector<BlockNumber> erased()
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        return m_erased;
+    }
+    // wait until _size proposals are loaded or erased
+    bool waitFor(size_t _size)
+    {
+        auto startT = utcTime();
+        while (loaded().size() + erased().size() < _size)
+        {
+            if (utcTime() - startT > 10000)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return true;
+    }
+
+private:
+    std::vector<BlockNumber> m_loaded;
+    std::vector<NodeIDPtr> m_sources;
+    std::vector<BlockNumber> m_erased;
+    bytes m_invalidPrecommitData;
+    std::mutex m_mutex;
+};
+
+// respond the request sent to the peer
+using FakeResponder =
+    std::function<void(PublicPtr _peer, PBFTRequestInterface::Ptr _request, CallbackFunc)>;
+
+// the requests are answered by the responder instead of the front service
+class FakePBFTLogSync : public PBFTLogSync
+{
+public:
+    using Ptr = std::shared_ptr<FakePBFTLogSync>;
+    FakePBFTLogSync(PBFTConfig::Ptr _config, PBFTCacheProcessor::Ptr _cache)
+      : PBFTLogSync(_config, _cache, std::make_shared<ThreadPool>("verifier", 2))
+    {}
+    ~FakePBFTLogSync() override {}
+
+    void setResponder(FakeResponder _responder) { m_responder = _responder; }
+    // the peers and the start indexes of the sent requests
+    std::vector<std::pair<bytes, BlockNumber>> requests()
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        return m_requests;
+    }
+    size_t requestCount(PublicPtr _peer)
+    {
+        auto sentRequests = requests();
+        return std::count_if(sentRequests.begin(), sentRequests.end(),
+            [_peer](std::pair<bytes, BlockNumber> const& _request) {
+                return _request.first == _peer->data();
+            });
+    }
+
+protected:
+    void requestPBFTData(
+        PublicPtr _from, PBFTRequestInterface::Ptr _pbftRequest, CallbackFunc _callback) override
+    {
+        {
+            std::lock_guard<std::mutex> l(m_mutex);
+            m_requests.emplace_back(_from->data(), _pbftRequest->index());
+        }
+        m_responder(_from, _pbftRequest, _callback);
+    }
+
+private:
+    FakeResponder m_responder;
+    std::vector<std::pair<bytes, BlockNumber>> m_requests;
+    std::mutex m_mutex;
+};
+
+// the committed proposals in [_start, _start + _offset) signed by all the fakers
+inline std::map<BlockNumber, PBFTProposalInterface::Ptr> fakeCommittedProposals(
+    CryptoSuite::Ptr _cryptoSuite, std::map<IndexType, PBFTFixture::Ptr>& _fakerMap,
+    BlockNumber _start, size_t _offset)
+{
+    std::map<BlockNumber, PBFTProposalInterface::Ptr> proposals;
+    auto messageFactory = _fakerMap[0]->pbftConfig()->pbftMessageFactory();
+    for (auto i = _start; i < _start + (BlockNumber)_offset; i++)
+    {
+        auto proposal = messageFactory->createPBFTProposal();
+        proposal->setIndex(i);
+        proposal->setHash(_cryptoSuite->hashImpl()->hash(std::to_string(i)));
+        for (auto const& it : _fakerMap)
+        {
+            auto signature =
+                _cryptoSuite->signatureImpl()->sign(it.second->keyPair(), proposal->hash());
+            proposal->appendSignatureProof(it.first, ref(*signature));
+        }
+        proposals[i] = proposal;
+    }
+    return proposals;
+}
+
+// the copy of the proposals signed by the first _signers fakers, the signature of _forgedSigner
+// signs another hash
+inline std::map<BlockNumber, PBFTProposalInterface::Ptr> forgeCommittedProposals(
+    CryptoSuite::Ptr _cryptoSuite, std::map<IndexType, PBFTFixture::Ptr>& _fakerMap,
+    std::map<BlockNumber, PBFTProposalInterface::Ptr>& _proposals, size_t _signers,
+    IndexType _forgedSigner)
+{
+    std::map<BlockNumber, PBFTProposalInterface::Ptr> forgedProposals;
+    auto messageFactory = _fakerMap[0]->pbftConfig()->pbftMessageFactory();
+    for (auto const& it : _proposals)
+    {
+        auto proposal = messageFactory->createPBFTProposal();
+        proposal->setIndex(it.second->index());
+        proposal->setHash(it.second->hash());
+        for (auto const& faker : _fakerMap)
+        {
+            if (proposal->signatureProofSize() >= _signers)
+            {
+                break;
+            }
+            auto signedHash = (faker.first == _forgedSigner) ?
+                                  _cryptoSuite->hashImpl()->hash(std::string("forged")) :
+                                  proposal->hash();
+            auto signature =
+                _cryptoSuite->signatureImpl()->sign(faker.second->keyPair(), signedHash);
+            proposal->appendSignatureProof(faker.first, ref(*signature));
+        }
+        forgedProposals[it.first] = proposal;
+    }
+    return forgedProposals;
+}
+
+// respond the proposals of the request with the CommittedProposalResponse
+inline void respondCommittedProposals(PBFTConfig::Ptr _config, PublicPtr _peer,
+    PBFTProposalList const& _proposals, CallbackFunc _callback)
+{
+    auto response = _config->pbftMessageFactory()->createPBFTMsg();
+    response->setPacketType(PacketType::CommittedProposalResponse);
+    response->setProposals(_proposals);
+    auto encodedData = _config->codec()->encode(response);
+    _callback(nullptr, _peer, ref(*encodedData), "", nullptr);
+}
+
+// the proposals requested by _request
+inline PBFTProposalList requestedProposals(
+    std::map<BlockNumber, PBFTProposalInterface::Ptr>& _proposals,
+    PBFTRequestInterface::Ptr _request)
+{
+    PBFTProposalList proposals;
+    for (auto i = _request->index(); i < _request->index() + (BlockNumber)_request->size(); i++)
+    {
+        if (_proposals.count(i))
+        {
+            proposals.push_back(_proposals[i]);
+        }
+    }
+    return proposals;
+}
+
+// respond the precommit message of _proposal filled with _data
+inline void respondPrecommitData(PBFTConfig::Ptr _config, PublicPtr _peer,
+    PBFTProposalInterface::Ptr _proposal, bytes const& _data, CallbackFunc _callback)
+{
+    auto messageFactory = _config->pbftMessageFactory();
+    auto precommitProposal = messageFactory->populateFrom(_proposal, false, true);
+    precommitProposal->setData(_data);
+    auto precommitMsg = messageFactory->populateFrom(PacketType::PreparePacket,
+        precommitProposal, _config->pbftMsgDefaultVersion(), _config->view(), utcTime(), 0);
+    auto response = messageFactory->createViewChangeMsg();
+    response->setPacketType(PacketType::PreparedProposalResponse);
+    response->setPreparedProposals(PBFTMessageList{precommitMsg});
+    auto encodedData = _config->codec()->encode(response);
+    _callback(nullptr, _peer, ref(*encodedData), "", nullptr);
+}
+
+BOOST_FIXTURE_TEST_SUITE(PBFTLogSyncTest, TestPromptFixture)
+
+BOOST_AUTO_TEST_CASE(testChunkRetry)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto fakerMap = createFakers(cryptoSuite, 4, 10, 0);
+    auto config = fakerMap[0]->pbftConfig();
+    auto from = fakerMap[1]->nodeID();
+    auto emptyPeer = fakerMap[2]->nodeID();
+    auto servingPeer = fakerMap[3]->nodeID();
+    auto start = config->committedProposal()->index() + 1;
+    size_t offset = 12;
+    auto committedProposals = fakeCommittedProposals(cryptoSuite, fakerMap, start, offset);
+
+    // the from node fails, the emptyPeer responds nothing, only the servingPeer serves
+    auto cache = std::make_shared<FakeSyncCacheProcessor>(config);
+    auto logSync = std::make_shared<FakePBFTLogSync>(config, cache);
+    logSync->setSyncChunkSize(4);
+    logSync->setResponder([&](PublicPtr _peer, PBFTRequestInterface::Ptr _request,
+                              CallbackFunc _callback) {
+        if (_peer->data() == from->data())
+        {
+            _callback(std::make_shared<Error>(-1, "timeout"), _peer, bytesConstRef(), "", nullptr);
+            return;
+        }
+        if (_peer->data() == emptyPeer->data())
+        {
+            _callback(nullptr, _peer, bytesConstRef(), "", nullptr);
+            return;
+        }
+        respondCommittedProposals(
+            config, _peer, requestedProposals(committedProposals, _request), _callback);
+    });
+    logSync->updatePeerCheckPoint(emptyPeer, start + offset - 1);
+    logSync->updatePeerCheckPoint(servingPeer, start + offset - 1);
+    logSync->requestCommittedProposals(from, start, offset);
+    BOOST_CHECK(cache->waitFor(offset));
+
+    // every chunk is retried on the other peers until served, and loaded in order
+    auto loaded = cache->loaded();
+    BOOST_CHECK(loaded.size() == offset);
+    for (size_t i = 0; i < loaded.size(); i++)
+    {
+        BOOST_CHECK(loaded[i] == start + (BlockNumber)i);
+        BOOST_CHECK(cache->sources()[i]->data() == servingPeer->data());
+    }
+    BOOST_CHECK(cache->erased().empty());
+    // the chunks are spread over the peers, every peer is tried once per chunk at most
+    BOOST_CHECK(logSync->requestCount(servingPeer) == 3);
+    BOOST_CHECK(logSync->requestCount(from) <= 3);
+    BOOST_CHECK(logSync->requests().size() <= 9);
+
+    // case2: only the peers advertised the checkpoint covering the chunk are requested
+    cache = std::make_shared<FakeSyncCacheProcessor>(config);
+    logSync = std::make_shared<FakePBFTLogSync>(config, cache);
+    logSync->setSyncChunkSize(4);
+    logSync->setResponder([&](PublicPtr _peer, PBFTRequestInterface::Ptr _request,
+                              CallbackFunc _callback) {
+        if (_peer->data() == from->data())
+        {
+            _callback(std::make_shared<Error>(-1, "timeout"), _peer, bytesConstRef(), "", nullptr);
+            return;
+        }
+        respondCommittedProposals(
+            config, _peer, requestedProposals(committedProposals, _request), _callback);
+    });
+    // the servingPeer only covers the first chunk
+    logSync->updatePeerCheckPoint(servingPeer, start + 3);
+    logSync->requestCommittedProposals(from, start, offset);
+    BOOST_CHECK(cache->waitFor(offset));
+    BOOST_CHECK(
+        cache->loaded() == std::vector<BlockNumber>({start, start + 1, start + 2, start + 3}));
+    BOOST_CHECK(logSync->requestCount(servingPeer) == 1);
+    // the chunks no peer can serve are erased to be requested again
+    auto erased = cache->erased();
+    std::sort(erased.begin(), erased.end());
+    BOOST_CHECK(erased.size() == offset - 4);
+    for (size_t i = 0; i < erased.size(); i++)
+    {
+        BOOST_CHECK(erased[i] == start + 4 + (BlockNumber)i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testHedgeWinner)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto fakerMap = createFakers(cryptoSuite, 4, 10, 0);
+    auto config = fakerMap[0]->pbftConfig();
+    auto from = fakerMap[1]->nodeID();
+    auto invalidSigner = fakerMap[2]->nodeID();
+    auto validSigner = fakerMap[3]->nodeID();
+    auto index = config->committedProposal()->index() + 1;
+    auto proposal = fakeCommittedProposals(cryptoSuite, fakerMap, index, 1)[index];
+    auto prePrepareMsg = config->pbftMessageFactory()->populateFrom(PacketType::PrePreparePacket,
+        config->pbftMessageFactory()->populateFrom(proposal, false, true),
+        config->pbftMsgDefaultVersion(), config->view(), utcTime(), 1);
+
+    bytes fromData = asBytes("fromData");
+    bytes invalidData = asBytes("invalidData");
+    bytes validData = asBytes("validData");
+    auto cache = std::make_shared<FakeSyncCacheProcessor>(config);
+    cache->setInvalidPrecommitData(invalidData);
+    auto logSync = std::make_shared<FakePBFTLogSync>(config, cache);
+    // the from node responds after the others
+    CallbackFunc fromCallback;
+    logSync->setResponder([&](PublicPtr _peer, PBFTRequestInterface::Ptr,
+                              CallbackFunc _callback) {
+        if (_peer->data() == from->data())
+        {
+            fromCallback = _callback;
+            return;
+        }
+        auto data = (_peer->data() == invalidSigner->data()) ? invalidData : validData;
+        respondPrecommitData(config, _peer, proposal, data, _callback);
+    });
+    std::atomic<size_t> callbackTimes = {0};
+    auto filled = std::make_shared<std::promise<PBFTMessageList>>();
+    auto future = filled->get_future();
+    auto startT = utcTime();
+    BOOST_CHECK(logSync->hedgeDelay() > 0);
+    auto hedgeDelay = logSync->hedgeDelay();
+    logSync->requestPrecommitData(
+        from, PBFTMessageList{prePrepareMsg}, [&](PBFTMessageList const& _prePrepareMsgs) {
+            if (callbackTimes++ == 0)
+            {
+                filled->set_value(_prePrepareMsgs);
+            }
+        });
+    BOOST_CHECK(future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    // hedged to the other signers after the hedge delay, the invalid response is skipped and the
+    // first valid response wins
+    BOOST_CHECK(utcTime() - startT >= hedgeDelay);
+    auto prePrepareMsgs = future.get();
+    BOOST_CHECK(prePrepareMsgs.size() == 1);
+    BOOST_CHECK(prePrepareMsgs[0]->consensusProposal()->data().toBytes() == validData);
+    BOOST_CHECK(logSync->requestCount(from) == 1);
+    BOOST_CHECK(logSync->requestCount(invalidSigner) == 1);
+    BOOST_CHECK(logSync->requestCount(validSigner) == 1);
+
+    // the late response of the from node is ignored
+    BOOST_CHECK(fromCallback != nullptr);
+    respondPrecommitData(config, from, proposal, fromData, fromCallback);
+    BOOST_CHECK(callbackTimes == 1);
+    BOOST_CHECK(prePrepareMsg->consensusProposal()->data().toBytes() == validData);
+    // the round-trip time of the winner is sampled for the next hedge delay
+    BOOST_CHECK(logSync->hedgeDelay() < hedgeDelay);
+}
+
+BOOST_AUTO_TEST_CASE(testRejectInvalidChunk)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto fakerMap = createFakers(cryptoSuite, 4, 10, 0);
+    auto config = fakerMap[0]->pbftConfig();
+    auto from = fakerMap[1]->nodeID();
+    auto gapPeer = fakerMap[2]->nodeID();
+    auto lastPeer = fakerMap[3]->nodeID();
+    auto start = config->committedProposal()->index() + 1;
+    size_t offset = 4;
+    auto committedProposals = fakeCommittedProposals(cryptoSuite, fakerMap, start, offset);
+    // the signature list with a forged signature
+    auto forgedProposals = forgeCommittedProposals(
+        cryptoSuite, fakerMap, committedProposals, fakerMap.size(), 1);
+    // the signature list without enough quorum
+    auto minorityProposals = forgeCommittedProposals(
+        cryptoSuite, fakerMap, committedProposals, config->minRequiredQuorum() - 1, -1);
+    auto gapResponder = [&](PublicPtr _peer, PBFTRequestInterface::Ptr _request,
+                            CallbackFunc _callback) {
+        auto proposals = requestedProposals(committedProposals, _request);
+        proposals.erase(proposals.begin() + 1);
+        respondCommittedProposals(config, _peer, proposals, _callback);
+    };
+
+    // case1: the chunk with the forged signature list or the gap is requested from another peer
+    auto cache = std::make_shared<FakeSyncCacheProcessor>(config);
+    auto logSync = std::make_shared<FakePBFTLogSync>(config, cache);
+    logSync->setSyncChunkSize(offset);
+    logSync->setResponder([&](PublicPtr _peer, PBFTRequestInterface::Ptr _request,
+                              CallbackFunc _callback) {
+        if (_peer->data() == from->data())
+        {
+            respondCommittedProposals(
+                config, _peer, requestedProposals(forgedProposals, _request), _callback);
+            return;
+        }
+        if (_peer->data() == gapPeer->data())
+        {
+            gapResponder(_peer, _request, _callback);
+            return;
+        }
+        respondCommittedProposals(
+            config, _peer, requestedProposals(committedProposals, _request), _callback);
+    });
+    logSync->updatePeerCheckPoint(gapPeer, start + offset - 1);
+    logSync->updatePeerCheckPoint(lastPeer, start + offset - 1);
+    logSync->requestCommittedProposals(from, start, offset);
+    BOOST_CHECK(cache->waitFor(offset));
+    BOOST_CHECK(cache->loaded().size() == offset);
+    for (auto const& source : cache->sources())
+    {
+        BOOST_CHECK(source->data() == lastPeer->data());
+    }
+    BOOST_CHECK(cache->erased().empty());
+    BOOST_CHECK(logSync->requests().size() == 3);
+
+    // case2: no invalid chunk is loaded even if all the peers respond invalid chunks
+    cache = std::make_shared<FakeSyncCacheProcessor>(config);
+    logSync = std::make_shared<FakePBFTLogSync>(config, cache);
+    logSync->setSyncChunkSize(offset);
+    logSync->setResponder([&](PublicPtr _peer, PBFTRequestInterface::Ptr _request,
+                              CallbackFunc _callback) {
+        if (_peer->data() == gapPeer->data())
+        {
+            gapResponder(_peer, _request, _callback);
+            return;
+        }
+        auto& proposals = (_peer->data() == from->data()) ? minorityProposals : forgedProposals;
+        respondCommittedProposals(
+            config, _peer, requestedProposals(proposals, _request), _callback);
+    });
+    logSync->updatePeerCheckPoint(gapPeer, start + offset - 1);
+    logSync->updatePeerCheckPoint(lastPeer, start + offset - 1);
+    logSync->requestCommittedProposals(from, start, offset);
+    BOOST_CHECK(cache->waitFor(offset));
+    BOOST_CHECK(cache->loaded().empty());
+    BOOST_CHECK(cache->erased().size() == offset);
+    BOOST_CHECK(logSync->requests().size() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(testTruncatedResponse)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto fakerMap = createFakers(cryptoSuite, 4, 10, 0);
+    auto config = fakerMap[0]->pbftConfig();
+    auto from = fakerMap[1]->nodeID();
+    auto start = config->committedProposal()->index() + 1;
+    size_t offset = 8;
+    auto committedProposals = fakeCommittedProposals(cryptoSuite, fakerMap, start, offset);
+
+    // the responses are truncated to two proposals for the response size limit
+    auto cache = std::make_shared<FakeSyncCacheProcessor>(config);
+    auto logSync = std::make_shared<FakePBFTLogSync>(config, cache);
+    logSync->setSyncChunkSize(offset);
+    logSync->setResponder([&](PublicPtr _peer, PBFTRequestInterface::Ptr _request,
+                              CallbackFunc _callback) {
+        auto proposals = requestedProposals(committedProposals, _request);
+        proposals.resize(std::min(proposals.size(), (size_t)2));
+        respondCommittedProposals(config, _peer, proposals, _callback);
+    });
+    logSync->requestCommittedProposals(from, start, offset);
+    BOOST_CHECK(cache->waitFor(offset));
+
+    // the remaining proposals are requested incrementally, and loaded once in order
+    auto loaded = cache->loaded();
+    BOOST_CHECK(loaded.size() == offset);
+    for (size_t i = 0; i < loaded.size(); i++)
+    {
+        BOOST_CHECK(loaded[i] == start + (BlockNumber)i);
+    }
+    BOOST_CHECK(cache->erased().empty());
+    auto requests = logSync->requests();
+    BOOST_CHECK(requests.size() == offset / 2);
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        BOOST_CHECK(requests[i].second == start + (BlockNumber)(2 * i));
+    }
+}
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
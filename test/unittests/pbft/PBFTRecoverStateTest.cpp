@@ -0,0 +1,170 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief unit tests for recovering the PBFT state from the storage
+ * @file PBFTRecoverStateTest.cpp
+ * @author: yujiechen
+ * @date 2021-06-11
+ */
+#include "test/unittests/pbft/PBFTFixture.h"
+#include <bcos-framework/interfaces/crypto/CryptoSuite.h>
+#include <bcos-framework/testutils/TestPromptFixture.h>
+#include <bcos-framework/testutils/crypto/HashImpl.h>
+#include <bcos-framework/testutils/crypto/SignatureImpl.h>
+#include <boost/test/unit_test.hpp>
+#include <future>
+
+using namespace bcos;
+using namespace bcos::consensus;
+using namespace bcos::crypto;
+using namespace bcos::protocol;
+
+namespace bcos
+{
+namespace test
+{
+// the storage fails the first _failedLoads loads, and never responds when _hang is true
+class FakeLoadStateStorage : public LedgerStorage
+{
+public:
+    using Ptr = std::shared_ptr<FakeLoadStateStorage>;
+    FakeLoadStateStorage(PBFTFixture::Ptr _faker, size_t _failedLoads, bool _hang = false)
+      : LedgerStorage(_faker->scheduler(), _faker->storage(), _faker->blockFactory(),
+            _faker->pbftConfig()->pbftMessageFactory()),
+        m_failedLoads(_failedLoads),
+        m_hang(_hang)
+    {}
+    ~FakeLoadStateStorage() override {}
+
+    void asyncLoadState(BlockNumber, std::function<void(Error::Ptr, PBFTProposalListPtr)> _onLoaded)
+        override
+    {
+        m_loadTimes++;
+        if (m_hang)
+        {
+            return;
+        }
+        if (m_loadTimes <= m_failedLoads)
+        {
+            _onLoaded(std::make_shared<Error>(-1, "load state failed"), nullptr);
+            return;
+        }
+        _onLoaded(nullptr, nullptr);
+    }
+    size_t loadTimes() const { return m_loadTimes; }
+
+private:
+    size_t m_failedLoads;
+    bool m_hang;
+    std::atomic<size_t> m_loadTimes = {0};
+};
+
+// recover the state of a new node with _storage, return the error and the timecost
+inline std::pair<Error::Ptr, uint64_t> recoverState(
+    PBFTFixture::Ptr _faker, FakeLoadStateStorage::Ptr _storage)
+{
+    std::dynamic_pointer_cast<FakePBFTConfig>(_faker->pbftConfig())->setStorage(_storage);
+    auto result = std::make_shared<std::promise<Error::Ptr>>();
+    auto future = result->get_future();
+    auto startT = utcTime();
+    _faker->pbftEngine()->asyncRecoverState(_faker->ledger()->blockNumber(),
+        [result](Error::Ptr _error) { result->set_value(_error); });
+    BOOST_CHECK(_faker->pbftConfig()->stateRecovering());
+    BOOST_CHECK(future.wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+    return std::make_pair(future.get(), utcTime() - startT);
+}
+
+BOOST_FIXTURE_TEST_SUITE(PBFTRecoverStateTest, TestPromptFixture)
+
+BOOST_AUTO_TEST_CASE(testRecoverStateRetry)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+
+    // case1: recovered after the failed loads retried with backoff
+    auto faker = createPBFTFixture(cryptoSuite);
+    faker->appendConsensusNode(faker->nodeID());
+    faker->pbftEngine()->setRecoverStateRetryInterval(20);
+    auto storage = std::make_shared<FakeLoadStateStorage>(faker, 2);
+    auto ret = recoverState(faker, storage);
+    BOOST_CHECK(ret.first == nullptr);
+    BOOST_CHECK(storage->loadTimes() == 3);
+    // backoff 20ms and 40ms
+    BOOST_CHECK(ret.second >= 60);
+    BOOST_CHECK(!faker->pbftConfig()->stateRecovering());
+    BOOST_CHECK(!faker->pbftConfig()->stateRecoverFailed());
+    BOOST_CHECK(!faker->pbftEngine()->stopped());
+
+    // case2: the engine is stopped when the retries exhausted
+    faker = createPBFTFixture(cryptoSuite);
+    faker->appendConsensusNode(faker->nodeID());
+    faker->pbftEngine()->setRecoverStateRetryInterval(10);
+    storage = std::make_shared<FakeLoadStateStorage>(faker, SIZE_MAX);
+    ret = recoverState(faker, storage);
+    BOOST_CHECK(ret.first != nullptr);
+    BOOST_CHECK(storage->loadTimes() > 1);
+    BOOST_CHECK(faker->pbftEngine()->stopped());
+    // the failure is visible in the consensus status
+    BOOST_CHECK(faker->pbftConfig()->stateRecoverFailed());
+    std::string consensusStatus;
+    faker->pbft()->asyncGetConsensusStatus(
+        [&consensusStatus](Error::Ptr, std::string _status) { consensusStatus = _status; });
+    BOOST_CHECK(consensusStatus.find("\"stateRecovery\":\"failed\"") != std::string::npos);
+    // no more retry after stopped
+    auto loadTimes = storage->loadTimes();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    BOOST_CHECK(storage->loadTimes() == loadTimes);
+
+    // case3: the engine is stopped when the storage never responds
+    faker = createPBFTFixture(cryptoSuite);
+    faker->appendConsensusNode(faker->nodeID());
+    faker->pbftEngine()->setRecoverStateTimeout(200);
+    storage = std::make_shared<FakeLoadStateStorage>(faker, 0, true);
+    ret = recoverState(faker, storage);
+    BOOST_CHECK(ret.first != nullptr);
+    BOOST_CHECK(ret.first->errorCode() == PBFTErrorCode::RecoverStateTimeout);
+    BOOST_CHECK(ret.second >= 200);
+    BOOST_CHECK(storage->loadTimes() == 1);
+    BOOST_CHECK(faker->pbftEngine()->stopped());
+}
+
+BOOST_AUTO_TEST_CASE(testLoadStateCallback)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto faker = createPBFTFixture(cryptoSuite);
+
+    // the undecodable committed proposals are reported as the error instead of dropped
+    auto storage = std::make_shared<LedgerStorage>(faker->scheduler(), faker->storage(),
+        faker->blockFactory(), faker->pbftConfig()->pbftMessageFactory());
+    storage->loadState(0);
+    auto stabledIndex = faker->ledger()->blockNumber();
+    faker->storage()->asyncPut("pbftCommitDB", "max_committed_proposal",
+        std::to_string(stabledIndex + 1), [](Error::UniquePtr&&) {});
+    // the field with the invalid wire type
+    faker->storage()->asyncPut("pbftCommitDB", LedgerStorage::proposalKey(stabledIndex + 1),
+        std::string("\x0f", 1), [](Error::UniquePtr&&) {});
+    auto result = std::make_shared<std::promise<Error::Ptr>>();
+    auto future = result->get_future();
+    storage->asyncLoadState(stabledIndex,
+        [result](Error::Ptr _error, PBFTProposalListPtr) { result->set_value(_error); });
+    BOOST_CHECK(future.wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+    BOOST_CHECK(future.get() != nullptr);
+}
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
@@ -43,6 +43,39 @@ bool shouldExit(std::map<IndexType, PBFTFixture::Ptr>& _fakers, BlockNumber _num
     }
     return true;
 }
+// the viewChange generated by the given node, with the given committed and precommit indexes
+ViewChangeMsgInterface::Ptr fakeViewChange(PBFTFixture::Ptr _faker, ViewType _view,
+    BlockNumber _committedIndex, std::vector<BlockNumber> const& _precommitIndexes)
+{
+    auto config = _faker->pbftConfig();
+    auto messageFactory = config->pbftMessageFactory();
+    auto hashImpl = config->cryptoSuite()->hashImpl();
+    auto committedProposal = messageFactory->createPBFTProposal();
+    committedProposal->setIndex(_committedIndex);
+    committedProposal->setHash(hashImpl->hash(std::to_string(_committedIndex)));
+
+    auto viewChange = messageFactory->createViewChangeMsg();
+    viewChange->setHash(committedProposal->hash());
+    viewChange->setIndex(committedProposal->index());
+    viewChange->setPacketType(PacketType::ViewChangePacket);
+    viewChange->setVersion(config->pbftMsgDefaultVersion());
+    viewChange->setView(_view);
+    viewChange->setTimestamp(utcTime());
+    viewChange->setGeneratedFrom(config->nodeIndex());
+    viewChange->setCommittedProposal(committedProposal);
+    PBFTMessageList precommitList;
+    for (auto index : _precommitIndexes)
+    {
+        auto proposal = messageFactory->createPBFTProposal();
+        proposal->setIndex(index);
+        proposal->setHash(hashImpl->hash(std::to_string(index)));
+        precommitList.push_back(messageFactory->populateFrom(PacketType::PreparePacket, proposal,
+            config->pbftMsgDefaultVersion(), _view, utcTime(), config->nodeIndex()));
+    }
+    viewChange->setPreparedProposals(precommitList);
+    return viewChange;
+}
+
 BOOST_AUTO_TEST_CASE(testViewChangeWithPrecommitProposals)
 {
     auto hashImpl = std::make_shared<Keccak256Hash>();
@@ -150,6 +183,113 @@ BOOST_AUTO_TEST_CASE(testViewChangeWithPrecommitProposals)
         BOOST_CHECK(faker->ledger()->blockNumber() == futureBlockIndex);
     }
 }
+BOOST_AUTO_TEST_CASE(testReplaceViewChange)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto fakerMap = createFakers(cryptoSuite, 4, 9, 4);
+    auto cacheProcessor =
+        std::dynamic_pointer_cast<FakeCacheProcessor>(fakerMap[0]->pbftEngine()->cacheProcessor());
+
+    // the max indexes of view 2 come from the viewChange of node 1
+    cacheProcessor->addViewChangeReq(fakeViewChange(fakerMap[1], 2, 12, {13}));
+    cacheProcessor->addViewChangeReq(fakeViewChange(fakerMap[2], 2, 11, {12}));
+    BOOST_CHECK(cacheProcessor->viewChangeCacheCount() == 2);
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().at(2) == 2);
+    BOOST_CHECK(cacheProcessor->maxCommittedIndex().at(2) == 12);
+    BOOST_CHECK(cacheProcessor->maxPrecommitIndex().at(2) == 13);
+    auto cacheSize = cacheProcessor->viewChangeCacheSize();
+    BOOST_CHECK(cacheSize > 0);
+
+    // the viewChange of the higher view replaces the older one of node 1
+    cacheProcessor->addViewChangeReq(fakeViewChange(fakerMap[1], 3, 10, {11}));
+    BOOST_CHECK(cacheProcessor->viewChangeCacheCount() == 2);
+    BOOST_CHECK(cacheProcessor->viewChangeCache().at(2).size() == 1);
+    BOOST_CHECK(cacheProcessor->viewChangeCache().at(2).count(2));
+    BOOST_CHECK(cacheProcessor->viewChangeCache().at(3).count(1));
+    // the weight and the max indexes of view 2 are recomputed without node 1
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().at(2) == 1);
+    BOOST_CHECK(cacheProcessor->maxCommittedIndex().at(2) == 11);
+    BOOST_CHECK(cacheProcessor->maxPrecommitIndex().at(2) == 12);
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().at(3) == 1);
+    BOOST_CHECK(cacheProcessor->maxCommittedIndex().at(3) == 10);
+    BOOST_CHECK(cacheProcessor->maxPrecommitIndex().at(3) == 11);
+    BOOST_CHECK(cacheProcessor->viewChangeCacheSize() == cacheSize);
+
+    // the stale and the duplicated viewChange are ignored
+    cacheProcessor->addViewChangeReq(fakeViewChange(fakerMap[1], 2, 14, {15}));
+    cacheProcessor->addViewChangeReq(fakeViewChange(fakerMap[1], 3, 14, {15}));
+    BOOST_CHECK(cacheProcessor->viewChangeCacheCount() == 2);
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().at(2) == 1);
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().at(3) == 1);
+    BOOST_CHECK(cacheProcessor->maxCommittedIndex().at(3) == 10);
+    BOOST_CHECK(cacheProcessor->maxPrecommitIndex().at(3) == 11);
+
+    // the view is dropped once its last viewChange is replaced
+    cacheProcessor->addViewChangeReq(fakeViewChange(fakerMap[2], 3, 11, {}));
+    BOOST_CHECK(cacheProcessor->viewChangeCacheCount() == 2);
+    BOOST_CHECK(cacheProcessor->viewChangeCache().count(2) == 0);
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().count(2) == 0);
+    BOOST_CHECK(cacheProcessor->maxCommittedIndex().count(2) == 0);
+    BOOST_CHECK(cacheProcessor->maxPrecommitIndex().count(2) == 0);
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().at(3) == 2);
+    BOOST_CHECK(cacheProcessor->maxCommittedIndex().at(3) == 11);
+    BOOST_CHECK(cacheProcessor->maxPrecommitIndex().at(3) == 11);
+    BOOST_CHECK(cacheProcessor->viewChangeCacheSize() < cacheSize);
+}
+
+BOOST_AUTO_TEST_CASE(testViewChangeWeight)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto fakerMap = createFakers(cryptoSuite, 4, 9, 4);
+    auto config = fakerMap[0]->pbftConfig();
+    auto cacheProcessor =
+        std::dynamic_pointer_cast<FakeCacheProcessor>(fakerMap[0]->pbftEngine()->cacheProcessor());
+    // f + 1 = 2 for four nodes of weight 1
+    BOOST_CHECK(config->maxFaultyQuorum() == 1);
+    auto toView = config->toView();
+
+    // the weight of the views above toView is less than f + 1
+    cacheProcessor->addViewChangeReq(fakeViewChange(fakerMap[1], toView + 2, 12, {}));
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().at(toView + 2) == 1);
+    BOOST_CHECK(cacheProcessor->tryToTriggerFastViewChange() == 0);
+    BOOST_CHECK(config->toView() == toView);
+
+    // reach f + 1 with the views above toView, the smallest one is the view to reach
+    cacheProcessor->addViewChangeReq(fakeViewChange(fakerMap[2], toView + 3, 12, {}));
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().at(toView + 3) == 1);
+    BOOST_CHECK(cacheProcessor->tryToTriggerFastViewChange() == toView + 2);
+    BOOST_CHECK(config->toView() == toView + 1);
+
+    cacheProcessor->addViewChangeReq(fakeViewChange(fakerMap[3], toView + 3, 10, {}));
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().at(toView + 3) == 2);
+    BOOST_CHECK(cacheProcessor->viewChangeCacheCount() == 3);
+
+    // evict the viewChange of the reached views and the stale committed index
+    cacheProcessor->removeInvalidViewChange(toView + 2, 11);
+    BOOST_CHECK(cacheProcessor->viewChangeCacheCount() == 1);
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().count(toView + 2) == 0);
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().at(toView + 3) == 1);
+    BOOST_CHECK(cacheProcessor->viewChangeCache().at(toView + 3).count(2));
+
+    // the evicted nodes are accepted again, and the replaced ones are deducted
+    cacheProcessor->addViewChangeReq(fakeViewChange(fakerMap[1], toView + 3, 12, {}));
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().at(toView + 3) == 2);
+    cacheProcessor->addViewChangeReq(fakeViewChange(fakerMap[1], toView + 4, 12, {}));
+    cacheProcessor->addViewChangeReq(fakeViewChange(fakerMap[2], toView + 4, 12, {}));
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().count(toView + 3) == 0);
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().at(toView + 4) == 2);
+    BOOST_CHECK(cacheProcessor->viewChangeCacheCount() == 2);
+
+    // the weights and the sizes are all deducted once the cache is emptied
+    cacheProcessor->removeInvalidViewChange(toView + 4, 11);
+    BOOST_CHECK(cacheProcessor->viewChangeWeight().empty());
+    BOOST_CHECK(cacheProcessor->viewChangeCacheCount() == 0);
+    BOOST_CHECK(cacheProcessor->viewChangeCacheSize() == 0);
+}
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace bcos
\ No newline at end of file
@@ -0,0 +1,203 @@
+/**
+ *  Copyright (C) 2021 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief unit tests for the signature proof verifier
+ * @file SignatureProofVerifierTest.cpp
+ * @author: yujiechen
+ * @date 2021-06-11
+ */
+#include "bcos-pbft/pbft/engine/SignatureProofVerifier.h"
+#include "test/unittests/pbft/PBFTFixture.h"
+#include <bcos-framework/interfaces/consensus/ConsensusNode.h>
+#include <bcos-framework/interfaces/crypto/CryptoSuite.h>
+#include <bcos-framework/testutils/TestPromptFixture.h>
+#include <bcos-framework/testutils/crypto/HashImpl.h>
+#include <bcos-framework/testutils/crypto/SignatureImpl.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace bcos;
+using namespace bcos::consensus;
+using namespace bcos::crypto;
+using namespace bcos::protocol;
+
+namespace bcos
+{
+namespace test
+{
+class CountingParsedPublicKey : public DefaultParsedPublicKey
+{
+public:
+    CountingParsedPublicKey(SignatureCrypto::Ptr _signatureImpl, PublicPtr _nodeID,
+        std::shared_ptr<std::atomic<size_t>> _verifiedCount)
+      : DefaultParsedPublicKey(_signatureImpl, _nodeID), m_verifiedCount(_verifiedCount)
+    {}
+    bool verify(HashType const& _hash, bytesConstRef _signature) const override
+    {
+        (*m_verifiedCount)++;
+        return DefaultParsedPublicKey::verify(_hash, _signature);
+    }
+
+private:
+    std::shared_ptr<std::atomic<size_t>> m_verifiedCount;
+};
+
+class CountingParsedPublicKeyFactory : public ParsedPublicKeyFactory
+{
+public:
+    explicit CountingParsedPublicKeyFactory(SignatureCrypto::Ptr _signatureImpl)
+      : m_signatureImpl(_signatureImpl), m_verifiedCount(std::make_shared<std::atomic<size_t>>(0))
+    {}
+    ParsedPublicKeyInterface::Ptr createParsedPublicKey(PublicPtr _nodeID) override
+    {
+        return std::make_shared<CountingParsedPublicKey>(m_signatureImpl, _nodeID, m_verifiedCount);
+    }
+    size_t verifiedCount() const { return *m_verifiedCount; }
+
+private:
+    SignatureCrypto::Ptr m_signatureImpl;
+    std::shared_ptr<std::atomic<size_t>> m_verifiedCount;
+};
+
+BOOST_FIXTURE_TEST_SUITE(SignatureProofVerifierTest, TestPromptFixture)
+
+BOOST_AUTO_TEST_CASE(testSignatureProofVerifier)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto publicKeyCache = std::make_shared<PublicKeyCache>(
+        std::make_shared<DefaultParsedPublicKeyFactory>(signatureImpl));
+    auto verifier = std::make_shared<SignatureProofVerifier>(publicKeyCache);
+
+    ConsensusNodeList consensusNodes;
+    std::vector<KeyPairInterface::Ptr> keyPairs;
+    for (uint64_t i = 0; i < 4; i++)
+    {
+        auto keyPair = signatureImpl->generateKeyPair();
+        keyPairs.push_back(keyPair);
+        consensusNodes.push_back(std::make_shared<ConsensusNode>(keyPair->publicKey(), i + 1));
+    }
+    auto hash = hashImpl->hash(std::string("signatureProofVerifier"));
+    std::vector<bytesPointer> signatures;
+    for (auto const& keyPair : keyPairs)
+    {
+        signatures.push_back(signatureImpl->sign(keyPair, hash));
+    }
+    SignatureProofList proofs;
+    for (size_t i = 0; i < 3; i++)
+    {
+        proofs.push_back(std::make_pair((int64_t)i, ref(*signatures[i])));
+    }
+    // the weight of the signers
+    BOOST_CHECK(verifier->verifyProofs(hash, proofs, consensusNodes) == 6);
+
+    // the duplicated signer
+    auto duplicatedProofs = proofs;
+    duplicatedProofs.push_back(proofs[0]);
+    BOOST_CHECK(verifier->verifyProofs(hash, duplicatedProofs, consensusNodes) == 0);
+    // the out-of-range signers
+    auto outOfRangeProofs = proofs;
+    outOfRangeProofs.push_back(std::make_pair((int64_t)consensusNodes.size(), ref(*signatures[3])));
+    BOOST_CHECK(verifier->verifyProofs(hash, outOfRangeProofs, consensusNodes) == 0);
+    auto negativeProofs = proofs;
+    negativeProofs.push_back(std::make_pair((int64_t)-1, ref(*signatures[3])));
+    BOOST_CHECK(verifier->verifyProofs(hash, negativeProofs, consensusNodes) == 0);
+    // the signature of another signer
+    auto invalidProofs = proofs;
+    invalidProofs.push_back(std::make_pair((int64_t)3, ref(*signatures[0])));
+    BOOST_CHECK(verifier->verifyProofs(hash, invalidProofs, consensusNodes) == 0);
+
+    // the batched verification rejects the same cases
+    auto verifyPool = std::make_shared<ThreadPool>("verifier", 2);
+    std::vector<uint64_t> weights;
+    CertificateList certificates{std::make_pair(hash, proofs), std::make_pair(hash, proofs)};
+    BOOST_CHECK(verifier->batchVerifyProofs(certificates, consensusNodes, verifyPool, weights));
+    BOOST_CHECK(weights == std::vector<uint64_t>({6, 6}));
+    for (auto const& invalidCase : {duplicatedProofs, outOfRangeProofs, negativeProofs})
+    {
+        certificates = CertificateList{
+            std::make_pair(hash, proofs), std::make_pair(hash, invalidCase)};
+        BOOST_CHECK(!verifier->batchVerifyProofs(
+            certificates, consensusNodes, verifyPool, weights));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testBatchVerifyFailFast)
+{
+    auto hashImpl = std::make_shared<Keccak256Hash>();
+    auto signatureImpl = std::make_shared<Secp256k1SignatureImpl>();
+    auto keyFactory = std::make_shared<CountingParsedPublicKeyFactory>(signatureImpl);
+    auto verifier =
+        std::make_shared<SignatureProofVerifier>(std::make_shared<PublicKeyCache>(keyFactory));
+
+    ConsensusNodeList consensusNodes;
+    std::vector<KeyPairInterface::Ptr> keyPairs;
+    for (uint64_t i = 0; i < 4; i++)
+    {
+        auto keyPair = signatureImpl->generateKeyPair();
+        keyPairs.push_back(keyPair);
+        consensusNodes.push_back(std::make_shared<ConsensusNode>(keyPair->publicKey(), i + 1));
+    }
+    // 4 blocks signed by all the nodes: 16 signatures verified in 2 chunks
+    std::vector<HashType> hashes;
+    std::vector<std::vector<bytesPointer>> signatures;
+    for (size_t i = 0; i < 4; i++)
+    {
+        hashes.push_back(hashImpl->hash(std::to_string(i)));
+        signatures.push_back(std::vector<bytesPointer>());
+        for (auto const& keyPair : keyPairs)
+        {
+            signatures[i].push_back(signatureImpl->sign(keyPair, hashes[i]));
+        }
+    }
+    auto fakeCertificates = [&](bool _invalidFirst) {
+        CertificateList certificates;
+        for (size_t i = 0; i < hashes.size(); i++)
+        {
+            SignatureProofList proofs;
+            for (size_t j = 0; j < keyPairs.size(); j++)
+            {
+                // the first signature signs another hash
+                auto const& signature = (_invalidFirst && i == 0 && j == 0) ?
+                                            signatures[1][0] :
+                                            signatures[i][j];
+                proofs.push_back(std::make_pair((int64_t)j, ref(*signature)));
+            }
+            certificates.push_back(std::make_pair(hashes[i], proofs));
+        }
+        return certificates;
+    };
+
+    // the weights of all the certificates
+    std::vector<uint64_t> weights;
+    BOOST_CHECK(verifier->batchVerifyProofs(fakeCertificates(false), consensusNodes,
+        std::make_shared<ThreadPool>("verifier", 2), weights));
+    BOOST_CHECK(weights == std::vector<uint64_t>({10, 10, 10, 10}));
+    BOOST_CHECK(keyFactory->verifiedCount() == 16);
+
+    // fail fast: no more signature verified after the invalid one
+    auto verifiedCount = keyFactory->verifiedCount();
+    BOOST_CHECK(!verifier->batchVerifyProofs(
+        fakeCertificates(true), consensusNodes, nullptr, weights));
+    BOOST_CHECK(keyFactory->verifiedCount() == verifiedCount + 1);
+    // the chunks verified concurrently stop at the invalid signature
+    verifiedCount = keyFactory->verifiedCount();
+    BOOST_CHECK(!verifier->batchVerifyProofs(fakeCertificates(true), consensusNodes,
+        std::make_shared<ThreadPool>("verifier", 2), weights));
+    BOOST_CHECK(keyFactory->verifiedCount() < verifiedCount + 16);
+}
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
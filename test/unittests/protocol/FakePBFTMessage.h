@@ -20,6 +20,7 @@
  */
 #pragma once
 #include "bcos-pbft/core/Proposal.h"
+#include "bcos-pbft/pbft/engine/PublicKeyCache.h"
 #include "bcos-pbft/pbft/protocol/PB/PBFTCodec.h"
 #include "bcos-pbft/pbft/protocol/PB/PBFTMessage.h"
 #include "bcos-pbft/pbft/protocol/PB/PBFTMessageFactoryImpl.h"
@@ -27,6 +28,8 @@
 #include "bcos-pbft/pbft/protocol/PB/PBFTProposal.h"
 #include "bcos-pbft/pbft/protocol/PB/PBFTViewChangeMsg.h"
 #include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <thread>
 
 using namespace bcos::consensus;
 using namespace bcos::crypto;
@@ -391,10 +394,18 @@ inline void testPBFTMessage(PacketType _packetType, CryptoSuite::Ptr _cryptoSuit
     checkFakedBasePBFTMessage(decodedMsg, orgTimestamp, version, view, generatedFrom, proposalHash);
     // verify the signature
     BOOST_CHECK(decodedMsg->verifySignature(_cryptoSuite, keyPair->publicKey()) == true);
+    // verify the signature with the parsed public key
+    auto keyCache = std::make_shared<PublicKeyCache>(
+        std::make_shared<DefaultParsedPublicKeyFactory>(_cryptoSuite->signatureImpl()));
+    keyCache->update(NodeIDs{keyPair->publicKey()});
+    BOOST_CHECK(keyCache->size() == 1);
+    auto parsedKey = keyCache->parsedKey(keyPair->publicKey());
+    BOOST_CHECK(decodedMsg->verifySignature(parsedKey) == true);
     // the signatureHash has been updated
     auto fakedHash = _cryptoSuite->hashImpl()->hash("fakedHash");
     decodedMsg->setSignatureDataHash(fakedHash);
     BOOST_CHECK(decodedMsg->verifySignature(_cryptoSuite, keyPair->publicKey()) == false);
+    BOOST_CHECK(decodedMsg->verifySignature(parsedKey) == false);
 }
 
 inline void testPBFTViewChangeMessage(CryptoSuite::Ptr _cryptoSuite)
@@ -523,6 +534,94 @@ inline void testPBFTNewViewMessage(CryptoSuite::Ptr _cryptoSuite)
     auto fakedHash = _cryptoSuite->hashImpl()->hash("fakedHash");
     decodedMsg->setSignatureDataHash(fakedHash);
     BOOST_CHECK(decodedMsg->verifySignature(_cryptoSuite, keyPair->publicKey()) == false);
+
+    // the viewChanges carrying the same certificates
+    std::vector<std::pair<int64_t, KeyPairInterface::Ptr>> nodeKeyPairList;
+    for (int64_t i = 0; i < 4; i++)
+    {
+        nodeKeyPairList.push_back(
+            std::make_pair(i, _cryptoSuite->signatureImpl()->generateKeyPair()));
+    }
+    auto preparedProposals =
+        fakeProposals(_cryptoSuite, faker, nodeKeyPairList, index, data, proposalSize);
+    auto committedHash = _cryptoSuite->hash(std::to_string(orgCommittedIndex));
+    auto committedProposal = fakeSingleProposal(
+        _cryptoSuite, faker, {}, orgCommittedIndex, committedHash, bytes());
+    ViewChangeMsgList sharedViewChangeList;
+    for (int64_t i = 0; i < viewChangeSize; i++)
+    {
+        sharedViewChangeList.push_back(faker->fakePBFTViewChangeMsg(orgTimestamp, version, orgView,
+            orgGeneratedFrom + i, proposalHash, committedProposal, preparedProposals));
+    }
+    // the NewView message encoded with the certificate table
+    auto sharedNewViewMsg = std::make_shared<PBFTNewViewMsg>();
+    sharedNewViewMsg->setVersion(c_newViewCertificateTableVersion);
+    sharedNewViewMsg->setViewChangeMsgList(sharedViewChangeList);
+    // the proposals shared with the viewChanges are only read by the encoding
+    std::atomic_bool encoding = {true};
+    std::atomic<size_t> inconsistentReads = {0};
+    std::thread reader([&]() {
+        while (encoding)
+        {
+            for (auto const& proposal : preparedProposals)
+            {
+                auto pbftProposal = std::dynamic_pointer_cast<PBFTProposal>(proposal);
+                if (pbftProposal->signatureProofSize() != nodeKeyPairList.size() ||
+                    pbftProposal->pbftRawProposal()->certificateref() != 0)
+                {
+                    inconsistentReads++;
+                }
+            }
+        }
+    });
+    bytesPointer sharedEncodedData;
+    for (size_t i = 0; i < 100; i++)
+    {
+        sharedEncodedData = sharedNewViewMsg->encode(nullptr, nullptr);
+    }
+    encoding = false;
+    reader.join();
+    BOOST_CHECK(inconsistentReads == 0);
+
+    // the NewView message of the lower version inlines the proofs
+    auto legacyNewViewMsg = std::make_shared<PBFTNewViewMsg>();
+    legacyNewViewMsg->setVersion(0);
+    legacyNewViewMsg->setViewChangeMsgList(sharedViewChangeList);
+    auto legacyEncodedData = legacyNewViewMsg->encode(nullptr, nullptr);
+    BOOST_CHECK(sharedEncodedData->size() < legacyEncodedData->size());
+
+    auto decodedSharedNewViewMsg = std::make_shared<PBFTNewViewMsg>(ref(*sharedEncodedData));
+    auto decodedLegacyNewViewMsg = std::make_shared<PBFTNewViewMsg>(ref(*legacyEncodedData));
+    // the decoded certificates are inlined again when encoded for the lower version
+    decodedSharedNewViewMsg->setVersion(0);
+    auto reEncodedData = decodedSharedNewViewMsg->encode(nullptr, nullptr);
+    BOOST_CHECK(*reEncodedData == *legacyEncodedData);
+    decodedSharedNewViewMsg->setVersion(c_newViewCertificateTableVersion);
+    BOOST_CHECK(*(decodedSharedNewViewMsg->encode(nullptr, nullptr)) == *sharedEncodedData);
+
+    for (auto const& decodedNewViewMsg : {decodedSharedNewViewMsg, decodedLegacyNewViewMsg})
+    {
+        BOOST_CHECK(
+            (int64_t)decodedNewViewMsg->viewChangeMsgList().size() == viewChangeSize);
+        for (int64_t i = 0; i < viewChangeSize; i++)
+        {
+            auto const& orgPreparedMsgs = sharedViewChangeList[i]->preparedProposals();
+            auto const& decodedPreparedMsgs =
+                decodedNewViewMsg->viewChangeMsgList()[i]->preparedProposals();
+            BOOST_CHECK(decodedPreparedMsgs.size() == proposalSize);
+            for (size_t j = 0; j < proposalSize; j++)
+            {
+                auto proposal = std::dynamic_pointer_cast<PBFTProposal>(preparedProposals[j]);
+                BOOST_CHECK(*std::dynamic_pointer_cast<PBFTProposal>(
+                                orgPreparedMsgs[j]->consensusProposal()) == *proposal);
+                auto decodedProposal = std::dynamic_pointer_cast<PBFTProposal>(
+                    decodedPreparedMsgs[j]->consensusProposal());
+                BOOST_CHECK(*decodedProposal == *proposal);
+                BOOST_CHECK(decodedProposal->sharedCertificate() ==
+                            (decodedNewViewMsg == decodedSharedNewViewMsg));
+            }
+        }
+    }
 }
 
 inline void testPBFTRequest(CryptoSuite::Ptr _cryptoSuite, PacketType _packetType)
@@ -566,6 +665,21 @@ inline void testPBFTRequest(CryptoSuite::Ptr _cryptoSuite, PacketType _packetTyp
     checkFakedBasePBFTMessage(decodedMsg, timeStamp, version, view, generatedFrom, proposalHash);
     BOOST_CHECK(decodedMsg->index() == startIndex);
     BOOST_CHECK(decodedMsg->size() == size);
+
+    // the batch request
+    ProposalKeyList proposalKeys;
+    for (int64_t i = 0; i < 3; i++)
+    {
+        proposalKeys.emplace_back(
+            startIndex + i, _cryptoSuite->hashImpl()->hash(std::to_string(startIndex + i)));
+    }
+    auto batchRequest = pbftMessageFactory->populateFrom(_packetType, proposalKeys);
+    encodedData = pbftCodec->encode(batchRequest, 1);
+    auto decodedBatchRequest =
+        std::dynamic_pointer_cast<PBFTRequestInterface>(pbftCodec->decode(ref(*encodedData)));
+    BOOST_CHECK(decodedBatchRequest->proposalKeys() == proposalKeys);
+    BOOST_CHECK(decodedBatchRequest->index() == startIndex);
+    BOOST_CHECK(decodedBatchRequest->hash() == proposalKeys[0].second);
 }
 }  // namespace test
 }  // namespace bcos
\ No newline at end of file